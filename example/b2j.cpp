@@ -111,9 +111,9 @@ int main(int argc, char *argv[]) {
 #endif
 
   cxxopts::Options parser("b2j");
-  parser.add_options()                                    //
-      ("i", "input directory", cxxopts::value<string>())  //
-      ("o", "output directory", cxxopts::value<string>()) //
+  parser.add_options()                                                    //
+      ("i", "input directory or .mcworld file", cxxopts::value<string>()) //
+      ("o", "output directory", cxxopts::value<string>())                 //
       ("n", "num threads", cxxopts::value<unsigned int>()->default_value(to_string(thread::hardware_concurrency())));
   cxxopts::ParseResult result;
   try {
@@ -126,8 +126,8 @@ int main(int argc, char *argv[]) {
 
   string inputString = result["i"].as<string>();
   fs::path input(inputString);
-  if (!fs::is_directory(input)) {
-    cerr << "error: input directory does not exist" << endl;
+  if (!fs::is_directory(input) && !fs::is_regular_file(input)) {
+    cerr << "error: input does not exist" << endl;
     return -1;
   }
 
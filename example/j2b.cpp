@@ -139,9 +139,10 @@ int main(int argc, char *argv[]) {
   cxxopts::Options parser("j2b");
   parser.add_options()                                                                                               //
       ("i", "input directory", cxxopts::value<string>())                                                             //
-      ("o", "output directory", cxxopts::value<string>())                                                            //
+      ("o", "output directory or .mcworld file", cxxopts::value<string>())                                           //
       ("n", "num threads", cxxopts::value<unsigned int>()->default_value(to_string(thread::hardware_concurrency()))) //
-      ("s", "directory structure", cxxopts::value<string>()->default_value("vanilla"));
+      ("s", "directory structure", cxxopts::value<string>()->default_value("vanilla"))                               //
+      ("b", "db block size in bytes, 0 for a block per record", cxxopts::value<size_t>()->default_value("0"));
   cxxopts::ParseResult result;
   try {
     result = parser.parse(argc, argv);
@@ -186,6 +187,7 @@ int main(int argc, char *argv[]) {
 
   Options options;
   options.fLevelDirectoryStructure = structure;
+  options.fDbBlockSize = result["b"].as<size_t>();
   options.fTempDirectory = mcfile::File::CreateTempDir(fs::temp_directory_path());
   options.fDbTempDirectory = mcfile::File::CreateTempDir(fs::temp_directory_path());
   defer {
@@ -206,7 +208,12 @@ int main(int argc, char *argv[]) {
   }
 #endif
   unique_ptr<StdoutProgressReporter> progress(new StdoutProgressReporter);
-  auto st = Converter::Run(input, output, options, concurrency, progress.get());
+  Status st;
+  if (output.extension() == ".mcworld") {
+    st = Converter::RunToMcworld(input, output, options, concurrency, progress.get());
+  } else {
+    st = Converter::Run(input, output, options, concurrency, progress.get());
+  }
   if (auto err = st.error(); err) {
     cerr << "what: " << err->fWhat << endl;
     cerr << "trace: " << endl;
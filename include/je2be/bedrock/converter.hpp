@@ -12,6 +12,7 @@ class Converter {
   Converter() = delete;
 
 public:
+  // `input` is either a world directory, or a .mcworld file which is read without being extracted.
   static Status Run(std::filesystem::path const &input, std::filesystem::path const &output, Options const &o, unsigned concurrency, Progress *progress = nullptr);
 };
 
@@ -14,6 +14,12 @@ class Converter {
 
 public:
   static Status Run(std::filesystem::path const &input, std::filesystem::path const &output, Options const &o, int concurrency, Progress *progress = nullptr);
+
+  // Same as Run, but writes the converted world into a .mcworld file `output` instead of a world directory. Files are added to the
+  // archive as soon as they are finished, without being written to the disk first. LevelDB tables are stored without compression,
+  // as their contents are already compressed. If Options::fDbTempDirectory is not set, the intermediate files of the db are placed
+  // in Options::getTempDirectory().
+  static Status RunToMcworld(std::filesystem::path const &input, std::filesystem::path const &output, Options const &o, int concurrency, Progress *progress = nullptr);
 };
 
 } // namespace je2be::java
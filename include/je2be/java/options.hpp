@@ -12,6 +12,8 @@ public:
   std::unordered_set<Pos2i, Pos2iHasher> fChunkFilter;
   std::optional<std::filesystem::path> fTempDirectory;
   std::optional<std::filesystem::path> fDbTempDirectory;
+  // Size of the data blocks in the output db. 0 puts each record in its own block
+  size_t fDbBlockSize = 0;
 
   std::filesystem::path getWorldDirectory(std::filesystem::path const &root, mcfile::Dimension dim) const {
     using namespace mcfile;
@@ -4,14 +4,19 @@
 #include <je2be/status.hpp>
 
 #include <map>
+#include <span>
+#include <vector>
 
 namespace je2be::lce {
 
+class SavegameFiles;
+
 class Behavior {
 public:
   virtual ~Behavior() {}
-  virtual Status decompressChunk(std::vector<uint8_t> &buffer) const = 0;
-  virtual Status loadPlayers(std::filesystem::path const &inputDirectory, std::map<std::filesystem::path, CompoundTagPtr> &outBuffer) const = 0;
+  // Decompresses `buffer` into `out`. `out` may hold data from a previous call, its content is replaced.
+  virtual Status decompressChunk(std::span<uint8_t const> buffer, std::vector<uint8_t> &out) const = 0;
+  virtual Status loadPlayers(SavegameFiles const &files, std::map<std::filesystem::path, CompoundTagPtr> &outBuffer) const = 0;
 };
 
 } // namespace je2be::lce
@@ -35,7 +35,18 @@ public:
       std::filesystem::path const &outputZipFile,
       std::function<bool(int done, int total)> progress = [](int, int) { return true; });
 
+  // Same as the Zip above, but compresses files on `concurrency` threads. Large files are split into blocks which are compressed
+  // independently. Entries are written in the same order as the one above. LevelDB table files (*.ldb) are already compressed,
+  // so they are stored without compression.
+  static ZipResult Zip(
+      std::filesystem::path const &inputDirectory,
+      std::filesystem::path const &outputZipFile,
+      unsigned int concurrency,
+      std::function<bool(int done, int total)> progress = [](int, int) { return true; });
+
 private:
+  class Impl;
+
   void *fHandle;
   void *fStream;
   bool fZip64Used = false;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <je2be/fs.hpp>
+#include <je2be/status.hpp>
+#include <je2be/zip-file.hpp>
+
+#include <minecraft-file.hpp>
+
+#include <mutex>
+#include <string_view>
+
+namespace je2be {
+
+// Destination of the files making up a converted world.
+class FileSink {
+public:
+  virtual ~FileSink() {}
+
+  // Writes a whole file. `name` is a path relative to the root of the world. Files which are already compressed, such as leveldb
+  // tables, should be written with `compress` = false. Can be called from multiple threads.
+  virtual Status write(std::filesystem::path const &name, std::string_view contents, bool compress) = 0;
+};
+
+// Writes files into a directory
+class DirectoryFileSink : public FileSink {
+public:
+  explicit DirectoryFileSink(std::filesystem::path const &root) : fRoot(root) {}
+
+  Status write(std::filesystem::path const &name, std::string_view contents, bool) override {
+    std::filesystem::path path = fRoot / name;
+    std::filesystem::path parent = path.parent_path();
+    // Files of the same directory may be written from multiple threads. create_directories reports that nothing was created when
+    // another thread has just made the directory, so check whether it exists instead of trusting the result
+    std::error_code ec;
+    std::filesystem::create_directories(parent, ec);
+    if (ec && !std::filesystem::is_directory(parent, ec)) {
+      return JE2BE_ERROR;
+    }
+    mcfile::ScopedFile fp(mcfile::File::Open(path, mcfile::File::Mode::Write));
+    if (!fp) {
+      return JE2BE_ERROR_ERRNO;
+    }
+    if (!contents.empty() && !mcfile::File::Fwrite(contents.data(), contents.size(), 1, fp.get())) {
+      return JE2BE_ERROR_ERRNO;
+    }
+    return Status::Ok();
+  }
+
+private:
+  std::filesystem::path const fRoot;
+};
+
+// Writes files as entries of a zip archive, in the order they are written
+class ZipFileSink : public FileSink {
+public:
+  explicit ZipFileSink(std::filesystem::path const &zipFilePath) : fFile(zipFilePath) {}
+
+  Status write(std::filesystem::path const &name, std::string_view contents, bool compress) override {
+    mcfile::stream::ByteInputStream stream(const_cast<char *>(contents.data()), contents.size());
+    std::lock_guard<std::mutex> lock(fMut);
+    if (auto st = fFile.store(stream, name.string(), compress ? 9 : 0); !st.fStatus.ok()) {
+      return JE2BE_ERROR_PUSH(st.fStatus);
+    }
+    return Status::Ok();
+  }
+
+  Status close() {
+    std::lock_guard<std::mutex> lock(fMut);
+    if (auto st = fFile.close(); !st.fStatus.ok()) {
+      return JE2BE_ERROR_PUSH(st.fStatus);
+    }
+    return Status::Ok();
+  }
+
+private:
+  std::mutex fMut;
+  ZipFile fFile;
+};
+
+} // namespace je2be
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <je2be/integers.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace je2be {
+
+// Read-only view of a whole file. The file is memory mapped when the platform supports it, otherwise its content is read into memory.
+class MappedFile {
+  class Impl;
+
+public:
+  static std::unique_ptr<MappedFile> Open(std::filesystem::path const &path);
+  ~MappedFile();
+
+  std::span<u8 const> data() const;
+
+private:
+  explicit MappedFile(std::unique_ptr<Impl> &&impl);
+
+private:
+  std::unique_ptr<Impl> fImpl;
+};
+
+} // namespace je2be
@@ -112,27 +112,20 @@ public:
     }
     std::latch *latchPtr = latch.get();
 
-    vector<shared_ptr<atomic_bool>> done;
-    for (int i = 0; i < works.size(); i++) {
-      done.push_back(make_shared<atomic_bool>(false));
-    }
-    shared_ptr<atomic_bool> *donePtr = done.data();
+    // Index of the next work to be taken
+    atomic<size_t> next = 0;
 
     mutex joinMut;
     Result total = zero();
     atomic_bool cancel = false;
     Status status;
 
-    auto action = [latchPtr, zero, donePtr, &joinMut, &works, &func, join, &total, &cancel, &status]() {
+    auto action = [latchPtr, zero, &next, &joinMut, &works, &func, join, &total, &cancel, &status]() {
       Result sum = zero();
       while (!cancel) {
         Work const *work = nullptr;
-        for (int j = 0; j < works.size(); j++) {
-          bool expected = false;
-          if (donePtr[j]->compare_exchange_strong(expected, true)) {
-            work = &works[j];
-            break;
-          }
+        if (size_t j = next.fetch_add(1); j < works.size()) {
+          work = &works[j];
         }
         if (work) {
           auto [result, st] = func(*work);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <je2be/integers.hpp>
+
+#include <minecraft-file.hpp>
+
+#include <span>
+
+namespace je2be {
+
+// InputStream over a borrowed byte range. The range must outlive the stream.
+class SpanInputStream : public mcfile::stream::InputStream {
+public:
+  explicit SpanInputStream(std::span<u8 const> data) : fData(data), fLoc(0) {}
+
+  size_t read(void *buffer, size_t size) override {
+    if (fLoc >= fData.size()) {
+      return 0;
+    }
+    size_t n = (std::min)(size, fData.size() - fLoc);
+    std::copy_n(fData.data() + fLoc, n, (u8 *)buffer);
+    fLoc += n;
+    return n;
+  }
+
+  bool seek(u64 offset) override {
+    if (offset > fData.size()) {
+      return false;
+    }
+    fLoc = offset;
+    return true;
+  }
+
+  bool valid() const override {
+    return true;
+  }
+
+  u64 pos() const override {
+    return fLoc;
+  }
+
+  std::span<u8 const> data() const {
+    return fData;
+  }
+
+private:
+  std::span<u8 const> const fData;
+  u64 fLoc;
+};
+
+} // namespace je2be
@@ -3,8 +3,10 @@
 #if !defined(EMSCRIPTEN)
 #include "db/_async-iterator.hpp"
 #endif
+#include "_parallel.hpp"
 #include "_props.hpp"
 #include "db/_readonly-db.hpp"
+#include "item/_map-color-cache.hpp"
 #include "structure/_structure-piece.hpp"
 
 namespace je2be::bedrock {
@@ -143,6 +145,7 @@ class Context::Impl {
 
 public:
   static Status Init(std::filesystem::path const &dbname,
+                     std::shared_ptr<ZipEnv> const &archive,
                      Options opt,
                      mcfile::Encoding encoding,
                      std::map<mcfile::Dimension, std::vector<std::pair<Pos2i, ChunksInRegion>>> &regions,
@@ -158,7 +161,7 @@ public:
 
     DB *dbPtr = nullptr;
     unique_ptr<ReadonlyDb::Closer> closer;
-    if (auto st = ReadonlyDb::Open(dbname, &dbPtr, opt.getTempDirectory(), closer); !st.ok()) {
+    if (auto st = ReadonlyDb::Open(dbname, &dbPtr, opt.getTempDirectory(), closer, archive); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
     unique_ptr<DB> db;
@@ -274,6 +277,7 @@ public:
 };
 
 Status Context::Init(std::filesystem::path const &dbname,
+                     std::shared_ptr<ZipEnv> const &archive,
                      Options opt,
                      mcfile::Encoding encoding,
                      std::map<mcfile::Dimension, std::vector<std::pair<Pos2i, ChunksInRegion>>> &regions,
@@ -282,7 +286,7 @@ Status Context::Init(std::filesystem::path const &dbname,
                      GameMode gameMode,
                      unsigned int concurrency,
                      std::unique_ptr<Context> &out) {
-  return Impl::Init(dbname, opt, encoding, regions, totalChunks, gameTick, gameMode, concurrency, out);
+  return Impl::Init(dbname, archive, opt, encoding, regions, totalChunks, gameTick, gameMode, concurrency, out);
 }
 
 void Context::markMapUuidAsUsed(i64 uuid) {
@@ -315,8 +319,8 @@ void Context::mergeInto(Context &other) const {
   }
 }
 
-Status Context::postProcess(std::filesystem::path root, mcfile::be::DbInterface &db) const {
-  if (auto st = exportMaps(root, db); !st.ok()) {
+Status Context::postProcess(std::filesystem::path root, mcfile::be::DbInterface &db, unsigned int concurrency) const {
+  if (auto st = exportMaps(root, db, concurrency); !st.ok()) {
     return JE2BE_ERROR_PUSH(st);
   }
   if (auto st = exportPoi(root); !st.ok()) {
@@ -433,74 +437,76 @@ void Context::addToPoiIfItIs(mcfile::Dimension dim, Pos3i const &pos, mcfile::je
   }
 }
 
-Status Context::exportMaps(std::filesystem::path const &root, mcfile::be::DbInterface &db) const {
+Status Context::exportMaps(std::filesystem::path const &root, mcfile::be::DbInterface &db, unsigned int concurrency) const {
+  using namespace std;
   using namespace mcfile;
 
   if (!Fs::CreateDirectories(root / "data")) {
     return JE2BE_ERROR;
   }
 
-  std::optional<int> maxMapNumber;
-
-  for (i64 uuid : fUsedMapUuids) {
-    auto map = fMapInfo->mapFromUuid(uuid);
-    if (!map) {
-      continue;
-    }
-    int number = map->fNumber;
-    auto key = mcfile::be::DbKey::Map(uuid);
-    auto str = db.get(key);
-    if (!str) {
-      continue;
-    }
-    auto dataB = CompoundTag::Read(*str, fEncoding);
-    if (!dataB) {
-      continue;
-    }
-    auto dataJ = Compound();
-    auto dimensionB = dataB->byte(u8"dimension", 0);
-    Dimension dim = Dimension::Overworld;
-    if (auto dimension = DimensionFromBedrockDimension(dimensionB); dimension) {
-      dim = *dimension;
-    }
-    dataJ->set(u8"dimension", JavaStringFromDimension(dim));
-    CopyBoolValues(*dataB, *dataJ, {{u8"mapLocked", u8"locked"}});
-    CopyByteValues(*dataB, *dataJ, {{u8"scale"}, {u8"unlimitedTracking"}});
-    CopyIntValues(*dataB, *dataJ, {{u8"xCenter"}, {u8"zCenter"}});
-    auto colorsTagB = dataB->byteArrayTag(u8"colors");
-    if (!colorsTagB) {
-      continue;
-    }
-    auto const &colorsB = colorsTagB->value();
-    if (colorsB.size() != 65536) {
-      continue;
-    }
-    std::vector<u8> colorsJ(16384);
-    for (int i = 0; i < colorsJ.size(); i++) {
-      u8 r = colorsB[i * 4];
-      u8 g = colorsB[i * 4 + 1];
-      u8 b = colorsB[i * 4 + 2];
-      u8 a = colorsB[i * 4 + 3];
-      Rgba rgb(r, g, b, a);
-      u8 id = MapColor::MostSimilarColorId(rgb);
-      colorsJ[i] = id;
-    }
-    dataJ->set(u8"colors", std::make_shared<ByteArrayTag>(colorsJ));
-    auto tagJ = Compound();
-    tagJ->set(u8"data", dataJ);
-    tagJ->set(u8"DataVersion", Int(kJavaDataVersion));
-
-    auto path = root / "data" / ("map_" + std::to_string(number) + ".dat");
-    auto s = std::make_shared<mcfile::stream::GzFileOutputStream>(path);
-    if (!CompoundTag::Write(*tagJ, s, mcfile::Encoding::Java)) {
-      return JE2BE_ERROR;
-    }
-    if (maxMapNumber) {
-      maxMapNumber = (std::max)(*maxMapNumber, number);
-    } else {
-      maxMapNumber = number;
-    }
+  vector<i64> uuids(fUsedMapUuids.begin(), fUsedMapUuids.end());
+  MapColorCache colorCache(MapColorCache::kDefaultCapacity);
+
+  auto [maxMapNumber, st] = Parallel::Reduce<i64, optional<int>>(
+      uuids,
+      concurrency,
+      optional<int>(),
+      [this, &root, &db, &colorCache](i64 const &uuid) -> pair<optional<int>, Status> {
+        auto map = fMapInfo->mapFromUuid(uuid);
+        if (!map) {
+          return make_pair(nullopt, Status::Ok());
+        }
+        int number = map->fNumber;
+        auto key = mcfile::be::DbKey::Map(uuid);
+        auto str = db.get(key);
+        if (!str) {
+          return make_pair(nullopt, Status::Ok());
+        }
+        auto dataB = CompoundTag::Read(*str, fEncoding);
+        if (!dataB) {
+          return make_pair(nullopt, Status::Ok());
+        }
+        auto dataJ = Compound();
+        auto dimensionB = dataB->byte(u8"dimension", 0);
+        Dimension dim = Dimension::Overworld;
+        if (auto dimension = DimensionFromBedrockDimension(dimensionB); dimension) {
+          dim = *dimension;
+        }
+        dataJ->set(u8"dimension", JavaStringFromDimension(dim));
+        CopyBoolValues(*dataB, *dataJ, {{u8"mapLocked", u8"locked"}});
+        CopyByteValues(*dataB, *dataJ, {{u8"scale"}, {u8"unlimitedTracking"}});
+        CopyIntValues(*dataB, *dataJ, {{u8"xCenter"}, {u8"zCenter"}});
+        auto colorsTagB = dataB->byteArrayTag(u8"colors");
+        if (!colorsTagB) {
+          return make_pair(nullopt, Status::Ok());
+        }
+        auto const &colorsB = colorsTagB->value();
+        if (colorsB.size() != 65536) {
+          return make_pair(nullopt, Status::Ok());
+        }
+        auto colorsJ = colorCache.idsFromRgba(colorsB);
+        dataJ->set(u8"colors", make_shared<ByteArrayTag>(*colorsJ));
+        auto tagJ = Compound();
+        tagJ->set(u8"data", dataJ);
+        tagJ->set(u8"DataVersion", Int(kJavaDataVersion));
+
+        auto path = root / "data" / ("map_" + to_string(number) + ".dat");
+        auto s = make_shared<mcfile::stream::GzFileOutputStream>(path);
+        if (!CompoundTag::Write(*tagJ, s, mcfile::Encoding::Java)) {
+          return make_pair(nullopt, JE2BE_ERROR);
+        }
+        return make_pair(number, Status::Ok());
+      },
+      [](optional<int> const &from, optional<int> &to) {
+        if (from && (!to || *to < *from)) {
+          to = from;
+        }
+      });
+  if (!st.ok()) {
+    return JE2BE_ERROR_PUSH(st);
   }
+
   if (maxMapNumber) {
     auto idcounts = Compound();
     auto d = Compound();
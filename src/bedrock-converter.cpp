@@ -16,6 +16,7 @@
 #include "terraform/java/_block-accessor-java-directory.hpp"
 #include "terraform/lighting/_lighting.hpp"
 
+#include <defer.hpp>
 #include <sparse.hpp>
 
 #include <atomic>
@@ -39,8 +40,37 @@ public:
       return JE2BE_ERROR;
     }
 
+    // A .mcworld (or .zip) file is read in place, without being extracted
+    fs::path world = input;
+    shared_ptr<ZipEnv> archive;
+    optional<fs::path> mountPoint;
+    defer {
+      if (mountPoint) {
+        Fs::DeleteAll(*mountPoint);
+      }
+    };
+    if (error_code ec; fs::is_regular_file(input, ec)) {
+      mountPoint = File::CreateTempDir(options.getTempDirectory());
+      if (!mountPoint) {
+        return JE2BE_ERROR;
+      }
+      archive = make_shared<ZipEnv>(input, *mountPoint);
+      if (!archive->Valid()) {
+        return JE2BE_ERROR;
+      }
+      world = *mountPoint;
+    }
+
     CompoundTagPtr dat;
-    if (!LevelData::Read(input / "level.dat", dat)) {
+    if (archive) {
+      auto contents = archive->contents(world / "level.dat");
+      if (!contents) {
+        return JE2BE_ERROR;
+      }
+      if (!LevelData::Read(make_shared<mcfile::stream::ByteInputStream>(*contents), dat)) {
+        return JE2BE_ERROR;
+      }
+    } else if (!LevelData::Read(world / "level.dat", dat)) {
       return JE2BE_ERROR;
     }
     if (!dat) {
@@ -56,12 +86,12 @@ public:
       gameMode = *t;
     }
     unique_ptr<Context> bin;
-    if (auto st = Context::Init(input / "db", options, mcfile::Encoding::LittleEndian, regions, total, gameTick, gameMode, concurrency, bin); !st.ok()) {
+    if (auto st = Context::Init(world / "db", archive, options, mcfile::Encoding::LittleEndian, regions, total, gameTick, gameMode, concurrency, bin); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
 
     unique_ptr<ReadonlyDb> db;
-    if (auto st = ReadonlyDb::Open(input / "db", options.getTempDirectory(), db); !st.ok()) {
+    if (auto st = ReadonlyDb::Open(world / "db", options.getTempDirectory(), db, archive); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
     if (!db) {
@@ -167,7 +197,7 @@ public:
       return JE2BE_ERROR;
     }
 
-    return bin->postProcess(output, *db);
+    return bin->postProcess(output, *db, concurrency);
   }
 
 private:
@@ -218,6 +248,14 @@ private:
       }
     }
 
+    // Neighbor chunks in other regions, shared by the workers
+    auto chunkCache = make_shared<terraform::java::ChunkCache>(1, kTerraformChunkCacheCapacity);
+    for (auto const &i : regions) {
+      for (auto const &j : i.second) {
+        chunkCache->retain(i.first, j.first);
+      }
+    }
+
     int numThreads = (int)concurrency - 1;
     unique_ptr<std::latch> latch;
     if (concurrency > 0) {
@@ -228,7 +266,7 @@ private:
     mutex mut;
     atomic_uint64_t done(0);
 
-    auto action = [latchPtr, &queues, &mut, output, &ok, terrainTempDirs, regions, &done, progress, numChunks]() {
+    auto action = [latchPtr, &queues, &mut, output, &ok, terrainTempDirs, regions, &done, progress, numChunks, chunkCache]() {
       shared_ptr<terraform::java::BlockAccessorJavaDirectory<3, 3>> blockAccessor;
       optional<mcfile::Dimension> prevDimension;
 
@@ -318,7 +356,7 @@ private:
             int cx = x + rx * 32;
             int cz = z + rz * 32;
             if (chunksInRegion.fChunks.find(Pos2i(cx, cz)) != chunksInRegion.fChunks.end()) {
-              if (!TerraformChunk(cx, cz, *editor, found->second, blockAccessor, dim, lightCache).ok()) {
+              if (!TerraformChunk(cx, cz, *editor, found->second, blockAccessor, dim, chunkCache, lightCache).ok()) {
                 ok = false;
                 break;
               }
@@ -339,6 +377,8 @@ private:
           ok = false;
         }
 
+        chunkCache->release(dim, region);
+
         {
           lock_guard<mutex> lock(mut);
           queue->unlock({region});
@@ -373,6 +413,7 @@ private:
       fs::path inputDirectory,
       std::shared_ptr<terraform::java::BlockAccessorJavaDirectory<3, 3>> &blockAccessor,
       mcfile::Dimension dim,
+      std::shared_ptr<terraform::java::ChunkCache> const &chunkCache,
       terraform::lighting::LightCache &lightCache) {
     int rx = mcfile::Coordinate::RegionFromChunk(cx);
     int rz = mcfile::Coordinate::RegionFromChunk(cz);
@@ -386,7 +427,7 @@ private:
     }
 
     if (!blockAccessor) {
-      blockAccessor.reset(new terraform::java::BlockAccessorJavaDirectory<3, 3>(cx - 1, cz - 1, inputDirectory));
+      blockAccessor.reset(new terraform::java::BlockAccessorJavaDirectory<3, 3>(cx - 1, cz - 1, inputDirectory, dim, chunkCache));
     }
     if (blockAccessor->fChunkX != cx - 1 || blockAccessor->fChunkZ != cz - 1) {
       auto next = blockAccessor->makeRelocated(cx - 1, cz - 1);
@@ -407,8 +448,10 @@ private:
     }
 
     terraform::BlockPropertyAccessorJava propertyAccessor(*ch);
-    terraform::Leaves::Do(*writable, *blockAccessor, propertyAccessor);
-    terraform::lighting::Lighting::Do(dim, *writable, *blockAccessor, lightCache);
+    terraform::BlockWindow<mcfile::je::Block> window(cx - 1, cz - 1);
+    blockAccessor->populate(window);
+    terraform::Leaves::Do(*writable, window, propertyAccessor);
+    terraform::lighting::Lighting::Do(dim, *writable, window, lightCache);
 
     auto tag = writable->toCompoundTag(dim);
     if (!tag) {
@@ -442,6 +485,10 @@ private:
     }
     return true;
   }
+
+private:
+  // Upper limit of the number of parsed chunks kept by terraform::java::ChunkCache during Terraform
+  static constexpr size_t kTerraformChunkCacheCapacity = 2048;
 };
 
 Status Converter::Run(std::filesystem::path const &input, std::filesystem::path const &output, Options const &options, unsigned concurrency, Progress *progress) {
@@ -18,6 +18,10 @@
 #include "item/_map-color.hpp"
 #include "structure/_structure-piece.hpp"
 
+namespace je2be {
+class ZipEnv;
+}
+
 namespace je2be::bedrock {
 
 class Context {
@@ -38,6 +42,7 @@ public:
   };
 
   static Status Init(std::filesystem::path const &dbname,
+                     std::shared_ptr<ZipEnv> const &archive,
                      Options opt,
                      mcfile::Encoding encoding,
                      std::map<mcfile::Dimension, std::vector<std::pair<Pos2i, ChunksInRegion>>> &regions,
@@ -49,7 +54,7 @@ public:
 
   void markMapUuidAsUsed(i64 uuid);
   void mergeInto(Context &other) const;
-  Status postProcess(std::filesystem::path root, mcfile::be::DbInterface &db) const;
+  Status postProcess(std::filesystem::path root, mcfile::be::DbInterface &db, unsigned int concurrency) const;
   std::optional<MapInfo::Map> mapFromUuid(i64 mapUuid) const;
   void structures(mcfile::Dimension d, Pos2i chunk, std::vector<StructureInfo::Structure> &buffer);
   std::shared_ptr<Context> make() const;
@@ -68,7 +73,7 @@ public:
   std::optional<std::pair<mcfile::Dimension, Pos3i>> getLodestone(i32 trackingHandle) const;
 
 private:
-  Status exportMaps(std::filesystem::path const &root, mcfile::be::DbInterface &db) const;
+  Status exportMaps(std::filesystem::path const &root, mcfile::be::DbInterface &db, unsigned int concurrency) const;
   Status exportPoi(std::filesystem::path const &root) const;
 
 public:
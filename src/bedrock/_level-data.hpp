@@ -90,9 +90,13 @@ public:
 
 public:
   static bool Read(std::filesystem::path levelDatFile, CompoundTagPtr &result) {
+    auto fis = std::make_shared<mcfile::stream::FileInputStream>(levelDatFile);
+    return Read(fis, result);
+  }
+
+  static bool Read(std::shared_ptr<mcfile::stream::InputStream> const &fis, CompoundTagPtr &result) {
     using namespace std;
     using namespace mcfile::stream;
-    auto fis = make_shared<FileInputStream>(levelDatFile);
     if (!fis->valid()) {
       return false;
     }
@@ -15,25 +15,14 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY() + 1; y <= accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          if (p != terraform::BlockPropertyAccessor::BEACON) {
-            continue;
-          }
-          auto tileEntity = out.fTileEntities[Pos3i(x, y, z)];
-          if (!tileEntity) [[unlikely]] {
-            continue;
-          }
-          int level = BeaconLevel(x, y, z, cache);
-          tileEntity->set(u8"Levels", Int(level));
-        }
+    accessor.forEach(terraform::BlockPropertyAccessor::BEACON, 1, 0, [&](int x, int y, int z) {
+      auto tileEntity = out.fTileEntities[Pos3i(x, y, z)];
+      if (!tileEntity) [[unlikely]] {
+        return;
       }
-    }
+      int level = BeaconLevel(x, y, z, cache);
+      tileEntity->set(u8"Levels", Int(level));
+    });
   }
 
   static int BeaconLevel(int x, int y, int z, terraform::bedrock::BlockAccessorBedrock<3, 3> &cache) {
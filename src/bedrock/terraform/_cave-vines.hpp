@@ -15,25 +15,17 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY() + 1; y <= accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          auto lower = accessor.property(x, y - 1, z);
-          if (p == terraform::BlockPropertyAccessor::CAVE_VINES && lower == terraform::BlockPropertyAccessor::CAVE_VINES) {
-            auto blockJ = out.blockAt(x, y, z);
-            if (!blockJ) {
-              continue;
-            }
-            auto plant = blockJ->withId(mcfile::blocks::minecraft::cave_vines_plant)->applying({{u8"age", nullopt}});
-            out.setBlockAt(x, y, z, plant);
-          }
+    accessor.forEach(terraform::BlockPropertyAccessor::CAVE_VINES, 1, 0, [&](int x, int y, int z) {
+      auto lower = accessor.property(x, y - 1, z);
+      if (lower == terraform::BlockPropertyAccessor::CAVE_VINES) {
+        auto blockJ = out.blockAt(x, y, z);
+        if (!blockJ) {
+          return;
         }
+        auto plant = blockJ->withId(mcfile::blocks::minecraft::cave_vines_plant)->applying({{u8"age", nullopt}});
+        out.setBlockAt(x, y, z, plant);
       }
-    }
+    });
   }
 };
 
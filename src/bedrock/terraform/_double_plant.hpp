@@ -13,32 +13,21 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY() + 1; y <= accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto upperP = accessor.property(x, y, z);
-          if (upperP != terraform::BlockPropertyAccessor::DOUBLE_PLANT_UPPER_SUNFLOWER) {
-            continue;
-          }
-          auto upperB = out.blockAt(x, y, z);
-          auto lowerB = out.blockAt(x, y - 1, z);
-          if (!lowerB || !upperB) {
-            continue;
-          }
-          if (lowerB->fId == upperB->fId) {
-            continue;
-          }
-          if (lowerB->property(u8"half") != u8"lower") {
-            continue;
-          }
-          auto replaceUpper = lowerB->applying({{u8"half", u8"upper"}});
-          out.setBlockAt(x, y, z, replaceUpper);
-        }
+    accessor.forEach(terraform::BlockPropertyAccessor::DOUBLE_PLANT_UPPER_SUNFLOWER, 1, 0, [&](int x, int y, int z) {
+      auto upperB = out.blockAt(x, y, z);
+      auto lowerB = out.blockAt(x, y - 1, z);
+      if (!lowerB || !upperB) {
+        return;
       }
-    }
+      if (lowerB->fId == upperB->fId) {
+        return;
+      }
+      if (lowerB->property(u8"half") != u8"lower") {
+        return;
+      }
+      auto replaceUpper = lowerB->applying({{u8"half", u8"upper"}});
+      out.setBlockAt(x, y, z, replaceUpper);
+    });
   }
 };
 
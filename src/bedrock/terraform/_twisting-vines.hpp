@@ -13,21 +13,13 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY(); y < accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          auto upper = accessor.property(x, y + 1, z);
-          if (p == terraform::BlockPropertyAccessor::TWISTING_VINES && upper == terraform::BlockPropertyAccessor::TWISTING_VINES) {
-            auto plant = mcfile::je::Block::FromId(mcfile::blocks::minecraft::twisting_vines_plant, out.getDataVersion());
-            out.setBlockAt(x, y, z, plant);
-          }
-        }
+    accessor.forEach(terraform::BlockPropertyAccessor::TWISTING_VINES, 0, 1, [&](int x, int y, int z) {
+      auto upper = accessor.property(x, y + 1, z);
+      if (upper == terraform::BlockPropertyAccessor::TWISTING_VINES) {
+        auto plant = mcfile::je::Block::FromId(mcfile::blocks::minecraft::twisting_vines_plant, out.getDataVersion());
+        out.setBlockAt(x, y, z, plant);
       }
-    }
+    });
   }
 };
 
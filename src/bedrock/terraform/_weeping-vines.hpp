@@ -13,21 +13,13 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY() + 1; y <= accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          auto lower = accessor.property(x, y - 1, z);
-          if (p == terraform::BlockPropertyAccessor::WEEPING_VINES && lower == terraform::BlockPropertyAccessor::WEEPING_VINES) {
-            auto plant = mcfile::je::Block::FromId(mcfile::blocks::minecraft::weeping_vines_plant, out.getDataVersion());
-            out.setBlockAt(x, y, z, plant);
-          }
-        }
+    accessor.forEach(terraform::BlockPropertyAccessor::WEEPING_VINES, 1, 0, [&](int x, int y, int z) {
+      auto lower = accessor.property(x, y - 1, z);
+      if (lower == terraform::BlockPropertyAccessor::WEEPING_VINES) {
+        auto plant = mcfile::je::Block::FromId(mcfile::blocks::minecraft::weeping_vines_plant, out.getDataVersion());
+        out.setBlockAt(x, y, z, plant);
       }
-    }
+    });
   }
 };
 
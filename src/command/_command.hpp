@@ -1,7 +1,5 @@
 #pragma once
 
-#include <regex>
-
 #include "command/_target-selector.hpp"
 #include "command/_token.hpp"
 
@@ -64,90 +62,70 @@ private:
       return false;
     }
 
-    u8string command = raw;
+    u8string_view command = raw;
     {
-      u8string prefix;
-      while (true) {
-        if (command.starts_with(u8" ")) {
-          prefix += u8" ";
-          command = command.substr(1);
-        } else if (command.starts_with(u8"/")) {
-          if (!prefix.empty()) {
-            tokens.push_back(make_shared<Whitespace>(prefix));
-          }
-          tokens.push_back(make_shared<Token>(u8"/"));
-          prefix = u8"";
-          command = command.substr(1);
-          break;
-        } else {
-          break;
-        }
+      size_t prefix = 0;
+      while (prefix < command.size() && command[prefix] == u8' ') {
+        prefix++;
+      }
+      if (prefix > 0) {
+        tokens.push_back(make_shared<Whitespace>(u8string(command.substr(0, prefix))));
       }
-      if (!prefix.empty()) {
-        tokens.push_back(make_shared<Whitespace>(prefix));
+      command.remove_prefix(prefix);
+      if (command.starts_with(u8'/')) {
+        tokens.push_back(make_shared<Token>(u8"/"));
+        command.remove_prefix(1);
       }
     }
 
-    u8string suffix;
-    while (true) {
-      if (command.ends_with(u8"\x0d")) {
-        suffix = u8"\x0d" + suffix;
-        command = command.substr(0, command.size() - 1);
-      } else if (command.ends_with(u8" ")) {
-        suffix = u8" " + suffix;
-        command = command.substr(0, command.size() - 1);
-      } else {
-        break;
-      }
+    size_t suffixStart = command.size();
+    while (suffixStart > 0 && (command[suffixStart - 1] == u8'\x0d' || command[suffixStart - 1] == u8' ')) {
+      suffixStart--;
     }
+    u8string_view suffix = command.substr(suffixStart);
+    command = command.substr(0, suffixStart);
 
     shared_ptr<Token> suffixToken;
 
-    u8string replaced;
-    if (!Token::EscapeStringLiteralContents(command, &replaced)) {
+    u8string replacedBuffer;
+    if (!Token::EscapeStringLiteralContents(command, &replacedBuffer)) {
       return false;
     }
+    u8string_view replaced = replacedBuffer;
     auto comment = replaced.find(u8'#');
-    if (comment == string::npos) {
+    if (comment == u8string_view::npos) {
       if (!suffix.empty()) {
-        suffixToken = make_shared<Whitespace>(suffix);
+        suffixToken = make_shared<Whitespace>(u8string(suffix));
       }
     } else {
-      auto commentString = command.substr(comment);
-      suffixToken = make_shared<Comment>(commentString + suffix);
+      u8string commentString(command.substr(comment));
+      commentString += suffix;
+      suffixToken = make_shared<Comment>(commentString);
       command = command.substr(0, comment);
       replaced = replaced.substr(0, comment);
     }
 
-    static regex const sWhitespaceRegex(R"([ ]+)");
-    string sreplaced;
-    sreplaced.assign((char const *)replaced.data(), replaced.size());
-    auto begin = sregex_iterator(sreplaced.begin(), sreplaced.end(), sWhitespaceRegex);
-    auto end = sregex_iterator();
-    ptrdiff_t pos = 0;
-    for (auto it = begin; it != end; it++) {
-      smatch m = *it;
-      auto offset = m.position();
-      auto length = m.length();
-      if (pos < offset) {
-        u8string tokenString = strings::Substring(command, pos, offset);
-        u8string tokenStringReplaced = strings::Substring(replaced, pos, offset);
-        if (!ParseToken(tokenString, tokenStringReplaced, tokens)) {
+    // Split by runs of ' '. String literals never contain ' ' in replaced
+    size_t pos = 0;
+    while (pos < replaced.size()) {
+      size_t space = replaced.find(u8' ', pos);
+      if (space == u8string_view::npos) {
+        space = replaced.size();
+      }
+      if (pos < space) {
+        if (!ParseToken(command.substr(pos, space - pos), replaced.substr(pos, space - pos), tokens)) {
           return false;
         }
       }
-      string match = m.str();
-      u8string u8match;
-      u8match.assign((char8_t const *)match.data(), match.size());
-      tokens.push_back(make_shared<Whitespace>(u8match));
-      pos = offset + length;
-    }
-    if (pos < command.length()) {
-      u8string tokenString = strings::Substring(command, pos);
-      u8string tokenStringReplaced = strings::Substring(replaced, pos);
-      if (!ParseToken(tokenString, tokenStringReplaced, tokens)) {
-        return false;
+      if (space == replaced.size()) {
+        break;
       }
+      size_t next = replaced.find_first_not_of(u8' ', space);
+      if (next == u8string_view::npos) {
+        next = replaced.size();
+      }
+      tokens.push_back(make_shared<Whitespace>(u8string(replaced.substr(space, next - space))));
+      pos = next;
     }
 
     if (suffixToken) {
@@ -156,48 +134,68 @@ private:
     return true;
   }
 
-  static bool ParseToken(std::u8string const &command, std::u8string const &replaced, std::vector<std::shared_ptr<Token>> &tokens) {
+  static bool ParseToken(std::u8string_view command, std::u8string_view replaced, std::vector<std::shared_ptr<Token>> &tokens) {
     using namespace std;
-    static regex const sTargetSelectorRegex(R"(@(p|r|a|e|s|c|v|initiator)(\[[^\]]*\])?)");
-    ptrdiff_t pos = 0;
-    string sreplaced;
-    sreplaced.assign((char const *)replaced.data(), replaced.size());
-    auto begin = sregex_iterator(sreplaced.begin(), sreplaced.end(), sTargetSelectorRegex);
-    auto end = sregex_iterator();
-    for (auto it = begin; it != end; it++) {
-      smatch m = *it;
-      auto offset = m.position();
-      auto length = m.length();
-      if (pos < offset) {
-        u8string str = command.substr(pos, offset - pos);
-        Token::IterateStringLiterals(str, [&tokens](u8string const &s, bool stringLiteral) {
-          if (stringLiteral) {
-            tokens.push_back(make_shared<StringLiteral>(s));
-          } else {
-            tokens.push_back(make_shared<Token>(s));
-          }
-        });
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < replaced.size()) {
+      if (replaced[i] != u8'@') {
+        i++;
+        continue;
+      }
+      size_t length = TargetSelectorLength(replaced.substr(i));
+      if (length == 0) {
+        i++;
+        continue;
       }
-      auto ts = TargetSelector::Parse(command.substr(offset, length));
+      if (pos < i) {
+        PushTokens(command.substr(pos, i - pos), tokens);
+      }
+      auto ts = TargetSelector::Parse(u8string(command.substr(i, length)));
       if (!ts) {
         return false;
       }
       tokens.push_back(ts);
-      pos = offset + length;
+      pos = i + length;
+      i = pos;
     }
     if (pos < command.length()) {
-      u8string str = command.substr(pos);
-      Token::IterateStringLiterals(str, [&tokens](u8string const &s, bool stringLiteral) {
-        if (stringLiteral) {
-          tokens.push_back(make_shared<StringLiteral>(s));
-        } else {
-          tokens.push_back(make_shared<Token>(s));
-        }
-      });
+      PushTokens(command.substr(pos), tokens);
     }
     return true;
   }
 
+  // Length of the target selector at the beginning of s, such as "@e" and "@a[tag=foo]". Returns 0 when s doesn't start with a target
+  // selector. Brackets are matched in the string where contents of string literals are escaped, so ']' in a string literal is skipped
+  static size_t TargetSelectorLength(std::u8string_view s) {
+    using namespace std;
+    size_t length;
+    if (s.substr(1).starts_with(u8"initiator")) {
+      length = 10;
+    } else if (s.size() > 1 && u8string_view(u8"praescv").find(s[1]) != u8string_view::npos) {
+      length = 2;
+    } else {
+      return 0;
+    }
+    if (length < s.size() && s[length] == u8'[') {
+      if (auto close = s.find(u8']', length + 1); close != u8string_view::npos) {
+        length = close + 1;
+      }
+    }
+    return length;
+  }
+
+  static void PushTokens(std::u8string_view str, std::vector<std::shared_ptr<Token>> &tokens) {
+    using namespace std;
+    Token::EachStringLiteral(str, [&tokens](u8string_view s, bool stringLiteral) {
+      if (stringLiteral) {
+        tokens.push_back(make_shared<StringLiteral>(u8string(s)));
+      } else {
+        tokens.push_back(make_shared<Token>(u8string(s)));
+      }
+    });
+  }
+
   Command() = delete;
 };
 
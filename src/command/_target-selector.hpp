@@ -213,7 +213,7 @@ public:
       return nullptr;
     }
     ret->fType = raw.substr(0, openBracket);
-    u8string body = raw.substr(openBracket + 1, raw.length() - openBracket - 2);
+    u8string_view body = u8string_view(raw).substr(openBracket + 1, raw.length() - openBracket - 2);
     u8string replaced;
     if (!EscapeStringLiteralContents(body, &replaced)) {
       return nullptr;
@@ -320,36 +320,33 @@ private:
     return true;
   }
 
-  static std::optional<std::pair<std::u8string, std::u8string>> ParseArgument(std::u8string const &body, std::u8string const &replaced, size_t &pos) {
+  static std::optional<std::pair<std::u8string, std::u8string>> ParseArgument(std::u8string_view body, std::u8string_view replaced, size_t &pos) {
     using namespace std;
 
-    if (body.substr(pos).starts_with(u8"scores=")) {
-      static regex const sScoresRegex(R"((scores=\{[^\}]*\}).*)");
-      smatch m;
-      u8string s = body.substr(pos);
-      string ss;
-      ss.assign((char const *)s.data(), s.size());
-      if (!std::regex_match(ss, m, sScoresRegex)) {
+    u8string_view rest = body.substr(pos);
+    if (rest.starts_with(u8"scores={")) {
+      // scores={...}: the value lasts until the first '}', and the remaining part must not contain line terminators
+      size_t close = rest.find(u8'}');
+      if (close == u8string_view::npos) {
         return nullopt;
       }
-      if (m.size() < 2) {
+      if (rest.find_first_of(u8"\n\r", close) != u8string_view::npos) {
         return nullopt;
       }
-      string kv = m[1].str();
-      string value = kv.substr(7);
-      pos = pos += kv.size() + 1;
-      u8string u8value;
-      u8value.assign((char8_t const *)value.data(), value.size());
-      return make_pair(u8"scores", u8value);
+      u8string_view kv = rest.substr(0, close + 1);
+      pos += kv.size() + 1;
+      return make_pair(u8"scores", u8string(kv.substr(7)));
+    } else if (rest.starts_with(u8"scores=")) {
+      return nullopt;
     } else {
       size_t equal = replaced.find(u8'=', pos);
-      if (equal == string::npos) {
+      if (equal == u8string_view::npos) {
         return nullopt;
       }
-      size_t comma = replaced.find(',', equal);
-      u8string arg = strings::Substring(body, pos, equal);
-      u8string value = strings::Substring(body, equal + 1, comma);
-      if (comma != string::npos) {
+      size_t comma = replaced.find(u8',', equal);
+      u8string arg(body.substr(pos, equal - pos));
+      u8string value(body.substr(equal + 1, comma - equal - 1));
+      if (comma != u8string_view::npos) {
         pos = comma + 1;
       } else {
         pos = comma;
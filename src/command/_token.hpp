@@ -1,7 +1,5 @@
 #pragma once
 
-#include <regex>
-
 namespace je2be::command {
 
 enum class Mode {
@@ -30,54 +28,87 @@ public:
 
   static bool IterateStringLiterals(std::u8string const &s, std::function<void(std::u8string const &str, bool stringLiteral)> callback) {
     using namespace std;
-    static regex const sStringLiteralRegex(R"((\"(\\.|[^"\\])*\"?|'(\\.|[^'\\])*'?))");
+    return EachStringLiteral(s, [&callback](u8string_view str, bool stringLiteral) {
+      callback(u8string(str), stringLiteral);
+    });
+  }
 
-    ptrdiff_t pos = 0;
-    string ns;
-    ns.assign((char const *)s.data(), s.size());
-    auto begin = sregex_iterator(ns.begin(), ns.end(), sStringLiteralRegex);
-    auto end = sregex_iterator();
-    for (auto it = begin; it != end; it++) {
-      smatch m = *it;
-      auto offset = m.position();
-      auto length = m.length();
-      if (pos < offset) {
-        auto pre = s.substr(pos, offset - pos);
-        callback(pre, false);
+  // Splits s into string literals and the other parts in one pass. A string literal is quoted with " or ', can contain escaped
+  // characters, and extends to the end of s when it isn't closed. Returns false for such an unclosed string literal
+  template <class Callback>
+  static bool EachStringLiteral(std::u8string_view s, Callback &&callback) {
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < s.size()) {
+      if (s[i] != u8'"' && s[i] != u8'\'') {
+        i++;
+        continue;
+      }
+      if (pos < i) {
+        callback(s.substr(pos, i - pos), false);
       }
-      auto part = m.str();
-      u8string u8part;
-      u8part.assign((char8_t const *)part.data(), part.size());
-      callback(u8part, true);
-      if (!part.ends_with(part.at(0))) {
+      size_t length = StringLiteralLength(s.substr(i));
+      std::u8string_view part = s.substr(i, length);
+      callback(part, true);
+      if (!part.ends_with(part[0])) {
         // Wasn't enclosed with correct quoatation
         return false;
       }
-      pos = offset + length;
+      pos = i + length;
+      i = pos;
     }
-    if (pos < s.length()) {
+    if (pos < s.size()) {
       callback(s.substr(pos), false);
     }
     return true;
   }
 
   // Replace contents of string literals to special character '\t'
-  static bool EscapeStringLiteralContents(std::u8string const &s, std::u8string *result) {
+  static bool EscapeStringLiteralContents(std::u8string_view s, std::u8string *result) {
     using namespace std;
     if (!result) {
       return false;
     }
     result->clear();
-    return IterateStringLiterals(s, [&result](u8string const &str, bool stringLiteral) {
+    result->reserve(s.size());
+    bool valid = true;
+    bool ok = EachStringLiteral(s, [&result, &valid](u8string_view str, bool stringLiteral) {
       if (stringLiteral) {
-        u8string s = u8"\"";
-        s += u8string(str.length() - 2, u8'\t');
-        s += u8"\"";
-        *result += s;
+        if (str.size() < 2) {
+          // A quotation mark at the end of s
+          valid = false;
+          return;
+        }
+        result->push_back(u8'"');
+        result->append(str.size() - 2, u8'\t');
+        result->push_back(u8'"');
       } else {
-        *result += str;
+        result->append(str);
       }
     });
+    return ok && valid;
+  }
+
+private:
+  // Length of the string literal at the beginning of s. An escape sequence is a backslash followed by a character other than line
+  // terminators
+  static size_t StringLiteralLength(std::u8string_view s) {
+    char8_t const quote = s[0];
+    size_t i = 1;
+    while (i < s.size()) {
+      char8_t ch = s[i];
+      if (ch == u8'\\') {
+        if (i + 1 < s.size() && s[i + 1] != u8'\n' && s[i + 1] != u8'\r') {
+          i += 2;
+          continue;
+        }
+        return i;
+      } else if (ch == quote) {
+        return i + 1;
+      }
+      i++;
+    }
+    return i;
   }
 
 public:
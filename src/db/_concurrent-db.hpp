@@ -3,6 +3,7 @@
 #include <je2be/fs.hpp>
 #include <je2be/strings.hpp>
 
+#include "_file-sink.hpp"
 #include "_parallel.hpp"
 #include "_system.hpp"
 #include "db/_db-interface.hpp"
@@ -10,6 +11,7 @@
 #include <db/log_writer.h>
 #include <db/version_edit.h>
 #include <leveldb/env.h>
+#include <leveldb/write_batch.h>
 #include <table/block_builder.h>
 #include <table/format.h>
 #include <util/crc32c.h>
@@ -18,6 +20,7 @@
 
 #include <execution>
 #include <inttypes.h>
+#include <span>
 
 namespace je2be {
 
@@ -34,7 +37,9 @@ class ConcurrentDb : public DbInterface {
 
   struct Key {
     std::string fKey;
-    u32 fValueSizeCompressed;
+    // Size of the value in value.bin. This is the compressed size unless the records are grouped into blocks later, in which case
+    // value.bin holds the raw value, and the compressed size isn't known until the table is built
+    u32 fValueSize;
     u64 fOffset;
     u64 fSequence;
     u32 fWriterId;
@@ -42,7 +47,7 @@ class ConcurrentDb : public DbInterface {
 
   class Writer {
   public:
-    Writer(u32 id, std::filesystem::path const &directory, std::atomic_uint64_t &sequencer) : fId(id), fSequencer(sequencer), fNumKeys(), fTotalKeySize() {
+    Writer(u32 id, std::filesystem::path const &directory, std::atomic_uint64_t &sequencer, bool compress) : fId(id), fSequencer(sequencer), fCompress(compress), fNumKeys(), fTotalKeySize() {
       namespace fs = std::filesystem;
       fs::path dir = directory / std::to_string(id);
       Fs::DeleteAll(dir);
@@ -75,9 +80,24 @@ class ConcurrentDb : public DbInterface {
 
     ~Writer() {
       abandon();
+      if (fDeflateReady) {
+        deflateEnd(&fDeflate);
+      }
+    }
+
+    struct Record {
+      leveldb::Slice fKey;
+      leveldb::Slice fValue;
+    };
+
+    Status put(std::string const &key, leveldb::Slice const &value) {
+      Record record{key, value};
+      return put(std::span<Record const>(&record, 1));
     }
 
-    Status put(std::string const &key, std::string const &value) {
+    // Compresses all the records first (unless they are grouped into blocks later), then appends them with one write to each of the
+    // key and value files
+    Status put(std::span<Record const> records) {
       using namespace std;
       if (!fValue || !fKey) {
         if (fWhy.ok()) {
@@ -86,62 +106,49 @@ class ConcurrentDb : public DbInterface {
           return JE2BE_ERROR_PUSH(fWhy);
         }
       }
-      if (key.empty()) {
-        return JE2BE_ERROR;
-      }
-      u64 sequence = fSequencer.fetch_add(1);
-      string block;
-      Compress(key, value, sequence, &block);
-
-      u32 valueSizeCompressed = block.size();
-      u32 keySize = key.size();
-      Status st;
-
-      if (fwrite(block.data(), block.size(), 1, fValue) != 1) {
-        st = JE2BE_ERROR_ERRNO;
-        goto error;
+      if (records.empty()) {
+        return Status::Ok();
       }
-
-      if (fwrite(&keySize, sizeof(keySize), 1, fKey) != 1) {
-        st = JE2BE_ERROR_ERRNO;
-        goto error;
-      }
-      if (fwrite(key.data(), key.size(), 1, fKey) != 1) {
-        st = JE2BE_ERROR_ERRNO;
-        goto error;
+      for (auto const &record : records) {
+        if (record.fKey.empty()) {
+          return JE2BE_ERROR;
+        }
       }
-      if (fwrite(&valueSizeCompressed, sizeof(valueSizeCompressed), 1, fKey) != 1) {
-        st = JE2BE_ERROR_ERRNO;
-        goto error;
+      u64 const sequence = fSequencer.fetch_add(records.size());
+      fValueBuffer.clear();
+      fKeyBuffer.clear();
+      u64 offset = fOffset;
+      for (size_t i = 0; i < records.size(); i++) {
+        auto const &record = records[i];
+        size_t const begin = fValueBuffer.size();
+        if (!fCompress) {
+          fValueBuffer.append(record.fValue.data(), record.fValue.size());
+        } else if (!compress(record.fKey, record.fValue, sequence + i, fValueBuffer)) {
+          return fail(JE2BE_ERROR);
+        }
+        u32 valueSize = (u32)(fValueBuffer.size() - begin);
+        u32 keySize = (u32)record.fKey.size();
+        u64 seq = sequence + i;
+        fKeyBuffer.append((char const *)&keySize, sizeof(keySize));
+        fKeyBuffer.append(record.fKey.data(), record.fKey.size());
+        fKeyBuffer.append((char const *)&valueSize, sizeof(valueSize));
+        fKeyBuffer.append((char const *)&offset, sizeof(offset));
+        fKeyBuffer.append((char const *)&seq, sizeof(seq));
+        offset += valueSize;
       }
-      if (fwrite(&fOffset, sizeof(fOffset), 1, fKey) != 1) {
-        st = JE2BE_ERROR_ERRNO;
-        goto error;
+      if (fwrite(fValueBuffer.data(), fValueBuffer.size(), 1, fValue) != 1) {
+        return fail(JE2BE_ERROR_ERRNO);
       }
-      if (fwrite(&sequence, sizeof(sequence), 1, fKey) != 1) {
-        st = JE2BE_ERROR_ERRNO;
-        goto error;
+      if (fwrite(fKeyBuffer.data(), fKeyBuffer.size(), 1, fKey) != 1) {
+        return fail(JE2BE_ERROR_ERRNO);
       }
-      fOffset += block.size();
-      {
-        int idx = (unsigned char)key[0];
+      fOffset = offset;
+      for (auto const &record : records) {
+        int idx = (unsigned char)record.fKey[0];
         fNumKeys[idx] += 1;
-        fTotalKeySize[idx] += key.size();
-      }
-      return st;
-
-    error:
-      if (fKey) {
-        fclose(fKey);
-        fKey = nullptr;
+        fTotalKeySize[idx] += record.fKey.size();
       }
-      if (fValue) {
-        fclose(fValue);
-        fValue = nullptr;
-      }
-      Fs::DeleteAll(fDir);
-      fWhy = st;
-      return st;
+      return Status::Ok();
     }
 
     struct CloseResult {
@@ -185,26 +192,62 @@ class ConcurrentDb : public DbInterface {
     }
 
   private:
-    static void Compress(std::string const &key, leveldb::Slice const &value, u64 seq, std::string *out) {
-      using namespace std;
-      using namespace leveldb;
+    Status fail(Status st) {
+      if (fKey) {
+        fclose(fKey);
+        fKey = nullptr;
+      }
+      if (fValue) {
+        fclose(fValue);
+        fValue = nullptr;
+      }
+      Fs::DeleteAll(fDir);
+      fWhy = st;
+      return st;
+    }
 
-      leveldb::Options o;
-      o.compression = kZlibRawCompression;
-      InternalKeyComparator icmp(BytewiseComparator());
-      o.comparator = &icmp;
+    // Appends a data block holding one record. The block builder and the deflate state are reused across the records.
+    bool compress(leveldb::Slice const &key, leveldb::Slice const &value, u64 seq, std::string &out) {
+      using namespace leveldb;
 
-      leveldb::BlockBuilder bb(&o);
+      if (!fBlockBuilder) {
+        fBlockOptions.compression = kZlibRawCompression;
+        fBlockOptions.comparator = &fComparator;
+        fBlockBuilder = std::make_unique<BlockBuilder>(&fBlockOptions);
+      }
+      fBlockBuilder->Reset();
       InternalKey ik(key, seq, kTypeValue);
-      bb.Add(ik.Encode(), value);
-      Slice c = bb.Finish();
+      fBlockBuilder->Add(ik.Encode(), value);
+      Slice c = fBlockBuilder->Finish();
 
-      mcfile::Compression::CompressDeflate((void *)c.data(), c.size(), *out);
+      if (fDeflateReady) {
+        if (deflateReset(&fDeflate) != Z_OK) {
+          return false;
+        }
+      } else {
+        if (deflateInit2(&fDeflate, Z_BEST_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+          return false;
+        }
+        fDeflateReady = true;
+      }
+      size_t const begin = out.size();
+      out.resize(begin + deflateBound(&fDeflate, (uLong)c.size()));
+      fDeflate.next_in = (Bytef *)c.data();
+      fDeflate.avail_in = (uInt)c.size();
+      fDeflate.next_out = (Bytef *)out.data() + begin;
+      fDeflate.avail_out = (uInt)(out.size() - begin);
+      if (deflate(&fDeflate, Z_FINISH) != Z_STREAM_END) {
+        out.resize(begin);
+        return false;
+      }
+      out.resize(begin + fDeflate.total_out);
+      return true;
     }
 
   private:
     u32 const fId;
     std::atomic_uint64_t &fSequencer;
+    bool const fCompress;
     std::filesystem::path fDir;
     FILE *fKey = nullptr;
     FILE *fValue = nullptr;
@@ -212,18 +255,37 @@ class ConcurrentDb : public DbInterface {
     u64 fNumKeys[256];
     Status fWhy;
     u64 fTotalKeySize[256];
+    leveldb::InternalKeyComparator fComparator{leveldb::BytewiseComparator()};
+    leveldb::Options fBlockOptions;
+    std::unique_ptr<leveldb::BlockBuilder> fBlockBuilder;
+    z_stream fDeflate{};
+    bool fDeflateReady = false;
+    std::string fKeyBuffer;
+    std::string fValueBuffer;
+  };
+
+  // Collects the puts of a WriteBatch. Deletes are dropped, same as ConcurrentDb::del.
+  class BatchRecords : public leveldb::WriteBatch::Handler {
+  public:
+    void Put(leveldb::Slice const &key, leveldb::Slice const &value) override {
+      fRecords.push_back({key, value});
+    }
+
+    void Delete(leveldb::Slice const &key) override {}
+
+    std::vector<Writer::Record> fRecords;
   };
 
   class Gate : std::enable_shared_from_this<Gate> {
   public:
-    std::shared_ptr<Writer> get(uintptr_t key, std::filesystem::path const &dir, std::atomic_uint64_t &keySequence, std::atomic_uint32_t &writerIdGenerator) {
+    std::shared_ptr<Writer> get(uintptr_t key, std::filesystem::path const &dir, std::atomic_uint64_t &keySequence, std::atomic_uint32_t &writerIdGenerator, bool compress) {
       using namespace std;
       auto found = fWriters.find(key);
       if (found != fWriters.end()) {
         return found->second;
       }
       u32 id = writerIdGenerator.fetch_add(1);
-      auto writer = make_shared<Writer>(id, dir, keySequence);
+      auto writer = make_shared<Writer>(id, dir, keySequence, compress);
       fWriters[key] = writer;
       return writer;
     }
@@ -266,6 +328,7 @@ class ConcurrentDb : public DbInterface {
             index_block_options(opt),
             file(f),
             offset(0),
+            data_block(&options),
             index_block(&index_block_options),
             num_entries(0),
             closed(false),
@@ -280,6 +343,7 @@ class ConcurrentDb : public DbInterface {
       leveldb::WritableFile *file;
       u64 offset;
       leveldb::Status status;
+      leveldb::BlockBuilder data_block;
       leveldb::BlockBuilder index_block;
       std::string last_key;
       i64 num_entries;
@@ -349,6 +413,53 @@ class ConcurrentDb : public DbInterface {
       }
     }
 
+    // Add key,value to the data block being built, which is compressed and written once it reaches options.block_size.
+    // REQUIRES: key is after any previously added key according to comparator.
+    // REQUIRES: Finish(), Abandon() have not been called
+    void Add(const leveldb::Slice &key, const leveldb::Slice &value) {
+      using namespace leveldb;
+      Rep *r = rep_;
+      assert(!r->closed);
+      if (!ok())
+        return;
+      if (r->num_entries > 0) {
+        assert(r->options.comparator->Compare(key, Slice(r->last_key)) > 0);
+      }
+
+      if (r->pending_index_entry) {
+        assert(r->data_block.empty());
+        r->options.comparator->FindShortestSeparator(&r->last_key, key);
+        std::string handle_encoding;
+        r->pending_handle.EncodeTo(&handle_encoding);
+        r->index_block.Add(r->last_key, Slice(handle_encoding));
+        r->pending_index_entry = false;
+      }
+
+      r->last_key.assign(key.data(), key.size());
+      r->num_entries++;
+      r->data_block.Add(key, value);
+
+      if (r->data_block.CurrentSizeEstimate() >= r->options.block_size) {
+        Flush();
+      }
+    }
+
+    // Write the data block being built by Add, if any.
+    void Flush() {
+      Rep *r = rep_;
+      assert(!r->closed);
+      if (!ok())
+        return;
+      if (r->data_block.empty())
+        return;
+      assert(!r->pending_index_entry);
+      WriteBlock(&r->data_block, &r->pending_handle);
+      if (ok()) {
+        r->pending_index_entry = true;
+        r->status = r->file->Flush();
+      }
+    }
+
     // Return non-ok iff some error has been detected.
     leveldb::Status status() const { return rep_->status; }
 
@@ -358,7 +469,7 @@ class ConcurrentDb : public DbInterface {
     leveldb::Status Finish() {
       using namespace leveldb;
       Rep *r = rep_;
-      // Flush();
+      Flush();
       assert(!r->closed);
       r->closed = true;
 
@@ -469,13 +580,54 @@ class ConcurrentDb : public DbInterface {
     Rep *rep_;
   };
 
+  // Collects the contents of a file, and hands it to a FileSink when closed
+  class SinkWritableFile : public leveldb::WritableFile {
+  public:
+    SinkWritableFile(std::shared_ptr<FileSink> const &sink, std::filesystem::path const &name) : fSink(sink), fName(name) {}
+
+    leveldb::Status Append(leveldb::Slice const &data) override {
+      fContents.append(data.data(), data.size());
+      return leveldb::Status::OK();
+    }
+
+    leveldb::Status Close() override {
+      if (auto st = fSink->write(fName, fContents, false); !st.ok()) {
+        auto error = st.error();
+        return leveldb::Status::IOError(fName.string(), error ? error->fWhat : std::string());
+      }
+      std::string().swap(fContents);
+      return leveldb::Status::OK();
+    }
+
+    leveldb::Status Flush() override {
+      return leveldb::Status::OK();
+    }
+
+    leveldb::Status Sync() override {
+      return leveldb::Status::OK();
+    }
+
+  private:
+    std::shared_ptr<FileSink> const fSink;
+    std::filesystem::path const fName;
+    std::string fContents;
+  };
+
 public:
-  ConcurrentDb(std::filesystem::path const &dbname, unsigned int concurrency, std::optional<std::filesystem::path> tempDir = std::nullopt)
-      : fDbName(dbname), fSequence(0), fWriterIdGenerator(0), fConcurrency(concurrency), fWriterDir(tempDir ? *tempDir : dbname) {
+  // `blockSize` is the size of the data blocks in the tables. With 0, each record gets its own data block, compressed when it is put.
+  // Otherwise the records are kept uncompressed until close, and the adjacent records of each table are grouped into data blocks of
+  // about `blockSize` bytes, so that small records share their index entries and compression context.
+  ConcurrentDb(std::filesystem::path const &dbname, unsigned int concurrency, std::optional<std::filesystem::path> tempDir = std::nullopt, size_t blockSize = 0)
+      : fDbName(dbname), fSequence(0), fWriterIdGenerator(0), fConcurrency(concurrency), fWriterDir(tempDir ? *tempDir : dbname), fBlockSize(blockSize) {
     leveldb::DestroyDB(dbname, {});
     Fs::CreateDirectories(dbname);
   }
 
+  // Writes the db files into the "db" directory of `sink` instead. Only the files under `tempDir` are written to the disk.
+  ConcurrentDb(std::shared_ptr<FileSink> const &sink, unsigned int concurrency, std::filesystem::path const &tempDir, size_t blockSize = 0)
+      : fSequence(0), fWriterIdGenerator(0), fConcurrency(concurrency), fWriterDir(tempDir), fSink(sink), fBlockSize(blockSize) {
+  }
+
   ~ConcurrentDb() {
     abandonImpl();
   }
@@ -485,7 +637,18 @@ public:
   }
 
   Status put(std::string const &key, leveldb::Slice const &value) override {
-    return gate()->get((uintptr_t)this, fWriterDir, fSequence, fWriterIdGenerator)->put(key, value.ToString());
+    return writer()->put(key, value);
+  }
+
+  Status write(leveldb::WriteBatch &batch) override {
+    BatchRecords records;
+    if (auto st = batch.Iterate(&records); !st.ok()) {
+      return JE2BE_ERROR_WHAT(st.ToString());
+    }
+    if (records.fRecords.empty()) {
+      return Status::Ok();
+    }
+    return writer()->put(records.fRecords);
   }
 
   Status del(std::string const &key) override { return Status::Ok(); }
@@ -553,7 +716,7 @@ public:
         BuildResult{},
         [&](u8 prefix) -> pair<BuildResult, Status> {
           BuildResult ret;
-          if (auto s = BuildTable(fDbName, fWriterDir, writerIds, &fileNumber, ret.fResults, prefix, maxMemoryUsage); !s.ok()) {
+          if (auto s = buildTable(writerIds, &fileNumber, ret.fResults, prefix, maxMemoryUsage); !s.ok()) {
             return make_pair(ret, JE2BE_ERROR_PUSH(s));
           }
           auto p = done.fetch_add(1) + 1;
@@ -585,8 +748,7 @@ public:
     edit.EncodeTo(&manifestRecord);
 
     string manifestFileName = "MANIFEST-000001";
-    fs::path manifestFile = fDbName / manifestFileName;
-    auto [meta, metaOpenStatus] = OpenWritable(manifestFile);
+    auto [meta, metaOpenStatus] = openWritable(manifestFileName);
     if (!meta) {
       return JE2BE_ERROR_WHAT(metaOpenStatus.ToString());
     }
@@ -601,8 +763,7 @@ public:
     }
     meta.reset();
 
-    fs::path currentFile = fDbName / "CURRENT";
-    auto [current, currentOpenStatus] = OpenWritable(currentFile);
+    auto [current, currentOpenStatus] = openWritable("CURRENT");
     if (!current) {
       return JE2BE_ERROR_WHAT(currentOpenStatus.ToString());
     }
@@ -623,14 +784,17 @@ public:
     return Status::Ok();
   }
 
-  static Status BuildTable(
-      std::filesystem::path const &dbname,
-      std::filesystem::path const &writerDir,
+  void abandon() override {
+    abandonImpl();
+  }
+
+private:
+  Status buildTable(
       std::vector<Writer::CloseResult> const &writerIds,
       std::atomic_uint64_t *fileNumber,
       std::vector<TableBuildResult> &out,
       u8 prefix,
-      u64 maxMemoryUsage) {
+      u64 maxMemoryUsage) const {
     using namespace std;
     using namespace leveldb;
     namespace fs = std::filesystem;
@@ -673,7 +837,7 @@ public:
         if (expectedEncount == 0) {
           continue;
         }
-        fs::path fname = writerDir / to_string(cr.fWriterId) / "key.bin";
+        fs::path fname = fWriterDir / to_string(cr.fWriterId) / "key.bin";
         mcfile::ScopedFile fp(mcfile::File::Open(fname, mcfile::File::Mode::Read));
         if (!fp) {
           return JE2BE_ERROR_ERRNO;
@@ -729,7 +893,7 @@ public:
           key.fWriterId = cr.fWriterId;
           key.fKey = keyString;
 
-          if (fread(&key.fValueSizeCompressed, sizeof(key.fValueSizeCompressed), 1, fp.get()) != 1) {
+          if (fread(&key.fValueSize, sizeof(key.fValueSize), 1, fp.get()) != 1) {
             return JE2BE_ERROR_ERRNO;
           }
           if (fread(&key.fOffset, sizeof(key.fOffset), 1, fp.get()) != 1) {
@@ -749,25 +913,41 @@ public:
         return cmp->Compare(lhs.fKey, rhs.fKey) < 0;
       });
 
-      u64 size = 0;
-      vector<Key> bin;
-      for (int i = 0; i < keys.size(); i++) {
-        Key key = keys[i];
-        bin.push_back(key);
-        size += key.fValueSizeCompressed;
-        if (size >= kMaxFileSize) {
+      if (fBlockSize > 0) {
+        // fValueSize is the raw size here, so writeTable splits the tables by the compressed size written so far.
+        // The blocks of a table are compressed one after another: tables of the 256 key prefixes are already built in parallel, so
+        // compressing the blocks of one table in parallel too would only oversubscribe the workers.
+        for (size_t i = 0; i < keys.size();) {
           u64 fn = fileNumber->fetch_add(1);
-          if (auto st = Write(dbname, writerDir, bin, fn, out); !st.ok()) {
+          size_t written = 0;
+          if (auto st = writeTable(span<Key const>(keys).subspan(i), fn, out, written); !st.ok()) {
             return JE2BE_ERROR_PUSH(st);
           }
-          size = 0;
-          bin.clear();
+          i += written;
         }
-      }
-      if (!bin.empty()) {
-        u64 fn = fileNumber->fetch_add(1);
-        if (auto st = Write(dbname, writerDir, bin, fn, out); !st.ok()) {
-          return JE2BE_ERROR_PUSH(st);
+      } else {
+        u64 size = 0;
+        vector<Key> bin;
+        for (int i = 0; i < keys.size(); i++) {
+          Key key = keys[i];
+          bin.push_back(key);
+          size += key.fValueSize;
+          if (size >= kMaxFileSize) {
+            u64 fn = fileNumber->fetch_add(1);
+            size_t written = 0;
+            if (auto st = writeTable(bin, fn, out, written); !st.ok()) {
+              return JE2BE_ERROR_PUSH(st);
+            }
+            size = 0;
+            bin.clear();
+          }
+        }
+        if (!bin.empty()) {
+          u64 fn = fileNumber->fetch_add(1);
+          size_t written = 0;
+          if (auto st = writeTable(bin, fn, out, written); !st.ok()) {
+            return JE2BE_ERROR_PUSH(st);
+          }
         }
       }
 
@@ -777,16 +957,19 @@ public:
     return Status::Ok();
   }
 
-  static Status Write(std::filesystem::path dbname, std::optional<std::filesystem::path> tempDir, std::vector<Key> &keys, u64 fileNumber, std::vector<TableBuildResult> &results) {
+  // Writes `keys` to a table. In block mode, the table is closed once it reaches kMaxFileSize, and `numWritten` tells how many of the
+  // keys went into it
+  Status writeTable(std::span<Key const> keys, u64 fileNumber, std::vector<TableBuildResult> &results, size_t &numWritten) const {
     using namespace std;
     using namespace leveldb;
     namespace fs = std::filesystem;
 
+    numWritten = 0;
     if (keys.empty()) {
       return Status::Ok();
     }
 
-    auto [file, status] = OpenWritable(TableFilePath(dbname, fileNumber));
+    auto [file, status] = openWritable(TableFileName(fileNumber));
     if (!status.ok() || !file) {
       return JE2BE_ERROR_WHAT(status.ToString());
     }
@@ -795,6 +978,9 @@ public:
     bo.compression = kZlibRawCompression;
     InternalKeyComparator icmp(BytewiseComparator());
     bo.comparator = &icmp;
+    if (fBlockSize > 0) {
+      bo.block_size = fBlockSize;
+    }
     auto builder = make_shared<ZlibRawTableBuilder>(bo, file.get());
 
     Status st;
@@ -802,11 +988,6 @@ public:
     optional<u32> openedFile;
     FILE *fp = nullptr;
 
-    fs::path writerDir = dbname;
-    if (tempDir) {
-      writerDir = *tempDir;
-    }
-
     for (auto const &it : keys) {
       Slice userKey(it.fKey);
       InternalKey ik(userKey, it.fSequence, kTypeValue);
@@ -818,7 +999,7 @@ public:
       if (openedFile == it.fWriterId && fp) {
         f = fp;
       } else {
-        fs::path fname = writerDir / to_string(it.fWriterId) / "value.bin";
+        fs::path fname = fWriterDir / to_string(it.fWriterId) / "value.bin";
         f = mcfile::File::Open(fname, mcfile::File::Mode::Read);
         if (!f) {
           return JE2BE_ERROR_ERRNO;
@@ -830,25 +1011,37 @@ public:
         st = JE2BE_ERROR_ERRNO;
         goto cleanup;
       }
-      value.resize(it.fValueSizeCompressed);
-      if (fread(value.data(), it.fValueSizeCompressed, 1, f) != 1) {
+      value.resize(it.fValueSize);
+      if (fread(value.data(), it.fValueSize, 1, f) != 1) {
         st = JE2BE_ERROR_ERRNO;
         goto cleanup;
       }
-      builder->AddAlreadyCompressedAndFlush(ik.Encode(), value);
+      if (fBlockSize > 0) {
+        builder->Add(ik.Encode(), value);
+      } else {
+        builder->AddAlreadyCompressedAndFlush(ik.Encode(), value);
+      }
+      numWritten++;
+      if (fBlockSize > 0 && builder->FileSize() >= kMaxFileSize) {
+        break;
+      }
+    }
+    if (auto s = builder->Finish(); !s.ok()) {
+      st = JE2BE_ERROR_WHAT(s.ToString());
+      goto cleanup;
+    }
+    if (auto s = file->Close(); !s.ok()) {
+      st = JE2BE_ERROR_WHAT(s.ToString());
+      goto cleanup;
     }
-    builder->Finish();
-    file->Close();
 
     {
       InternalKey smallest(keys[0].fKey, keys[0].fSequence, kTypeValue);
-      InternalKey largest(keys[keys.size() - 1].fKey, keys[keys.size() - 1].fSequence, kTypeValue);
+      InternalKey largest(keys[numWritten - 1].fKey, keys[numWritten - 1].fSequence, kTypeValue);
       TableBuildResult result(fileNumber, builder->FileSize(), smallest, largest);
       results.push_back(result);
     }
 
-    keys.clear();
-
   cleanup:
     if (fp) {
       fclose(fp);
@@ -856,11 +1049,14 @@ public:
     return st;
   }
 
-  static std::pair<std::unique_ptr<leveldb::WritableFile>, leveldb::Status> OpenWritable(std::filesystem::path const &path) {
+  std::pair<std::unique_ptr<leveldb::WritableFile>, leveldb::Status> openWritable(std::string const &fileName) const {
     using namespace leveldb;
+    if (fSink) {
+      return std::make_pair(std::make_unique<SinkWritableFile>(fSink, std::filesystem::path("db") / fileName), leveldb::Status::OK());
+    }
     Env *env = Env::Default();
     WritableFile *file = nullptr;
-    leveldb::Status st = env->NewWritableFile(path, &file);
+    leveldb::Status st = env->NewWritableFile(fDbName / fileName, &file);
     if (st.ok() && file) {
       return std::make_pair(std::unique_ptr<leveldb::WritableFile>(file), st);
     } else {
@@ -868,22 +1064,16 @@ public:
     }
   }
 
-  static std::filesystem::path TableFilePath(std::filesystem::path const &dbname, u64 tableNumber) {
+  static std::string TableFileName(u64 tableNumber) {
     std::vector<char> buffer(11, (char)0);
 #if defined(_MSC_VER)
     sprintf_s(buffer.data(), buffer.size(), "%06" PRIu64 ".ldb", tableNumber);
 #else
     snprintf(buffer.data(), buffer.size(), "%06" PRIu64 ".ldb", tableNumber);
 #endif
-    std::string p(buffer.data(), 10);
-    return dbname / p;
+    return std::string(buffer.data(), 10);
   }
 
-  void abandon() override {
-    abandonImpl();
-  }
-
-private:
   void abandonImpl() {
     using namespace std;
     namespace fs = std::filesystem;
@@ -895,6 +1085,10 @@ private:
     fValid = false;
   }
 
+  std::shared_ptr<Writer> writer() {
+    return gate()->get((uintptr_t)this, fWriterDir, fSequence, fWriterIdGenerator, fBlockSize == 0);
+  }
+
   std::shared_ptr<Gate> gate() {
     using namespace std;
     thread_local shared_ptr<Gate> tGate(CreateGate());
@@ -916,6 +1110,8 @@ private:
   bool fValid = true;
   unsigned int const fConcurrency;
   std::filesystem::path const fWriterDir;
+  std::shared_ptr<FileSink> const fSink;
+  size_t const fBlockSize = 0;
 
   static constexpr u64 kMaxFileSize = 2 * 1024 * 1024;
 };
@@ -10,6 +10,7 @@
 
 namespace leveldb {
 class Slice;
+class WriteBatch;
 }
 
 namespace je2be {
@@ -20,6 +21,8 @@ public:
   virtual bool valid() const = 0;
   virtual Status put(std::string const &key, leveldb::Slice const &value) = 0;
   virtual Status del(std::string const &key) = 0;
+  // Applies the puts and deletes of `batch` in one call
+  virtual Status write(leveldb::WriteBatch &batch) = 0;
   virtual Status close(std::function<bool(Rational<u64> const &progress)> progress = nullptr) = 0;
   virtual void abandon() = 0;
 };
@@ -35,10 +35,16 @@ public:
     }
   }
 
-  void write(leveldb::WriteBatch &batch) {
+  Status write(leveldb::WriteBatch &batch) override {
     assert(fDb);
     if (fDb) {
-      fDb->Write(leveldb::WriteOptions{}, &batch);
+      if (auto st = fDb->Write(fWriteOptions, &batch); !st.ok()) {
+        return JE2BE_ERROR_WHAT(st.ToString());
+      } else {
+        return Status::Ok();
+      }
+    } else {
+      return JE2BE_ERROR;
     }
   }
 
@@ -7,6 +7,7 @@ public:
   bool valid() const override { return true; }
   Status put(std::string const &key, leveldb::Slice const &value) override { return Status::Ok(); }
   Status del(std::string const &key) override { return Status::Ok(); }
+  Status write(leveldb::WriteBatch &batch) override { return Status::Ok(); }
   Status close(std::function<bool(Rational<u64> const &progress)> progress = nullptr) override { return Status::Ok(); }
   void abandon() override {};
 };
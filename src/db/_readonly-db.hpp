@@ -8,6 +8,7 @@
 #include "_file.hpp"
 #include "db/_firewall-env.hpp"
 #include "db/_proxy-env.hpp"
+#include "db/_zip-env.hpp"
 
 #include <minecraft-file.hpp>
 
@@ -44,13 +45,30 @@ public:
     leveldb::FileLock *fManifestLock = nullptr;
     std::unique_ptr<FirewallEnv> fFirewall;
     std::unique_ptr<ProxyEnv> fProxy;
+    std::shared_ptr<ZipEnv> fArchive;
   };
 
-  static Status Open(std::filesystem::path const &db, leveldb::DB **ptr, std::filesystem::path const &tempRoot, std::unique_ptr<Closer> &outCloser) {
+  // When `archive` is given, `db` is a path under its mount point. The archive is never modified, so the db is opened on it
+  // directly.
+  static Status Open(std::filesystem::path const &db, leveldb::DB **ptr, std::filesystem::path const &tempRoot, std::unique_ptr<Closer> &outCloser, std::shared_ptr<ZipEnv> const &archive = nullptr) {
     namespace fs = std::filesystem;
 
     *ptr = nullptr;
 
+    if (archive) {
+      auto closer = std::make_unique<Closer>();
+      closer->fArchive = archive;
+      leveldb::Options o;
+      o.env = archive.get();
+      leveldb::DB *dbPtr = nullptr;
+      if (auto st = leveldb::DB::Open(o, db, &dbPtr); !st.ok()) {
+        return JE2BE_ERROR_PUSH(Status::FromLevelDBStatus(st));
+      }
+      *ptr = dbPtr;
+      outCloser.swap(closer);
+      return Status::Ok();
+    }
+
     auto dir = mcfile::File::CreateTempDir(tempRoot);
     if (!dir) {
       return JE2BE_ERROR;
@@ -103,9 +121,9 @@ public:
     return Status::Ok();
   }
 
-  static Status Open(std::filesystem::path const &db, std::filesystem::path const &tempRoot, std::unique_ptr<ReadonlyDb> &out) {
+  static Status Open(std::filesystem::path const &db, std::filesystem::path const &tempRoot, std::unique_ptr<ReadonlyDb> &out, std::shared_ptr<ZipEnv> const &archive = nullptr) {
     Status st;
-    std::unique_ptr<ReadonlyDb> ptr(new ReadonlyDb(db, tempRoot, st));
+    std::unique_ptr<ReadonlyDb> ptr(new ReadonlyDb(db, tempRoot, archive, st));
     if (!ptr->fDb || !ptr->fCloser || !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
@@ -135,9 +153,9 @@ public:
   }
 
 private:
-  ReadonlyDb(std::filesystem::path const &db, std::filesystem::path const &tempRoot, Status &out) {
+  ReadonlyDb(std::filesystem::path const &db, std::filesystem::path const &tempRoot, std::shared_ptr<ZipEnv> const &archive, Status &out) {
     leveldb::DB *ptr = nullptr;
-    out = Open(db, &ptr, tempRoot, fCloser);
+    out = Open(db, &ptr, tempRoot, fCloser, archive);
     fDb.reset(ptr);
   }
 
@@ -0,0 +1,570 @@
+#pragma once
+
+#if __has_include(<leveldb/env.h>)
+#include <leveldb/env.h>
+
+#include <je2be/integers.hpp>
+
+#include <minecraft-file.hpp>
+#include <mz.h>
+#include <mz_strm.h>
+#include <mz_strm_os.h>
+#include <mz_zip.h>
+#include <zlib.h>
+
+#include <defer.hpp>
+
+#include <map>
+#include <mutex>
+#include <set>
+
+namespace je2be {
+
+// leveldb::Env serving the files of a zip archive, such as a .mcworld file, without extracting it.
+// Entries of the archive appear under `mountPoint`, which must be an empty, writable directory. If the archive has the world in a
+// subdirectory, the directory containing level.dat is mounted. The archive itself is never modified: files created under the
+// mount point are written to the disk, where they shadow the entry of the same name, and removed entries are only hidden.
+// Stored entries are read in place from the archive. Deflated entries are inflated into memory when they are opened, and the
+// inflated contents are shared by the readers of the same entry.
+class ZipEnv : public leveldb::Env {
+  struct Entry {
+    u64 fLocalHeaderOffset;
+    u64 fCompressedSize;
+    u64 fUncompressedSize;
+    bool fDeflated;
+  };
+
+  // A range of the archive
+  class StoredFile : public leveldb::RandomAccessFile {
+  public:
+    StoredFile(std::shared_ptr<leveldb::RandomAccessFile> const &archive, u64 offset, u64 size) : fArchive(archive), fOffset(offset), fSize(size) {}
+
+    leveldb::Status Read(uint64_t offset, size_t n, leveldb::Slice *result, char *scratch) const override {
+      if (offset >= fSize) {
+        *result = leveldb::Slice();
+        return leveldb::Status::OK();
+      }
+      n = (size_t)(std::min)((u64)n, fSize - offset);
+      return fArchive->Read(fOffset + offset, n, result, scratch);
+    }
+
+  private:
+    std::shared_ptr<leveldb::RandomAccessFile> const fArchive;
+    u64 const fOffset;
+    u64 const fSize;
+  };
+
+  class InflatedFile : public leveldb::RandomAccessFile {
+  public:
+    explicit InflatedFile(std::shared_ptr<std::string const> const &contents) : fContents(contents) {}
+
+    leveldb::Status Read(uint64_t offset, size_t n, leveldb::Slice *result, char *scratch) const override {
+      if (offset >= fContents->size()) {
+        *result = leveldb::Slice();
+        return leveldb::Status::OK();
+      }
+      n = (size_t)(std::min)((u64)n, (u64)fContents->size() - offset);
+      *result = leveldb::Slice(fContents->data() + offset, n);
+      return leveldb::Status::OK();
+    }
+
+  private:
+    std::shared_ptr<std::string const> const fContents;
+  };
+
+  class SequentialReader : public leveldb::SequentialFile {
+  public:
+    explicit SequentialReader(std::unique_ptr<leveldb::RandomAccessFile> &&file) : fFile(std::move(file)), fPos(0) {}
+
+    leveldb::Status Read(size_t n, leveldb::Slice *result, char *scratch) override {
+      auto st = fFile->Read(fPos, n, result, scratch);
+      if (st.ok()) {
+        fPos += result->size();
+      }
+      return st;
+    }
+
+    leveldb::Status Skip(uint64_t n) override {
+      fPos += n;
+      return leveldb::Status::OK();
+    }
+
+  private:
+    std::unique_ptr<leveldb::RandomAccessFile> const fFile;
+    u64 fPos;
+  };
+
+  using Str = std::u8string;
+
+public:
+  ZipEnv(std::filesystem::path const &archive, std::filesystem::path const &mountPoint) : fMount(mountPoint.lexically_normal()) {
+    using namespace std;
+
+    leveldb::RandomAccessFile *file = nullptr;
+    if (auto st = leveldb::Env::Default()->NewRandomAccessFile(archive, &file); !st.ok()) {
+      return;
+    }
+    fArchive.reset(file);
+
+    map<Str, Entry> entries;
+    if (!ReadCentralDirectory(archive, entries)) {
+      return;
+    }
+
+    // Mount the directory with the shallowest level.dat
+    Str root;
+    optional<size_t> depth;
+    for (auto const &it : entries) {
+      Str const &name = it.first;
+      if (name != u8"level.dat" && !name.ends_with(u8"/level.dat")) {
+        continue;
+      }
+      size_t d = count(name.begin(), name.end(), u8'/');
+      if (!depth || d < *depth) {
+        depth = d;
+        root = name.substr(0, name.size() - 9);
+      }
+    }
+    for (auto const &it : entries) {
+      if (it.first.starts_with(root) && it.first.size() > root.size()) {
+        fEntries[it.first.substr(root.size())] = it.second;
+      }
+    }
+    fE = leveldb::Env::Default();
+  }
+
+  bool Valid() const {
+    return fE != nullptr;
+  }
+
+  // Whole contents of a file, for the files read outside of leveldb such as level.dat
+  std::optional<std::string> contents(std::filesystem::path const &fname) {
+    leveldb::RandomAccessFile *file = nullptr;
+    if (auto st = NewRandomAccessFile(fname, &file); !st.ok()) {
+      return std::nullopt;
+    }
+    std::unique_ptr<leveldb::RandomAccessFile> f(file);
+    uint64_t size = 0;
+    if (auto st = GetFileSize(fname, &size); !st.ok()) {
+      return std::nullopt;
+    }
+    std::string ret(size, '\0');
+    leveldb::Slice slice;
+    if (auto st = f->Read(0, size, &slice, ret.data()); !st.ok() || slice.size() != size) {
+      return std::nullopt;
+    }
+    if (slice.data() != ret.data()) {
+      std::copy_n(slice.data(), size, ret.data());
+    }
+    return ret;
+  }
+
+  leveldb::Status NewSequentialFile(std::filesystem::path const &fname, leveldb::SequentialFile **result) override {
+    leveldb::RandomAccessFile *file = nullptr;
+    if (auto st = NewRandomAccessFile(fname, &file); !st.ok()) {
+      return st;
+    }
+    *result = new SequentialReader(std::unique_ptr<leveldb::RandomAccessFile>(file));
+    return leveldb::Status::OK();
+  }
+
+  leveldb::Status NewRandomAccessFile(std::filesystem::path const &fname, leveldb::RandomAccessFile **result) override {
+    if (!fE) {
+      return IOError();
+    }
+    auto key = entryName(fname);
+    if (!key) {
+      return IOError();
+    }
+    if (fE->FileExists(fname)) {
+      return fE->NewRandomAccessFile(fname, result);
+    }
+    auto entry = find(*key);
+    if (!entry) {
+      return leveldb::Status::NotFound({});
+    }
+    if (!entry->fDeflated) {
+      auto offset = dataOffset(*entry);
+      if (!offset) {
+        return IOError();
+      }
+      *result = new StoredFile(fArchive, *offset, entry->fUncompressedSize);
+      return leveldb::Status::OK();
+    }
+    auto contents = inflate(*key, *entry);
+    if (!contents) {
+      return IOError();
+    }
+    *result = new InflatedFile(contents);
+    return leveldb::Status::OK();
+  }
+
+  leveldb::Status NewWritableFile(std::filesystem::path const &fname, leveldb::WritableFile **result) override {
+    if (!prepareForWrite(fname)) {
+      return IOError();
+    }
+    return fE->NewWritableFile(fname, result);
+  }
+
+  bool FileExists(std::filesystem::path const &fname) override {
+    if (!fE) {
+      return false;
+    }
+    auto key = entryName(fname);
+    if (!key) {
+      return false;
+    }
+    return fE->FileExists(fname) || find(*key);
+  }
+
+  leveldb::Status GetChildren(std::filesystem::path const &dir, std::vector<std::filesystem::path> *result) override {
+    using namespace std;
+    if (!fE) {
+      return IOError();
+    }
+    auto key = entryName(dir);
+    if (!key) {
+      return IOError();
+    }
+    set<filesystem::path> children;
+    vector<filesystem::path> onDisk;
+    if (fE->GetChildren(dir, &onDisk).ok()) {
+      children.insert(onDisk.begin(), onDisk.end());
+    }
+    Str prefix = key->empty() ? Str() : *key + u8"/";
+    {
+      lock_guard<mutex> lock(fMut);
+      for (auto const &it : fEntries) {
+        if (!it.first.starts_with(prefix) || fRemoved.count(it.first) > 0) {
+          continue;
+        }
+        Str trailing = it.first.substr(prefix.size());
+        if (trailing.find(u8'/') == Str::npos) {
+          children.insert(filesystem::path(trailing));
+        }
+      }
+    }
+    result->assign(children.begin(), children.end());
+    return leveldb::Status::OK();
+  }
+
+  leveldb::Status RemoveFile(std::filesystem::path const &fname) override {
+    if (!fE) {
+      return IOError();
+    }
+    auto key = entryName(fname);
+    if (!key) {
+      return IOError();
+    }
+    bool found = false;
+    if (fE->FileExists(fname)) {
+      if (auto st = fE->RemoveFile(fname); !st.ok()) {
+        return st;
+      }
+      found = true;
+    }
+    if (find(*key)) {
+      std::lock_guard<std::mutex> lock(fMut);
+      fRemoved.insert(*key);
+      found = true;
+    }
+    return found ? leveldb::Status::OK() : leveldb::Status::NotFound({});
+  }
+
+  leveldb::Status CreateDir(std::filesystem::path const &dirname) override {
+    if (!fE || !entryName(dirname)) {
+      return IOError();
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(dirname, ec);
+    return ec ? IOError() : leveldb::Status::OK();
+  }
+
+  leveldb::Status RemoveDir(std::filesystem::path const &dirname) override {
+    if (!fE || !entryName(dirname)) {
+      return IOError();
+    }
+    if (fE->FileExists(dirname)) {
+      return fE->RemoveDir(dirname);
+    }
+    return leveldb::Status::OK();
+  }
+
+  leveldb::Status GetFileSize(std::filesystem::path const &fname, uint64_t *file_size) override {
+    if (!fE) {
+      return IOError();
+    }
+    auto key = entryName(fname);
+    if (!key) {
+      return IOError();
+    }
+    if (fE->FileExists(fname)) {
+      return fE->GetFileSize(fname, file_size);
+    }
+    if (auto entry = find(*key); entry) {
+      *file_size = entry->fUncompressedSize;
+      return leveldb::Status::OK();
+    }
+    return leveldb::Status::NotFound({});
+  }
+
+  leveldb::Status RenameFile(std::filesystem::path const &src, std::filesystem::path const &target) override {
+    if (!fE) {
+      return IOError();
+    }
+    auto keySrc = entryName(src);
+    if (!keySrc || !prepareForWrite(target)) {
+      return IOError();
+    }
+    if (fE->FileExists(src)) {
+      return fE->RenameFile(src, target);
+    }
+    // Entries of the archive are copied out, then hidden
+    auto data = contents(src);
+    if (!data) {
+      return leveldb::Status::NotFound({});
+    }
+    leveldb::WritableFile *file = nullptr;
+    if (auto st = fE->NewWritableFile(target, &file); !st.ok()) {
+      return st;
+    }
+    std::unique_ptr<leveldb::WritableFile> f(file);
+    if (auto st = f->Append(*data); !st.ok()) {
+      return st;
+    }
+    if (auto st = f->Close(); !st.ok()) {
+      return st;
+    }
+    std::lock_guard<std::mutex> lock(fMut);
+    fRemoved.insert(*keySrc);
+    return leveldb::Status::OK();
+  }
+
+  leveldb::Status LockFile(std::filesystem::path const &fname, leveldb::FileLock **lock) override {
+    if (!prepareForWrite(fname)) {
+      return IOError();
+    }
+    return fE->LockFile(fname, lock);
+  }
+
+  leveldb::Status UnlockFile(leveldb::FileLock *lock) override {
+    if (!fE) {
+      return IOError();
+    }
+    return fE->UnlockFile(lock);
+  }
+
+  void Schedule(void (*function)(void *arg), void *arg) override {
+    if (!fE) {
+      return;
+    }
+    fE->Schedule(function, arg);
+  }
+
+  void StartThread(void (*function)(void *arg), void *arg) override {
+    if (!fE) {
+      return;
+    }
+    fE->StartThread(function, arg);
+  }
+
+  leveldb::Status GetTestDirectory(std::filesystem::path *path) override {
+    return IOError();
+  }
+
+  leveldb::Status NewLogger(std::filesystem::path const &fname, leveldb::Logger **result) override {
+    if (!prepareForWrite(fname)) {
+      return IOError();
+    }
+    return fE->NewLogger(fname, result);
+  }
+
+  uint64_t NowMicros() override {
+    if (!fE) {
+      return 0;
+    }
+    return fE->NowMicros();
+  }
+
+  void SleepForMicroseconds(int micros) override {
+    if (!fE) {
+      return;
+    }
+    fE->SleepForMicroseconds(micros);
+  }
+
+private:
+  static leveldb::Status IOError() {
+    return leveldb::Status::IOError({});
+  }
+
+  // Name of the entry for a path under the mount point, or nullopt for paths outside of it
+  std::optional<Str> entryName(std::filesystem::path const &p) const {
+    auto rel = p.lexically_normal().lexically_relative(fMount);
+    if (rel.empty()) {
+      return std::nullopt;
+    }
+    Str key = rel.generic_u8string();
+    if (key == u8".") {
+      return Str();
+    }
+    if (key == u8".." || key.starts_with(u8"../")) {
+      return std::nullopt;
+    }
+    if (key.ends_with(u8'/')) {
+      key.pop_back();
+    }
+    return key;
+  }
+
+  std::optional<Entry> find(Str const &key) {
+    std::lock_guard<std::mutex> lock(fMut);
+    if (fRemoved.count(key) > 0) {
+      return std::nullopt;
+    }
+    auto found = fEntries.find(key);
+    if (found == fEntries.end()) {
+      return std::nullopt;
+    }
+    return found->second;
+  }
+
+  // Written files shadow the archive entry of the same name, so the entry doesn't have to be hidden here
+  bool prepareForWrite(std::filesystem::path const &fname) {
+    if (!fE || !entryName(fname)) {
+      return false;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(fname.parent_path(), ec);
+    return !ec;
+  }
+
+  std::optional<u64> dataOffset(Entry const &entry) const {
+    // Local file header: the lengths of the file name and the extra field are at offset 26 and 28
+    char scratch[30];
+    leveldb::Slice header;
+    if (auto st = fArchive->Read(entry.fLocalHeaderOffset, sizeof(scratch), &header, scratch); !st.ok() || header.size() != sizeof(scratch)) {
+      return std::nullopt;
+    }
+    u8 const *p = (u8 const *)header.data();
+    if (p[0] != 0x50 || p[1] != 0x4b || p[2] != 0x03 || p[3] != 0x04) {
+      return std::nullopt;
+    }
+    u16 nameLength = (u16)p[26] | ((u16)p[27] << 8);
+    u16 extraLength = (u16)p[28] | ((u16)p[29] << 8);
+    return entry.fLocalHeaderOffset + sizeof(scratch) + nameLength + extraLength;
+  }
+
+  std::shared_ptr<std::string const> inflate(Str const &key, Entry const &entry) {
+    using namespace std;
+    {
+      lock_guard<mutex> lock(fMut);
+      if (auto found = fInflated.find(key); found != fInflated.end()) {
+        if (auto contents = found->second.lock(); contents) {
+          return contents;
+        }
+      }
+    }
+    auto offset = dataOffset(entry);
+    if (!offset) {
+      return nullptr;
+    }
+    string compressed(entry.fCompressedSize, '\0');
+    leveldb::Slice slice;
+    if (auto st = fArchive->Read(*offset, compressed.size(), &slice, compressed.data()); !st.ok() || slice.size() != compressed.size()) {
+      return nullptr;
+    }
+    auto contents = make_shared<string>(entry.fUncompressedSize, '\0');
+    z_stream zs{};
+    if (inflateInit2(&zs, -15) != Z_OK) {
+      return nullptr;
+    }
+    defer {
+      inflateEnd(&zs);
+    };
+    zs.next_in = (Bytef *)slice.data();
+    zs.avail_in = (uInt)slice.size();
+    zs.next_out = (Bytef *)contents->data();
+    zs.avail_out = (uInt)contents->size();
+    if (int ret = ::inflate(&zs, Z_FINISH); ret != Z_STREAM_END || zs.total_out != contents->size()) {
+      return nullptr;
+    }
+
+    lock_guard<mutex> lock(fMut);
+    if (auto found = fInflated.find(key); found != fInflated.end()) {
+      if (auto existing = found->second.lock(); existing) {
+        // Inflated by another thread in the meantime
+        return existing;
+      }
+    }
+    fInflated[key] = contents;
+    return contents;
+  }
+
+  static bool ReadCentralDirectory(std::filesystem::path const &archive, std::map<Str, Entry> &out) {
+    void *stream = mz_stream_os_create();
+    if (!stream) {
+      return false;
+    }
+    defer {
+      mz_stream_os_delete(&stream);
+    };
+    void *handle = mz_zip_create();
+    if (!handle) {
+      return false;
+    }
+    defer {
+      mz_zip_delete(&handle);
+    };
+    if (mz_stream_os_open(stream, (char const *)archive.u8string().c_str(), MZ_OPEN_MODE_READ) != MZ_OK) {
+      return false;
+    }
+    if (mz_zip_open(handle, stream, MZ_OPEN_MODE_READ) != MZ_OK) {
+      return false;
+    }
+    defer {
+      mz_zip_close(handle);
+    };
+    for (i32 err = mz_zip_goto_first_entry(handle); err == MZ_OK; err = mz_zip_goto_next_entry(handle)) {
+      mz_zip_file *info = nullptr;
+      if (mz_zip_entry_get_info(handle, &info) != MZ_OK || !info) {
+        return false;
+      }
+      if (mz_zip_entry_is_dir(handle) == MZ_OK) {
+        continue;
+      }
+      if (info->flag & MZ_ZIP_FLAG_ENCRYPTED) {
+        return false;
+      }
+      Entry entry;
+      entry.fLocalHeaderOffset = (u64)info->disk_offset;
+      entry.fCompressedSize = (u64)info->compressed_size;
+      entry.fUncompressedSize = (u64)info->uncompressed_size;
+      if (info->compression_method == MZ_COMPRESS_METHOD_STORE) {
+        entry.fDeflated = false;
+      } else if (info->compression_method == MZ_COMPRESS_METHOD_DEFLATE) {
+        entry.fDeflated = true;
+      } else {
+        return false;
+      }
+      Str name((char8_t const *)info->filename, info->filename_size);
+      // Some archivers write Windows-style separators
+      std::replace(name.begin(), name.end(), u8'\\', u8'/');
+      out[name] = entry;
+    }
+    return true;
+  }
+
+private:
+  std::filesystem::path const fMount;
+  leveldb::Env *fE = nullptr;
+  std::shared_ptr<leveldb::RandomAccessFile> fArchive;
+  std::map<Str, Entry> fEntries;
+  std::mutex fMut;
+  std::set<Str> fRemoved;
+  std::map<Str, std::weak_ptr<std::string const>> fInflated;
+};
+
+} // namespace je2be
+
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <je2be/integers.hpp>
+
+#include <minecraft-file.hpp>
+
+#include "item/_map-color.hpp"
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace je2be {
+
+// Converted map colors, looked up by the content of the colors being converted. Blank maps and copies of the same map art
+// have identical colors, so their conversion is done only once.
+// Results are kept for up to `capacity` distinct inputs, together with the input itself to rule out hash collisions. Inputs
+// seen after that are converted every time. Safe to be used from multiple threads.
+class MapColorCache {
+public:
+  // Capacity used by the converters. Each entry holds up to 80 KiB of colors
+  static constexpr size_t kDefaultCapacity = 256;
+
+  explicit MapColorCache(size_t capacity) : fCapacity(capacity) {}
+
+  // Java color ids (one byte per pixel) to Bedrock RGBA (four bytes per pixel)
+  std::shared_ptr<std::vector<u8> const> rgbaFromIds(std::vector<u8> const &ids) {
+    return get(fRgbaFromIds, ids, [](std::vector<u8> const &in) {
+      std::vector<u8> out(in.size() * 4);
+      MapColor::RgbaFromIds(in.data(), in.size(), out.data());
+      return out;
+    });
+  }
+
+  // Bedrock RGBA to Java color ids
+  std::shared_ptr<std::vector<u8> const> idsFromRgba(std::vector<u8> const &rgba) {
+    return get(fIdsFromRgba, rgba, [](std::vector<u8> const &in) {
+      std::vector<u8> out(in.size() / 4);
+      MapColor::IdsFromRgba(in.data(), out.size(), out.data());
+      return out;
+    });
+  }
+
+private:
+  struct Entry {
+    std::vector<u8> fInput;
+    std::shared_ptr<std::vector<u8> const> fOutput;
+  };
+
+  using Table = std::unordered_multimap<u64, Entry>;
+
+  std::shared_ptr<std::vector<u8> const> get(Table &table, std::vector<u8> const &input, std::function<std::vector<u8>(std::vector<u8> const &)> convert) {
+    using namespace std;
+    u64 hash = mcfile::XXHash<u64>::Digest(input.data(), input.size());
+    {
+      lock_guard<mutex> lock(fMut);
+      auto [begin, end] = table.equal_range(hash);
+      for (auto it = begin; it != end; it++) {
+        if (it->second.fInput == input) {
+          return it->second.fOutput;
+        }
+      }
+    }
+    auto output = make_shared<vector<u8> const>(convert(input));
+    lock_guard<mutex> lock(fMut);
+    if (fRgbaFromIds.size() + fIdsFromRgba.size() < fCapacity) {
+      auto [begin, end] = table.equal_range(hash);
+      for (auto it = begin; it != end; it++) {
+        if (it->second.fInput == input) {
+          // Converted by another thread in the meantime
+          return it->second.fOutput;
+        }
+      }
+      table.insert(make_pair(hash, Entry{input, output}));
+    }
+    return output;
+  }
+
+private:
+  size_t const fCapacity;
+  std::mutex fMut;
+  Table fRgbaFromIds;
+  Table fIdsFromRgba;
+};
+
+} // namespace je2be
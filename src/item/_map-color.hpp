@@ -3,6 +3,9 @@
 #include "color/_lab.hpp"
 #include "color/_rgba.hpp"
 
+#include <atomic>
+#include <cstring>
+
 namespace je2be {
 
 class MapColor {
@@ -109,6 +112,60 @@ class MapColor {
     return sTable.get();
   }
 
+  // Entries of GetLabTable in its iteration order, so that ties are resolved in the same way as iterating the table itself
+  static std::vector<Colors> const *CreateLabList() {
+    auto const &table = *GetLabTable();
+    auto ret = new std::vector<Colors>();
+    ret->reserve(table.size());
+    for (auto const &it : table) {
+      ret->push_back(it.second);
+    }
+    return ret;
+  }
+
+  static std::vector<Colors> const *GetLabList() {
+    static std::unique_ptr<std::vector<Colors> const> const sList(CreateLabList());
+    return sList.get();
+  }
+
+  // Memoized result of NearestColorId for each 24-bit RGB value: 0 when not computed yet, otherwise colorId + 1.
+  // Filled lazily, so only the colors which actually appear on maps pay for the Lab search.
+  static std::atomic<u8> *GetNearestTable() {
+    static std::unique_ptr<std::atomic<u8>[]> const sTable(new std::atomic<u8>[1 << 24]());
+    return sTable.get();
+  }
+
+  static u8 NearestColorId(Rgba color) {
+    Lab ref = Lab::From(color);
+    u8 colorId = 0;
+
+    double minDifference = std::numeric_limits<double>::max();
+    for (Colors const &it : *GetLabList()) {
+      double difference = Lab::Difference(ref, it.fLab);
+      if (difference < minDifference) {
+        minDifference = difference;
+        colorId = it.fColorId;
+      }
+    }
+    return colorId;
+  }
+
+  // RGBA bytes of each color id, packed in memory order so that a lookup is a single 4 byte copy
+  static std::vector<u32> const *CreateRgbaTable() {
+    auto ret = new std::vector<u32>(256);
+    for (int id = 0; id < 256; id++) {
+      Rgba color = RgbaFromId((u8)id);
+      u8 bytes[4] = {color.fR, color.fG, color.fB, color.fA};
+      std::memcpy(ret->data() + id, bytes, 4);
+    }
+    return ret;
+  }
+
+  static std::vector<u32> const *GetRgbaTable() {
+    static std::unique_ptr<std::vector<u32> const> const sTable(CreateRgbaTable());
+    return sTable.get();
+  }
+
   static Rgba RgbaFromIndexAndVariant(u8 index, u8 variant) {
     auto const &mapping = *GetTable();
     if (index >= mapping.size()) {
@@ -129,6 +186,22 @@ public:
     return RgbaFromIndexAndVariant(index, variant);
   }
 
+  // Writes the RGBA bytes of `count` color ids to `out`, which must have room for 4 * count bytes
+  static void RgbaFromIds(u8 const *ids, size_t count, u8 *out) {
+    u32 const *table = GetRgbaTable()->data();
+    for (size_t i = 0; i < count; i++) {
+      std::memcpy(out + i * 4, table + ids[i], 4);
+    }
+  }
+
+  // Writes the color id most similar to each of the `count` RGBA pixels in `rgba` to `out`
+  static void IdsFromRgba(u8 const *rgba, size_t count, u8 *out) {
+    for (size_t i = 0; i < count; i++) {
+      u8 const *p = rgba + i * 4;
+      out[i] = MostSimilarColorId(Rgba(p[0], p[1], p[2], p[3]));
+    }
+  }
+
   static u8 MostSimilarColorId(Rgba color) {
     auto const &table = *GetLabTable();
 
@@ -142,18 +215,13 @@ public:
       return found->second.fColorId;
     }
 
-    Lab ref = Lab::From(color);
-    u8 colorId = 0;
-
-    double minDifference = std::numeric_limits<double>::max();
-    for (auto const &it : table) {
-      Lab lab = it.second.fLab;
-      double difference = Lab::Difference(ref, lab);
-      if (difference < minDifference) {
-        minDifference = difference;
-        colorId = it.second.fColorId;
-      }
+    // The Lab search ignores alpha, so the result only depends on the RGB value
+    std::atomic<u8> &memo = GetNearestTable()[color.toRGB()];
+    if (u8 cached = memo.load(std::memory_order_relaxed); cached != 0) {
+      return cached - 1;
     }
+    u8 colorId = NearestColorId(color);
+    memo.store(colorId + 1, std::memory_order_relaxed);
     return colorId;
   }
 };
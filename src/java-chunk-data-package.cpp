@@ -2,6 +2,7 @@
 
 #include "_pos3.hpp"
 #include "java/_biome-map-legacy.hpp"
+#include "java/_chunk-biomes.hpp"
 #include "java/_chunk-data.hpp"
 #include "java/_context.hpp"
 #include "java/_entity.hpp"
@@ -144,85 +145,8 @@ private:
   }
 
   void buildData2DCavesAndCliffs2(mcfile::je::Chunk const &chunk, mcfile::Dimension dim) {
-    using namespace std;
-    using namespace mcfile;
-    using namespace mcfile::be;
-    using namespace mcfile::biomes;
-
-    int minChunkY = 0;
-    if (dim == mcfile::Dimension::Overworld) {
-      minChunkY = -4;
-    }
-    int maxChunkY = minChunkY;
-    for (auto const &section : chunk.fSections) {
-      if (!section) {
-        continue;
-      }
-      maxChunkY = (std::max)(maxChunkY, section->y());
-    }
-
-    fHeightMap->offset(minChunkY);
-
-    int const x0 = chunk.minBlockX();
-    int const y0 = chunk.minBlockY();
-    int const z0 = chunk.minBlockZ();
-    fBiomeMap = make_shared<BiomeMap>(minChunkY, maxChunkY);
-    if (minChunkY < chunk.chunkY()) {
-      // Extend BiomeMap below chunk.chunkY()
-
-      // Lookup most used biome in lowest chunk section
-      unordered_map<BiomeId, int> used;
-      for (int ly = 0; ly < 16; ly += 4) {
-        for (int lz = 0; lz < 16; lz += 4) {
-          for (int lx = 0; lx < 16; lx += 4) {
-            auto biome = chunk.biomeAt(x0 + lx, y0 + ly, z0 + lz);
-            used[biome] += 1;
-          }
-        }
-      }
-      vector<pair<BiomeId, int>> sorted;
-      copy(used.begin(), used.end(), back_inserter(sorted));
-      stable_sort(sorted.begin(), sorted.end(), [](auto lhs, auto rhs) {
-        return lhs.second > rhs.second;
-      });
-
-      // Copy biome to below y < chunk.chunkY()
-      BiomeId biome;
-      if (sorted.empty()) {
-        if (dim == Dimension::Nether) {
-          biome = minecraft::nether_wastes;
-        } else if (dim == Dimension::End) {
-          biome = minecraft::the_end;
-        } else {
-          biome = minecraft::plains;
-        }
-      } else {
-        biome = sorted.front().first;
-      }
-      for (int cy = minChunkY; cy < chunk.chunkY(); cy++) {
-        for (int ly = 0; ly < 16; ly++) {
-          int by = ly + cy * 16;
-          for (int lz = 0; lz < 16; lz++) {
-            for (int lx = 0; lx < 16; lx++) {
-              fBiomeMap->set(lx, by, lz, biome);
-            }
-          }
-        }
-      }
-    }
-    for (int cy = chunk.chunkY(); cy <= maxChunkY; cy++) {
-      for (int ly = 0; ly < 16; ly++) {
-        int by = ly + cy * 16;
-        for (int lz = 0; lz < 16; lz++) {
-          int bz = lz + z0;
-          for (int lx = 0; lx < 16; lx++) {
-            int bx = lx + x0;
-            auto biome = chunk.biomeAt(bx, by, bz);
-            fBiomeMap->set(lx, by, lz, biome);
-          }
-        }
-      }
-    }
+    fHeightMap->offset(ChunkBiomes::MinChunkY(dim));
+    fBiomeMap = ChunkBiomes::Build(chunk, dim);
   }
 
   void buildData2DLegacy(mcfile::je::Chunk const &chunk, mcfile::Dimension dim) {
@@ -14,6 +14,7 @@
 #include "java/_entity-store.hpp"
 #include "java/_java-edition-map.hpp"
 #include "java/_moving-piston.hpp"
+#include "java/_palette-scan.hpp"
 #include "java/_sub-chunk.hpp"
 #include "java/_world-data.hpp"
 
@@ -323,27 +324,25 @@ private:
   static void CompensateKelp(mcfile::je::Chunk &chunk) {
     using namespace std;
     using namespace mcfile::je;
-    bool hasKelp = false;
-    for (auto const &section : chunk.fSections) {
-      if (!section) {
-        continue;
-      }
-      section->eachBlockPalette([&hasKelp](shared_ptr<Block const> const &block, size_t) {
-        if (block->fName == u8"minecraft:kelp_plant") {
-          hasKelp = true;
-          return false;
-        }
-        return true;
-      });
-      if (hasKelp) {
-        break;
-      }
-    }
+    bool hasKelp = PaletteScan::Contains(chunk, [](Block const &block) {
+      return block.fName == u8"minecraft:kelp_plant";
+    });
     if (!hasKelp) {
       return;
     }
+    // Blocks are only modified in the columns having kelp
+    bool columns[16][16] = {};
+    auto kelps = PaletteScan::Find(chunk, [](Block const &block) {
+      return block.fName == u8"minecraft:kelp_plant" || block.fName == u8"minecraft:kelp";
+    });
+    for (auto const &found : kelps) {
+      columns[found.fPos.fX - chunk.minBlockX()][found.fPos.fZ - chunk.minBlockZ()] = true;
+    }
     for (int x = chunk.minBlockX(); x <= chunk.maxBlockX(); x++) {
       for (int z = chunk.minBlockZ(); z <= chunk.maxBlockZ(); z++) {
+        if (!columns[x - chunk.minBlockX()][z - chunk.minBlockZ()]) {
+          continue;
+        }
         int minY = chunk.minBlockY();
         int maxY = chunk.maxBlockY();
         shared_ptr<Block const> lower;
@@ -385,22 +384,9 @@ private:
     using namespace mcfile;
     using namespace mcfile::je;
     using namespace mcfile::blocks::minecraft;
-    bool hasMsurhoom = false;
-    for (auto const &section : chunk.fSections) {
-      if (!section) {
-        continue;
-      }
-      section->eachBlockPalette([&hasMsurhoom](shared_ptr<Block const> const &block, size_t) {
-        if (block->fId == red_mushroom_block || block->fId == brown_mushroom) {
-          hasMsurhoom = true;
-          return false;
-        }
-        return true;
-      });
-      if (hasMsurhoom) {
-        break;
-      }
-    }
+    bool hasMsurhoom = PaletteScan::Contains(chunk, [](Block const &block) {
+      return block.fId == red_mushroom_block || block.fId == brown_mushroom;
+    });
     if (!hasMsurhoom) {
       return;
     }
@@ -410,31 +396,24 @@ private:
                                                      {u8"east", Pos3i(1, 0, 0)},
                                                      {u8"south", Pos3i(0, 0, 1)},
                                                      {u8"west", Pos3i(-1, 0, 0)}});
-    for (int x = chunk.minBlockX(); x <= chunk.maxBlockX(); x++) {
-      for (int z = chunk.minBlockZ(); z <= chunk.maxBlockZ(); z++) {
-        int minY = chunk.minBlockY();
-        int maxY = chunk.maxBlockY();
-        for (int y = minY; y <= maxY; y++) {
-          auto center = chunk.blockAt(x, y, z);
-          if (!center) {
-            continue;
-          }
-          auto id = center->fId;
-          if (id != red_mushroom_block && id != brown_mushroom_block) {
-            continue;
-          }
-          map<u8string, optional<u8string>> props;
-          for (auto const &dir : directions) {
-            auto pos = Pos3i(x, y, z) + dir.second;
-            auto block = loader.blockAt(pos);
-            if (block && !mcfile::blocks::IsTransparent(block->fId)) {
-              props[dir.first] = nullopt;
-            }
-          }
-          auto replace = center->applying(props);
-          chunk.setBlockAt(x, y, z, replace);
+    auto mushroomBlocks = PaletteScan::Find(chunk, [](Block const &block) {
+      return block.fId == red_mushroom_block || block.fId == brown_mushroom_block;
+    });
+    for (auto const &found : mushroomBlocks) {
+      int x = found.fPos.fX;
+      int y = found.fPos.fY;
+      int z = found.fPos.fZ;
+      auto const &center = found.fBlock;
+      map<u8string, optional<u8string>> props;
+      for (auto const &dir : directions) {
+        auto pos = Pos3i(x, y, z) + dir.second;
+        auto block = loader.blockAt(pos);
+        if (block && !mcfile::blocks::IsTransparent(block->fId)) {
+          props[dir.first] = nullopt;
         }
       }
+      auto replace = center->applying(props);
+      chunk.setBlockAt(x, y, z, replace);
     }
   }
 };
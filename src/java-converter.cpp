@@ -14,6 +14,7 @@
 #include <je2be/java/progress.hpp>
 
 #include "_directory-iterator.hpp"
+#include "_file-sink.hpp"
 #include "_parallel.hpp"
 #include "db/_concurrent-db.hpp"
 #include "java/_context.hpp"
@@ -26,6 +27,8 @@
 #include "java/_world-data.hpp"
 #include "java/_world.hpp"
 
+#include <defer.hpp>
+
 namespace je2be::java {
 
 class Converter::Impl {
@@ -35,17 +38,13 @@ public:
   static Status Run(std::filesystem::path const &input, std::filesystem::path const &output, Options const &o, int concurrency, Progress *progress = nullptr) {
     using namespace std;
     namespace fs = std::filesystem;
-    using namespace mcfile;
 
     SessionLock lock(input);
     if (!lock.lock()) {
       return JE2BE_ERROR;
     }
 
-    double const numTotalChunks = GetTotalNumChunks(input, o);
-
-    auto rootPath = output;
-    auto dbPath = rootPath / "db";
+    auto dbPath = output / "db";
 
     error_code ec;
     fs::create_directories(dbPath, ec);
@@ -53,16 +52,64 @@ public:
       return JE2BE_ERROR_WHAT(ec.message());
     }
 
+    DirectoryFileSink sink(output);
+    ConcurrentDb db(dbPath, concurrency, o.fDbTempDirectory, o.fDbBlockSize);
+    return Convert(input, sink, db, o, concurrency, progress);
+  }
+
+  static Status RunToMcworld(std::filesystem::path const &input, std::filesystem::path const &output, Options const &o, int concurrency, Progress *progress = nullptr) {
+    using namespace std;
+    namespace fs = std::filesystem;
+
+    SessionLock lock(input);
+    if (!lock.lock()) {
+      return JE2BE_ERROR;
+    }
+
+    optional<fs::path> writerDir = o.fDbTempDirectory;
+    if (!writerDir) {
+      writerDir = mcfile::File::CreateTempDir(o.getTempDirectory());
+      if (!writerDir) {
+        return JE2BE_ERROR;
+      }
+    }
+    defer {
+      if (!o.fDbTempDirectory) {
+        Fs::DeleteAll(*writerDir);
+      }
+    };
+
+    auto sink = make_shared<ZipFileSink>(output);
+    Status st;
+    {
+      ConcurrentDb db(sink, concurrency, *writerDir, o.fDbBlockSize);
+      st = Convert(input, *sink, db, o, concurrency, progress);
+    }
+    if (auto closed = sink->close(); st.ok() && !closed.ok()) {
+      st = JE2BE_ERROR_PUSH(closed);
+    }
+    if (!st.ok()) {
+      Fs::Delete(output);
+    }
+    return st;
+  }
+
+private:
+  static Status Convert(std::filesystem::path const &input, FileSink &sink, ConcurrentDb &db, Options const &o, int concurrency, Progress *progress) {
+    using namespace std;
+    using namespace mcfile;
+
+    double const numTotalChunks = GetTotalNumChunks(input, o);
+
     auto data = Level::Read(o.getLevelDatFilePath(input));
     if (!data) {
       return JE2BE_ERROR;
     }
     Level level = Level::ImportFromJava(*data);
 
-    bool ok = Datapacks::Import(input, output);
+    bool ok = Datapacks::Import(input, sink, concurrency);
 
     auto levelData = std::make_unique<LevelData>(input, o, level.fCurrentTick, level.fDifficulty, level.fCommandsEnabled, level.fGameType, level.fDataVersion);
-    ConcurrentDb db(dbPath, concurrency, o.fDbTempDirectory);
     if (!db.valid()) {
       return JE2BE_ERROR;
     }
@@ -190,9 +237,9 @@ public:
         level.fExperiments[ex] = true;
       }
       level.fCheatsEnabled = levelData->fAllowCommand;
-      ok = level.write(output / "level.dat");
+      ok = level.write(sink);
       if (ok) {
-        if (auto st = levelData->put(db, *data, levelData->fUuids); !st.ok()) {
+        if (auto st = levelData->put(db, *data, levelData->fUuids, concurrency); !st.ok()) {
           return JE2BE_ERROR_PUSH(st);
         }
       }
@@ -222,6 +269,7 @@ public:
     }
   }
 
+public:
   static std::optional<std::string> LocalPlayerData(CompoundTag const &tag, LevelData &ld) {
     using namespace std;
     using namespace mcfile::stream;
@@ -363,4 +411,8 @@ Status Converter::Run(std::filesystem::path const &input, std::filesystem::path
   return Impl::Run(input, output, o, concurrency, progress);
 }
 
+Status Converter::RunToMcworld(std::filesystem::path const &input, std::filesystem::path const &output, Options const &o, int concurrency, Progress *progress) {
+  return Impl::RunToMcworld(input, output, o, concurrency, progress);
+}
+
 } // namespace je2be::java
@@ -3,6 +3,7 @@
 #include <je2be/nbt.hpp>
 
 #include "db/_db-interface.hpp"
+#include "item/_map-color-cache.hpp"
 #include "item/_map-color.hpp"
 #include "item/_map-decoration.hpp"
 #include "java/_components.hpp"
@@ -24,7 +25,7 @@ public:
     return *(i64 *)&s;
   }
 
-  static Status Convert(i32 javaMapId, CompoundTag const &item, std::filesystem::path const &input, Options const &opt, DbInterface &db) {
+  static Status Convert(i32 javaMapId, CompoundTag const &item, std::filesystem::path const &input, Options const &opt, MapColorCache &colorCache, DbInterface &db) {
     using namespace std;
     namespace fs = std::filesystem;
     using namespace mcfile::stream;
@@ -93,20 +94,9 @@ public:
       auto decorations = List<Tag::Type::Compound>();
 
       if (beScale == scale) {
-        int i = 0;
-        int j = 0;
         vector<u8> const &colorsArray = colors->value();
-        for (int y = 0; y < 128; y++) {
-          for (int x = 0; x < 128; x++, i++) {
-            u8 colorId = colorsArray[i];
-            Rgba color = MapColor::RgbaFromId(colorId);
-            outColors[j] = color.fR;
-            outColors[j + 1] = color.fG;
-            outColors[j + 2] = color.fB;
-            outColors[j + 3] = color.fA;
-            j += 4;
-          }
-        }
+        auto rgba = colorCache.rgbaFromIds(colorsArray);
+        copy_n(rgba->begin(), (std::min)(rgba->size(), outColors.size()), outColors.begin());
 
         auto frames = data->listTag(u8"frames");
         if (frames) {
@@ -260,8 +250,8 @@ i64 Map::UUID(i32 javaMapId, u8 scale) {
   return Impl::UUID(javaMapId, scale);
 }
 
-Status Map::Convert(i32 javaMapId, CompoundTag const &item, std::filesystem::path const &input, Options const &opt, DbInterface &db) {
-  return Impl::Convert(javaMapId, item, input, opt, db);
+Status Map::Convert(i32 javaMapId, CompoundTag const &item, std::filesystem::path const &input, Options const &opt, MapColorCache &colorCache, DbInterface &db) {
+  return Impl::Convert(javaMapId, item, input, opt, colorCache, db);
 }
 
 } // namespace je2be::java
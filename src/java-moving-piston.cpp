@@ -3,6 +3,7 @@
 #include "_data-version.hpp"
 #include "enums/_facing6.hpp"
 #include "java/_block-data.hpp"
+#include "java/_palette-scan.hpp"
 #include "java/_versions.hpp"
 
 namespace je2be::java {
@@ -22,84 +23,77 @@ public:
     unordered_map<Pos3i, shared_ptr<CompoundTag>, Pos3iHasher> tileEntityReplacement;
 
     if (ChunkHasPiston(chunk)) {
-      for (int by = chunk.minBlockY(); by <= chunk.maxBlockY(); by++) {
-        for (int bx = chunk.minBlockX(); bx <= chunk.maxBlockX(); bx++) {
-          for (int bz = chunk.minBlockZ(); bz <= chunk.maxBlockZ(); bz++) {
-            Pos3i pos(bx, by, bz);
-            auto block = loader.blockAt(pos);
-            if (!block) {
-              continue;
-            }
-            if (block->fName != u8"minecraft:sticky_piston" && block->fName != u8"minecraft:piston") {
-              continue;
-            }
-            if (loader.tileEntityAt(pos)) {
-              continue;
-            }
-            Facing6 f6 = Facing6FromJavaName(block->property(u8"facing", u8""));
-            Pos3i vec = Pos3iFromFacing6(f6);
-            Pos3i pistonHeadPos = pos + vec;
-            int facingDirectionB = BedrockFacingDirectionBFromFacing6(f6);
-            auto pistonHeadTileEntity = loader.tileEntityAt(pistonHeadPos);
-            if (pistonHeadTileEntity) {
-              auto pistonHead = PistonTileEntity::From(pistonHeadTileEntity, pistonHeadPos);
-              if (!pistonHead) {
-                continue;
-              }
-              if (!pistonHead->fSource || !pistonHead->fExtending || pistonHead->fFacing != facingDirectionB) {
-                continue;
-              }
-
-              unordered_set<Pos3i, Pos3iHasher> attachedBlocks;
-              LookupAttachedBlocks(loader, pistonHeadPos, true, facingDirectionB, attachedBlocks);
-
-              auto progressJ = pistonHeadTileEntity->float32(u8"progress", 0);
-              float lastProgressB = progressJ;
-              float progressB = progressJ > 0 ? 0 : 0.5f;
-
-              auto pistonArm = Compound();
-              auto attachedBlocksTag = List<Tag::Type::Int>();
-              for (auto attachedBlock : attachedBlocks) {
-                Pos3i actual = attachedBlock - vec;
-                attachedBlocksTag->push_back(Int(actual.fX));
-                attachedBlocksTag->push_back(Int(actual.fY));
-                attachedBlocksTag->push_back(Int(actual.fZ));
-              }
-              pistonArm->set(u8"AttachedBlocks", attachedBlocksTag);
-              pistonArm->set(u8"BreakBlocks", List<Tag::Type::Int>());
-              pistonArm->set(u8"LastProgress", Float(lastProgressB));
-              pistonArm->set(u8"NewState", Byte(1));
-              pistonArm->set(u8"Progress", Float(progressB));
-              pistonArm->set(u8"State", Byte(1));
-              pistonArm->set(u8"Sticky", Bool(block->fName == u8"minecraft:sticky_piston"));
-              pistonArm->set(u8"id", u8"j2b:PistonArm");
-              pistonArm->set(u8"isMovable", Bool(false));
-              pistonArm->set(u8"x", Int(pos.fX));
-              pistonArm->set(u8"y", Int(pos.fY));
-              pistonArm->set(u8"z", Int(pos.fZ));
-
-              tileEntityReplacement[pos] = pistonArm;
-            } else {
-              // Tile entity doesn't exist at piston_head position.
-              // This means the piston is in static state.
-              bool extended = block->property(u8"extended", u8"false") == u8"true";
-              auto pistonArm = Compound();
-              pistonArm->set(u8"AttachedBlocks", List<Tag::Type::Int>());
-              pistonArm->set(u8"BreakBlocks", List<Tag::Type::Int>());
-              pistonArm->set(u8"LastProgress", Float(extended ? 1 : 0));
-              pistonArm->set(u8"NewState", Byte(extended ? 2 : 0));
-              pistonArm->set(u8"Progress", Float(extended ? 1 : 0));
-              pistonArm->set(u8"State", Byte(extended ? 2 : 0));
-              pistonArm->set(u8"Sticky", Bool(block->fName == u8"minecraft:sticky_piston"));
-              pistonArm->set(u8"id", u8"j2b:PistonArm");
-              pistonArm->set(u8"isMovable", Bool(extended ? false : true));
-              pistonArm->set(u8"x", Int(pos.fX));
-              pistonArm->set(u8"y", Int(pos.fY));
-              pistonArm->set(u8"z", Int(pos.fZ));
-
-              tileEntityReplacement[pos] = pistonArm;
-            }
+      auto pistons = PaletteScan::Find(chunk, [](Block const &b) {
+        return b.fName == u8"minecraft:sticky_piston" || b.fName == u8"minecraft:piston";
+      });
+      for (auto const &found : pistons) {
+        Pos3i const &pos = found.fPos;
+        auto const &block = found.fBlock;
+        if (loader.tileEntityAt(pos)) {
+          continue;
+        }
+        Facing6 f6 = Facing6FromJavaName(block->property(u8"facing", u8""));
+        Pos3i vec = Pos3iFromFacing6(f6);
+        Pos3i pistonHeadPos = pos + vec;
+        int facingDirectionB = BedrockFacingDirectionBFromFacing6(f6);
+        auto pistonHeadTileEntity = loader.tileEntityAt(pistonHeadPos);
+        if (pistonHeadTileEntity) {
+          auto pistonHead = PistonTileEntity::From(pistonHeadTileEntity, pistonHeadPos);
+          if (!pistonHead) {
+            continue;
+          }
+          if (!pistonHead->fSource || !pistonHead->fExtending || pistonHead->fFacing != facingDirectionB) {
+            continue;
           }
+
+          unordered_set<Pos3i, Pos3iHasher> attachedBlocks;
+          LookupAttachedBlocks(loader, pistonHeadPos, true, facingDirectionB, attachedBlocks);
+
+          auto progressJ = pistonHeadTileEntity->float32(u8"progress", 0);
+          float lastProgressB = progressJ;
+          float progressB = progressJ > 0 ? 0 : 0.5f;
+
+          auto pistonArm = Compound();
+          auto attachedBlocksTag = List<Tag::Type::Int>();
+          for (auto attachedBlock : attachedBlocks) {
+            Pos3i actual = attachedBlock - vec;
+            attachedBlocksTag->push_back(Int(actual.fX));
+            attachedBlocksTag->push_back(Int(actual.fY));
+            attachedBlocksTag->push_back(Int(actual.fZ));
+          }
+          pistonArm->set(u8"AttachedBlocks", attachedBlocksTag);
+          pistonArm->set(u8"BreakBlocks", List<Tag::Type::Int>());
+          pistonArm->set(u8"LastProgress", Float(lastProgressB));
+          pistonArm->set(u8"NewState", Byte(1));
+          pistonArm->set(u8"Progress", Float(progressB));
+          pistonArm->set(u8"State", Byte(1));
+          pistonArm->set(u8"Sticky", Bool(block->fName == u8"minecraft:sticky_piston"));
+          pistonArm->set(u8"id", u8"j2b:PistonArm");
+          pistonArm->set(u8"isMovable", Bool(false));
+          pistonArm->set(u8"x", Int(pos.fX));
+          pistonArm->set(u8"y", Int(pos.fY));
+          pistonArm->set(u8"z", Int(pos.fZ));
+
+          tileEntityReplacement[pos] = pistonArm;
+        } else {
+          // Tile entity doesn't exist at piston_head position.
+          // This means the piston is in static state.
+          bool extended = block->property(u8"extended", u8"false") == u8"true";
+          auto pistonArm = Compound();
+          pistonArm->set(u8"AttachedBlocks", List<Tag::Type::Int>());
+          pistonArm->set(u8"BreakBlocks", List<Tag::Type::Int>());
+          pistonArm->set(u8"LastProgress", Float(extended ? 1 : 0));
+          pistonArm->set(u8"NewState", Byte(extended ? 2 : 0));
+          pistonArm->set(u8"Progress", Float(extended ? 1 : 0));
+          pistonArm->set(u8"State", Byte(extended ? 2 : 0));
+          pistonArm->set(u8"Sticky", Bool(block->fName == u8"minecraft:sticky_piston"));
+          pistonArm->set(u8"id", u8"j2b:PistonArm");
+          pistonArm->set(u8"isMovable", Bool(extended ? false : true));
+          pistonArm->set(u8"x", Int(pos.fX));
+          pistonArm->set(u8"y", Int(pos.fY));
+          pistonArm->set(u8"z", Int(pos.fZ));
+
+          tileEntityReplacement[pos] = pistonArm;
         }
       }
     }
@@ -492,23 +486,9 @@ private:
   }
 
   static bool ChunkHasPiston(mcfile::je::Chunk const &chunk) {
-    for (auto const &section : chunk.fSections) {
-      if (!section) {
-        continue;
-      }
-      bool has = false;
-      section->eachBlockPalette([&has](std::shared_ptr<mcfile::je::Block const> const &b, size_t) {
-        if (b->fName == u8"minecraft:sticky_piston" || b->fName == u8"minecraft:piston" || b->fName == u8"minecraft:moving_piston") {
-          has = true;
-          return false;
-        }
-        return true;
-      });
-      if (has) {
-        return true;
-      }
-    }
-    return false;
+    return PaletteScan::Contains(chunk, [](mcfile::je::Block const &b) {
+      return b.fName == u8"minecraft:sticky_piston" || b.fName == u8"minecraft:piston" || b.fName == u8"minecraft:moving_piston";
+    });
   }
 };
 
@@ -3,9 +3,11 @@
 #include "_data-version.hpp"
 #include "java/_block-data.hpp"
 #include "java/_block-palette.hpp"
+#include "java/_block-state-cache.hpp"
 #include "java/_chunk-data-package.hpp"
 #include "java/_chunk-data.hpp"
 #include "java/_entity.hpp"
+#include "java/_palette-index-packer.hpp"
 #include "java/_tile-entity.hpp"
 #include "java/_world-data.hpp"
 
@@ -67,9 +69,9 @@ public:
       }
       section->eachBlockPalette([&palette, &wd, dataVersion](shared_ptr<mcfile::je::Block const> const &blockJ, size_t i) {
         using namespace mcfile::blocks::minecraft;
-        auto blockB = BlockData::From(blockJ, nullptr, dataVersion, {});
+        auto blockB = BlockStateCache::Get(blockJ, dataVersion);
         assert(blockB);
-        palette.append(blockB);
+        palette.append(blockB->fTag, shared_ptr<string const>(blockB, &blockB->fNbt));
         return true;
       });
       int j = 0;
@@ -166,7 +168,7 @@ public:
         palette.append(BlockData::Air());
       }
       if (airIndex != 0) {
-        palette[0].swap(palette[airIndex]);
+        palette.swap(0, airIndex);
         for (int i = 0; i < 4096; i++) {
           if (palette.fIndices[i] == 0) {
             palette.fIndices[i] = airIndex;
@@ -254,50 +256,39 @@ public:
       return JE2BE_ERROR;
     }
 
+    vector<u8> packed;
+
     {
       // layer 0
       int const numPaletteEntries = (int)palette.size();
       u8 bitsPerBlock;
-      int blocksPerWord;
       if (numPaletteEntries <= 2) {
         bitsPerBlock = 1;
-        blocksPerWord = 32;
       } else if (numPaletteEntries <= 4) {
         bitsPerBlock = 2;
-        blocksPerWord = 16;
       } else if (numPaletteEntries <= 8) {
         bitsPerBlock = 3;
-        blocksPerWord = 10;
       } else if (numPaletteEntries <= 16) {
         bitsPerBlock = 4;
-        blocksPerWord = 8;
       } else if (numPaletteEntries <= 32) {
         bitsPerBlock = 5;
-        blocksPerWord = 6;
       } else if (numPaletteEntries <= 64) {
         bitsPerBlock = 6;
-        blocksPerWord = 5;
       } else if (numPaletteEntries <= 256) {
         bitsPerBlock = 8;
-        blocksPerWord = 4;
       } else {
         bitsPerBlock = 16;
-        blocksPerWord = 2;
       }
 
       if (!w.write((u8)(bitsPerBlock * 2))) {
         return JE2BE_ERROR;
       }
-      u32 const mask = ~((~((u32)0)) << bitsPerBlock);
-      for (size_t i = 0; i < 4096; i += blocksPerWord) {
-        u32 v = 0;
-        for (size_t j = 0; j < blocksPerWord && i + j < 4096; j++) {
-          u32 const index = (u32)palette.fIndices[i + j];
-          v = v | ((mask & index) << (j * bitsPerBlock));
-        }
-        if (!w.write(v)) {
-          return JE2BE_ERROR;
-        }
+      packed.resize(PaletteIndexPacker::PackedSize(bitsPerBlock));
+      if (!PaletteIndexPacker::Pack(palette.fIndices.data(), bitsPerBlock, packed.data())) {
+        return JE2BE_ERROR;
+      }
+      if (!stream->write(packed.data(), packed.size())) {
+        return JE2BE_ERROR;
       }
 
       if (!w.write((u32)numPaletteEntries)) {
@@ -305,8 +296,11 @@ public:
       }
 
       for (int i = 0; i < palette.size(); i++) {
-        auto const &tag = palette[i];
-        if (!CompoundTag::Write(*tag, w)) {
+        auto serialized = palette.serializedAt(i);
+        if (!serialized) {
+          return JE2BE_ERROR;
+        }
+        if (!stream->write(serialized->data(), serialized->size())) {
           return JE2BE_ERROR;
         }
       }
@@ -316,7 +310,6 @@ public:
       // layer 1
       int const numPaletteEntries = 2; // air or water
       u8 bitsPerBlock = 1;
-      int blocksPerWord = 32;
 
       u32 const paletteAir = 0;
       u32 const paletteWater = 1;
@@ -324,16 +317,16 @@ public:
       if (!w.write((u8)(bitsPerBlock * 2))) {
         return JE2BE_ERROR;
       }
-      for (size_t i = 0; i < 4096; i += blocksPerWord) {
-        u32 v = 0;
-        for (size_t j = 0; j < blocksPerWord && i + j < 4096; j++) {
-          bool waterlogged = waterloggedIndices[i + j];
-          u32 const index = waterlogged ? paletteWater : paletteAir;
-          v = v | (index << (j * bitsPerBlock));
-        }
-        if (!w.write(v)) {
-          return JE2BE_ERROR;
-        }
+      vector<u16> indices(4096);
+      for (size_t i = 0; i < 4096; i++) {
+        indices[i] = (u16)(waterloggedIndices[i] ? paletteWater : paletteAir);
+      }
+      packed.resize(PaletteIndexPacker::PackedSize(bitsPerBlock));
+      if (!PaletteIndexPacker::Pack(indices.data(), bitsPerBlock, packed.data())) {
+        return JE2BE_ERROR;
+      }
+      if (!stream->write(packed.data(), packed.size())) {
+        return JE2BE_ERROR;
       }
 
       if (!w.write((u32)numPaletteEntries)) {
@@ -6,14 +6,17 @@ class BlockPalette {
 public:
   BlockPalette() : fIndices(4096, 0) {}
 
-  void append(CompoundTagPtr const &tag) {
+  // `serialized` is the little-endian NBT of `tag` if it is known, or nullptr
+  void append(CompoundTagPtr const &tag, std::shared_ptr<std::string const> const &serialized = nullptr) {
     fPalette.push_back(tag);
+    fSerialized.push_back(serialized);
   }
 
   void set(size_t idx, CompoundTagPtr const &tag) {
     u16 current = fIndices[idx];
     if (std::count(fIndices.begin(), fIndices.end(), current) == 1) {
       fPalette[current] = tag;
+      fSerialized[current] = nullptr;
     } else {
       int found = -1;
       for (int i = 0; i < fPalette.size(); i++) {
@@ -29,6 +32,7 @@ public:
         }
         fIndices[idx] = (uint16_t)s;
         fPalette.push_back(tag);
+        fSerialized.push_back(nullptr);
       } else {
         fIndices[idx] = found;
       }
@@ -43,15 +47,16 @@ public:
       return;
     }
     vector<CompoundTagPtr> palette;
+    vector<shared_ptr<string const>> serializedPalette;
     vector<u16> paletteMap;
     vector<u16> indices;
-    unordered_map<string, u16> lookup;
+    unordered_map<string_view, u16> lookup;
     for (size_t i = 0; i < fPalette.size(); i++) {
       auto block = fPalette[i];
       if (!block) [[unlikely]] {
         return;
       }
-      auto serialized = CompoundTag::Write(*block, mcfile::Encoding::LittleEndian);
+      shared_ptr<string const> serialized = serializedAt(i);
       if (!serialized) [[unlikely]] {
         return;
       }
@@ -64,6 +69,7 @@ public:
         paletteMap.push_back((u16)idx);
         lookup[*serialized] = (u16)idx;
         palette.push_back(block);
+        serializedPalette.push_back(serialized);
       } else {
         paletteMap.push_back(index->second);
       }
@@ -75,14 +81,38 @@ public:
       indices.push_back(mapped);
     }
     fPalette.swap(palette);
+    fSerialized.swap(serializedPalette);
     fIndices.swap(indices);
   }
 
-  CompoundTagPtr &operator[](size_t index) { return fPalette[index]; }
+  void swap(size_t a, size_t b) {
+    fPalette[a].swap(fPalette[b]);
+    fSerialized[a].swap(fSerialized[b]);
+  }
+
+  // Little-endian NBT of the palette entry at `index`, serialized here unless it was given
+  std::shared_ptr<std::string const> serializedAt(size_t index) const {
+    if (auto const &serialized = fSerialized[index]; serialized) {
+      return serialized;
+    }
+    auto const &tag = fPalette[index];
+    if (!tag) [[unlikely]] {
+      return nullptr;
+    }
+    auto serialized = CompoundTag::Write(*tag, mcfile::Encoding::LittleEndian);
+    if (!serialized) [[unlikely]] {
+      return nullptr;
+    }
+    return std::make_shared<std::string const>(std::move(*serialized));
+  }
+
   CompoundTagPtr const &operator[](size_t index) const { return fPalette[index]; }
 
   std::vector<CompoundTagPtr> fPalette;
   std::vector<u16> fIndices;
+
+private:
+  std::vector<std::shared_ptr<std::string const>> fSerialized;
 };
 
 } // namespace je2be::java
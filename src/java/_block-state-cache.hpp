@@ -0,0 +1,80 @@
+#pragma once
+
+#include <je2be/nbt.hpp>
+
+#include "_data-version.hpp"
+#include "java/_block-data.hpp"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace je2be::java {
+
+// Bedrock block states converted from Java block states (without tile entities), together with their little-endian NBT. Worlds
+// consist of a few hundred distinct block states, so most palette entries of a sub chunk are found here instead of being converted
+// and serialized again.
+// Each thread has its own cache, and the returned tags are shared by the sub chunks converted on the thread, so they must not be
+// modified.
+class BlockStateCache {
+  BlockStateCache() = delete;
+
+public:
+  struct Entry {
+    CompoundTagPtr fTag;
+    std::string fNbt;
+  };
+
+  // Same as BlockData::From(block, nullptr, dataVersion, {}), with the serialized tag
+  static std::shared_ptr<Entry const> Get(std::shared_ptr<mcfile::je::Block const> const &block, DataVersion const &dataVersion) {
+    using namespace std;
+    thread_local unordered_map<u8string, shared_ptr<Entry const>> tEntries;
+    thread_local i32 tTarget = dataVersion.fTarget;
+
+    if (!block) [[unlikely]] {
+      return Create(block, dataVersion);
+    }
+    if (tTarget != dataVersion.fTarget) [[unlikely]] {
+      tEntries.clear();
+      tTarget = dataVersion.fTarget;
+    }
+    // BlockData::From selects the conversion by fId, and unknown blocks sharing an id are told apart by their names
+    u8string key(sizeof(block->fId), u8'\0');
+    memcpy(key.data(), &block->fId, sizeof(block->fId));
+    key.append(block->fName);
+    key.append(block->fData);
+    if (auto found = tEntries.find(key); found != tEntries.end()) {
+      return found->second;
+    }
+    auto entry = Create(block, dataVersion);
+    if (!entry) [[unlikely]] {
+      return nullptr;
+    }
+    if (tEntries.size() >= kMaxEntries) {
+      // Entries in use are kept alive by their owners
+      tEntries.clear();
+    }
+    tEntries[key] = entry;
+    return entry;
+  }
+
+private:
+  static std::shared_ptr<Entry const> Create(std::shared_ptr<mcfile::je::Block const> const &block, DataVersion const &dataVersion) {
+    auto tag = BlockData::From(block, nullptr, dataVersion, {});
+    if (!tag) [[unlikely]] {
+      return nullptr;
+    }
+    auto nbt = CompoundTag::Write(*tag, mcfile::Encoding::LittleEndian);
+    if (!nbt) [[unlikely]] {
+      return nullptr;
+    }
+    auto entry = std::make_shared<Entry>();
+    entry->fTag = tag;
+    entry->fNbt.swap(*nbt);
+    return entry;
+  }
+
+private:
+  static constexpr size_t kMaxEntries = 8192;
+};
+
+} // namespace je2be::java
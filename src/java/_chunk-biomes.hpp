@@ -0,0 +1,144 @@
+#pragma once
+
+#include <minecraft-file.hpp>
+
+namespace je2be::java {
+
+// Builds the 3D biomes of Data2D from a Java chunk. Java stores biomes in 4x4x4 cells since 19w36a, so they are looked up once per
+// cell instead of once per block, and sections filled with one biome are written without looking at each block.
+class ChunkBiomes {
+  ChunkBiomes() = delete;
+
+public:
+  static int MinChunkY(mcfile::Dimension dim) {
+    if (dim == mcfile::Dimension::Overworld) {
+      return -4;
+    } else {
+      return 0;
+    }
+  }
+
+  static std::shared_ptr<mcfile::be::BiomeMap> Build(mcfile::je::Chunk const &chunk, mcfile::Dimension dim) {
+    using namespace std;
+    using namespace mcfile;
+    using namespace mcfile::be;
+    using namespace mcfile::biomes;
+
+    int const minChunkY = MinChunkY(dim);
+    int maxChunkY = minChunkY;
+    for (auto const &section : chunk.fSections) {
+      if (!section) {
+        continue;
+      }
+      maxChunkY = (std::max)(maxChunkY, section->y());
+    }
+
+    auto ret = make_shared<BiomeMap>(minChunkY, maxChunkY);
+    Cells cells;
+    if (minChunkY < chunk.chunkY()) {
+      // Extend BiomeMap below chunk.chunkY()
+
+      // Lookup most used biome in lowest chunk section
+      LookupCells(chunk, chunk.chunkY(), cells);
+      unordered_map<BiomeId, int> used;
+      for (int cy = 0; cy < 4; cy++) {
+        for (int cz = 0; cz < 4; cz++) {
+          for (int cx = 0; cx < 4; cx++) {
+            used[cells[cy][cz][cx]] += 1;
+          }
+        }
+      }
+      vector<pair<BiomeId, int>> sorted;
+      copy(used.begin(), used.end(), back_inserter(sorted));
+      stable_sort(sorted.begin(), sorted.end(), [](auto lhs, auto rhs) {
+        return lhs.second > rhs.second;
+      });
+
+      // Copy biome to below y < chunk.chunkY()
+      BiomeId biome;
+      if (sorted.empty()) {
+        if (dim == Dimension::Nether) {
+          biome = minecraft::nether_wastes;
+        } else if (dim == Dimension::End) {
+          biome = minecraft::the_end;
+        } else {
+          biome = minecraft::plains;
+        }
+      } else {
+        biome = sorted.front().first;
+      }
+      for (int cy = minChunkY; cy < chunk.chunkY(); cy++) {
+        FillSection(*ret, cy, biome);
+      }
+    }
+
+    if (chunk.getDataVersion() < kMinDataVersion3DBiomes) {
+      // Biomes are stored per column
+      int const x0 = chunk.minBlockX();
+      int const z0 = chunk.minBlockZ();
+      for (int cy = chunk.chunkY(); cy <= maxChunkY; cy++) {
+        for (int ly = 0; ly < 16; ly++) {
+          int by = ly + cy * 16;
+          for (int lz = 0; lz < 16; lz++) {
+            for (int lx = 0; lx < 16; lx++) {
+              ret->set(lx, by, lz, chunk.biomeAt(lx + x0, by, lz + z0));
+            }
+          }
+        }
+      }
+      return ret;
+    }
+
+    for (int cy = chunk.chunkY(); cy <= maxChunkY; cy++) {
+      LookupCells(chunk, cy, cells);
+      BiomeId const first = cells[0][0][0];
+      if (all_of(&cells[0][0][0], &cells[0][0][0] + 64, [first](BiomeId b) { return b == first; })) {
+        FillSection(*ret, cy, first);
+        continue;
+      }
+      for (int ly = 0; ly < 16; ly++) {
+        int by = ly + cy * 16;
+        for (int lz = 0; lz < 16; lz++) {
+          for (int lx = 0; lx < 16; lx++) {
+            ret->set(lx, by, lz, cells[ly / 4][lz / 4][lx / 4]);
+          }
+        }
+      }
+    }
+    return ret;
+  }
+
+private:
+  // Indexed by [y][z][x] of the cell in a chunk section
+  using Cells = mcfile::biomes::BiomeId[4][4][4];
+
+  static void LookupCells(mcfile::je::Chunk const &chunk, int chunkY, Cells &cells) {
+    int const x0 = chunk.minBlockX();
+    int const y0 = chunkY * 16;
+    int const z0 = chunk.minBlockZ();
+    for (int cy = 0; cy < 4; cy++) {
+      for (int cz = 0; cz < 4; cz++) {
+        for (int cx = 0; cx < 4; cx++) {
+          cells[cy][cz][cx] = chunk.biomeAt(x0 + cx * 4, y0 + cy * 4, z0 + cz * 4);
+        }
+      }
+    }
+  }
+
+  static void FillSection(mcfile::be::BiomeMap &map, int chunkY, mcfile::biomes::BiomeId biome) {
+    for (int ly = 0; ly < 16; ly++) {
+      int by = ly + chunkY * 16;
+      for (int lz = 0; lz < 16; lz++) {
+        for (int lx = 0; lx < 16; lx++) {
+          map.set(lx, by, lz, biome);
+        }
+      }
+    }
+  }
+
+private:
+  // 19w36a
+  static constexpr int kMinDataVersion3DBiomes = 2203;
+};
+
+} // namespace je2be::java
@@ -6,6 +6,8 @@
 
 #include <minecraft-file.hpp>
 
+#include <leveldb/write_batch.h>
+
 #include <cstdint>
 
 namespace je2be {
@@ -15,52 +17,44 @@ class ChunkData {
 public:
   ChunkData(i32 chunkX, i32 chunkZ, mcfile::Dimension dim, ChunkConversionMode mode, DataVersion const &dataVersion) : fChunkX(chunkX), fChunkZ(chunkZ), fDimension(dim), fMode(mode), fDataVersion(dataVersion) {}
 
+  // Writes all the records of the chunk with one DbInterface::write
   [[nodiscard]] Status put(DbInterface &db) {
-    auto [chunkStatus, status] = putChunkSections(db);
-    if (!status.ok()) {
-      return JE2BE_ERROR_PUSH(status);
+    leveldb::WriteBatch batch;
+    if (putChunkSections(batch) == ChunkStatus::NotEmpty) {
+      putVersion(batch);
+      putData2D(batch);
+      putBlockEntity(batch);
+      putFinalizedState(batch);
+      putPendingTicks(batch);
     }
-    if (chunkStatus == ChunkStatus::NotEmpty) {
-      if (auto st = putVersion(db); !st.ok()) {
-        return JE2BE_ERROR_PUSH(st);
-      }
-      if (auto st = putData2D(db); !st.ok()) {
-        return JE2BE_ERROR_PUSH(st);
-      }
-      if (auto st = putBlockEntity(db); !st.ok()) {
-        return JE2BE_ERROR_PUSH(st);
-      }
-      if (auto st = putFinalizedState(db); !st.ok()) {
-        return JE2BE_ERROR_PUSH(st);
-      }
-      return putPendingTicks(db);
-    } else {
-      return Status::Ok();
+    if (auto st = db.write(batch); !st.ok()) {
+      return JE2BE_ERROR_PUSH(st);
     }
+    return Status::Ok();
   }
 
 private:
-  Status putFinalizedState(DbInterface &db) const {
+  void putFinalizedState(leveldb::WriteBatch &batch) const {
     auto key = mcfile::be::DbKey::FinalizedState(fChunkX, fChunkZ, fDimension);
     if (fFinalizedState) {
       i32 v = *fFinalizedState;
-      return db.put(key, leveldb::Slice((char const *)&v, sizeof(v)));
+      batch.Put(key, leveldb::Slice((char const *)&v, sizeof(v)));
     } else {
-      return db.del(key);
+      batch.Delete(key);
     }
   }
 
-  Status putBlockEntity(DbInterface &db) const {
+  void putBlockEntity(leveldb::WriteBatch &batch) const {
     auto key = mcfile::be::DbKey::BlockEntity(fChunkX, fChunkZ, fDimension);
     if (fBlockEntity.empty()) {
-      return db.del(key);
+      batch.Delete(key);
     } else {
       leveldb::Slice blockEntity((char *)fBlockEntity.data(), fBlockEntity.size());
-      return db.put(key, blockEntity);
+      batch.Put(key, blockEntity);
     }
   }
 
-  Status putData2D(DbInterface &db) const {
+  void putData2D(leveldb::WriteBatch &batch) const {
     std::string key;
     switch (fMode) {
     case ChunkConversionMode::Legacy:
@@ -72,10 +66,10 @@ private:
       break;
     }
     if (fData2D.empty()) {
-      return db.del(key);
+      batch.Delete(key);
     } else {
       leveldb::Slice data2D((char *)fData2D.data(), fData2D.size());
-      return db.put(key, data2D);
+      batch.Put(key, data2D);
     }
   }
 
@@ -84,7 +78,7 @@ private:
     NotEmpty,
   };
 
-  std::pair<std::optional<ChunkStatus>, Status> putChunkSections(DbInterface &db) const {
+  ChunkStatus putChunkSections(leveldb::WriteBatch &batch) const {
     using namespace std;
     bool empty = true;
     for (auto const &it : fSubChunks) {
@@ -92,29 +86,25 @@ private:
       auto const &section = it.second;
       auto key = mcfile::be::DbKey::SubChunk(fChunkX, y, fChunkZ, fDimension);
       if (section.empty()) {
-        if (auto st = db.del(key); !st.ok()) {
-          return make_pair(nullopt, JE2BE_ERROR_PUSH(st));
-        }
+        batch.Delete(key);
       } else {
         leveldb::Slice subchunk((char *)section.data(), section.size());
-        if (auto st = db.put(key, subchunk); !st.ok()) {
-          return make_pair(nullopt, JE2BE_ERROR_PUSH(st));
-        }
+        batch.Put(key, subchunk);
         empty = false;
       }
     }
     if (empty) {
       if (fFinalizedState && *fFinalizedState == 2) {
-        return make_pair(ChunkStatus::NotEmpty, Status::Ok());
+        return ChunkStatus::NotEmpty;
       } else {
-        return make_pair(ChunkStatus::Empty, Status::Ok());
+        return ChunkStatus::Empty;
       }
     } else {
-      return make_pair(ChunkStatus::NotEmpty, Status::Ok());
+      return ChunkStatus::NotEmpty;
     }
   }
 
-  Status putVersion(DbInterface &db) const {
+  void putVersion(leveldb::WriteBatch &batch) const {
     auto const &versionKey = mcfile::be::DbKey::Version(fChunkX, fChunkZ, fDimension);
     uint8_t vernum;
     switch (fMode) {
@@ -128,20 +118,17 @@ private:
     }
 
     leveldb::Slice version((char const *)&vernum, sizeof(vernum));
-    if (auto st = db.put(versionKey, version); !st.ok()) {
-      return JE2BE_ERROR_PUSH(st);
-    }
-
-    return db.del(mcfile::be::DbKey::VersionLegacy(fChunkX, fChunkZ, fDimension));
+    batch.Put(versionKey, version);
+    batch.Delete(mcfile::be::DbKey::VersionLegacy(fChunkX, fChunkZ, fDimension));
   }
 
-  Status putPendingTicks(DbInterface &db) const {
+  void putPendingTicks(leveldb::WriteBatch &batch) const {
     auto key = mcfile::be::DbKey::PendingTicks(fChunkX, fChunkZ, fDimension);
     if (fPendingTicks.empty()) {
-      return db.del(key);
+      batch.Delete(key);
     } else {
       leveldb::Slice data((char *)fPendingTicks.data(), fPendingTicks.size());
-      return db.put(key, data);
+      batch.Put(key, data);
     }
   }
 
@@ -4,7 +4,9 @@
 #include <je2be/uuid.hpp>
 
 #include "_directory-iterator.hpp"
+#include "_file-sink.hpp"
 #include "_file.hpp"
+#include "_parallel.hpp"
 #include "_props.hpp"
 #include "command/_command.hpp"
 
@@ -17,7 +19,8 @@ public:
     int fVersion[3];
   };
 
-  static bool Import(std::filesystem::path jeRoot, std::filesystem::path beRoot) {
+  // Manifests are written while scanning the packs, and mcfunction files are converted afterwards in parallel
+  static bool Import(std::filesystem::path jeRoot, FileSink &sink, unsigned int concurrency) {
     using namespace std;
     namespace fs = std::filesystem;
     auto datapacks = jeRoot / "datapacks";
@@ -27,14 +30,21 @@ public:
     }
 
     std::vector<Pack> packs;
+    std::vector<Function> functions;
     for (DirectoryIterator itr(datapacks); itr.valid(); itr.next()) {
       if (!itr->is_directory()) {
         continue;
       }
-      if (!ImportPack(itr->path(), beRoot, packs)) {
+      if (!ImportPack(itr->path(), sink, packs, functions)) {
         return false;
       }
     }
+    auto st = Parallel::Process<Function>(functions, concurrency, [&sink](Function const &function) -> Status {
+      return ConvertFunction(function.fFrom, sink, function.fTo);
+    });
+    if (!st.ok()) {
+      return false;
+    }
     if (packs.empty()) {
       return true;
     }
@@ -52,20 +62,18 @@ public:
       json += u8"\xa";
     }
     json += u8"]\xa";
-    mcfile::ScopedFile fp(mcfile::File::Open(beRoot / "world_behavior_packs.json", mcfile::File::Mode::Write));
-    if (!fp) {
-      return false;
-    }
-    if (!mcfile::File::Fwrite(json.c_str(), json.size(), 1, fp.get())) {
-      return false;
-    }
-    return true;
+    return sink.write("world_behavior_packs.json", StringView(json), true).ok();
   }
 
 private:
   Datapacks() = delete;
 
-  static bool ImportPack(std::filesystem::path packRootDir, std::filesystem::path beRoot, std::vector<Pack> &packs) {
+  struct Function {
+    std::filesystem::path fFrom;
+    std::filesystem::path fTo;
+  };
+
+  static bool ImportPack(std::filesystem::path packRootDir, FileSink &sink, std::vector<Pack> &packs, std::vector<Function> &functions) {
     using namespace std;
     using namespace props;
 
@@ -73,18 +81,8 @@ private:
       return true;
     }
 
-    auto packsDir = beRoot / "behavior_packs";
-    if (!Fs::Exists(packsDir)) {
-      if (!Fs::CreateDirectories(packsDir)) {
-        return false;
-      }
-    }
-
     auto packName = packRootDir.filename();
-    auto packDir = packsDir / packName;
-    if (!Fs::CreateDirectories(packDir / "functions")) {
-      return false;
-    }
+    auto packDir = std::filesystem::path("behavior_packs") / packName;
 
     vector<pair<std::u8string, Uuid>> modules;
 
@@ -93,9 +91,6 @@ private:
         continue;
       }
       u8string moduleName = itr->path().filename().u8string();
-      if (!Fs::CreateDirectories(packDir / "functions" / moduleName)) {
-        return false;
-      }
       bool hasMcfunction = false;
       for (DirectoryIterator mcfunctionItr(itr->path() / "function"); mcfunctionItr.valid(); mcfunctionItr.next()) {
         if (!mcfunctionItr->is_regular_file()) {
@@ -110,10 +105,7 @@ private:
         if (!strings::Iequals(ext, ".mcfunction")) {
           continue;
         }
-        auto to = packDir / "functions" / moduleName / path.filename();
-        if (!ConvertFunction(path, to)) {
-          return false;
-        }
+        functions.push_back({path, packDir / "functions" / moduleName / path.filename()});
         hasMcfunction = true;
       }
       if (hasMcfunction) {
@@ -187,14 +179,7 @@ private:
     root["modules"] = modulesArray;
 
     u8string json = StringFromJson(root);
-    mcfile::ScopedFile fp(mcfile::File::Open(packDir / "manifest.json", mcfile::File::Mode::Write));
-    if (!fp) {
-      return false;
-    }
-    if (!mcfile::File::Fwrite(json.c_str(), json.size(), 1, fp.get())) {
-      return false;
-    }
-    return true;
+    return sink.write(packDir / "manifest.json", StringView(json), true).ok();
   }
 
   static std::optional<std::u8string> ReadDescriptionFromMcmeta(std::filesystem::path mcmeta) {
@@ -212,35 +197,36 @@ private:
     }
   }
 
-  static bool ConvertFunction(std::filesystem::path from, std::filesystem::path to) {
+  static Status ConvertFunction(std::filesystem::path const &from, FileSink &sink, std::filesystem::path const &to) {
     using namespace std;
-    using namespace mcfile;
 
-    if (Fs::Exists(to)) {
-      if (!Fs::Delete(to)) {
-        return false;
-      }
-    }
     vector<u8> buffer;
     if (!file::GetContents(from, buffer)) {
-      return false;
+      return JE2BE_ERROR;
     }
-    std::u8string content(buffer.begin(), buffer.end());
-    buffer.clear();
-    vector<u8string> lines = String::Split(content, u8'\x0a');
+    u8string_view content((char8_t const *)buffer.data(), buffer.size());
     u8string transpiled;
-    for (auto const &line : lines) {
+    transpiled.reserve(content.size());
+    u8string line;
+    size_t pos = 0;
+    while (pos < content.size()) {
+      size_t end = content.find(u8'\x0a', pos);
+      if (end == u8string_view::npos) {
+        end = content.size();
+      }
+      line.assign(content.substr(pos, end - pos));
       transpiled += command::Command::TranspileJavaToBedrock(line);
       transpiled += u8"\x0a";
+      pos = end + 1;
     }
-    ScopedFile fp(File::Open(to, File::Mode::Write));
-    if (!fp) {
-      return false;
+    if (auto st = sink.write(to, StringView(transpiled), true); !st.ok()) {
+      return JE2BE_ERROR_PUSH(st);
     }
-    if (!File::Fwrite(transpiled.c_str(), transpiled.size(), 1, fp.get())) {
-      return false;
-    }
-    return true;
+    return Status::Ok();
+  }
+
+  static std::string_view StringView(std::u8string const &s) {
+    return std::string_view((char const *)s.data(), s.size());
   }
 };
 
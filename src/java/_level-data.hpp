@@ -3,6 +3,7 @@
 #include <je2be/java/options.hpp>
 #include <je2be/status.hpp>
 
+#include "_parallel.hpp"
 #include "enums/_game-mode.hpp"
 #include "java/_context.hpp"
 #include "java/_java-edition-map.hpp"
@@ -34,19 +35,12 @@ public:
         fLodestones(std::make_shared<LodestoneRegistrar>()),
         fUuids(std::make_shared<UuidRegistrar>()) {}
 
-  [[nodiscard]] Status put(DbInterface &db, CompoundTag const &javaLevelData, std::shared_ptr<UuidRegistrar> const &uuids) {
+  [[nodiscard]] Status put(DbInterface &db, CompoundTag const &javaLevelData, std::shared_ptr<UuidRegistrar> const &uuids, unsigned int concurrency) {
     Status st;
     if (st = fPortals.putInto(db); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
-    st = fJavaEditionMap.each([this, &db](i32 mapId) {
-      auto found = fMapItems.find(mapId);
-      if (found == fMapItems.end()) {
-        return Status::Ok();
-      }
-      return Map::Convert(mapId, *found->second, fInput, fOptions, db);
-    });
-    if (!st.ok()) {
+    if (st = putMaps(db, concurrency); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
     if (st = putAutonomousEntities(db); !st.ok()) {
@@ -64,7 +58,7 @@ public:
       }
     }
 
-    if (st = fStructures.put(db); !st.ok()) {
+    if (st = fStructures.put(db, concurrency); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
 
@@ -83,6 +77,24 @@ public:
   }
 
 private:
+  [[nodiscard]] Status putMaps(DbInterface &db, unsigned int concurrency) {
+    using namespace std;
+    vector<pair<i32, CompoundTagPtr>> works;
+    auto st = fJavaEditionMap.each([this, &works](i32 mapId) {
+      if (auto found = fMapItems.find(mapId); found != fMapItems.end()) {
+        works.push_back(*found);
+      }
+      return Status::Ok();
+    });
+    if (!st.ok()) {
+      return JE2BE_ERROR_PUSH(st);
+    }
+    MapColorCache colorCache(MapColorCache::kDefaultCapacity);
+    return Parallel::Process<pair<i32, CompoundTagPtr>>(works, concurrency, [this, &colorCache, &db](pair<i32, CompoundTagPtr> const &work) {
+      return Map::Convert(work.first, *work.second, fInput, fOptions, colorCache, db);
+    });
+  }
+
   [[nodiscard]] Status putAutonomousEntities(DbInterface &db) {
     using namespace mcfile::stream;
 
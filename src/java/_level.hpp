@@ -1,5 +1,6 @@
 #pragma once
 
+#include "_file-sink.hpp"
 #include "_props.hpp"
 #include "_version.hpp"
 #include "enums/_game-mode.hpp"
@@ -256,8 +257,8 @@ public:
     return root;
   }
 
-  [[nodiscard]] bool write(std::filesystem::path path) const {
-    auto stream = std::make_shared<mcfile::stream::FileOutputStream>(path);
+  [[nodiscard]] bool write(FileSink &sink) const {
+    auto stream = std::make_shared<mcfile::stream::ByteStream>();
     mcfile::stream::OutputStreamWriter w(stream, mcfile::Encoding::LittleEndian);
     if (!w.write((u32)8)) {
       return false;
@@ -273,7 +274,12 @@ public:
     if (!stream->seek(4)) {
       return false;
     }
-    return w.write((u32)pos - 8);
+    if (!w.write((u32)pos - 8)) {
+      return false;
+    }
+    std::string contents;
+    stream->drain(contents);
+    return sink.write("level.dat", contents, true).ok();
   }
 
   static Level ImportFromJava(CompoundTag const &tag) {
@@ -3,6 +3,7 @@
 #include <je2be/nbt.hpp>
 
 #include "db/_db-interface.hpp"
+#include "item/_map-color-cache.hpp"
 
 namespace je2be::java {
 
@@ -15,7 +16,7 @@ class Map {
 public:
   static i64 UUID(i32 javaMapId, u8 scale);
 
-  static Status Convert(i32 javaMapId, CompoundTag const &item, std::filesystem::path const &input, Options const &opt, DbInterface &db);
+  static Status Convert(i32 javaMapId, CompoundTag const &item, std::filesystem::path const &input, Options const &opt, MapColorCache &colorCache, DbInterface &db);
 };
 
 } // namespace je2be::java
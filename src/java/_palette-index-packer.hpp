@@ -0,0 +1,207 @@
+#pragma once
+
+#include <je2be/integers.hpp>
+
+#if defined(__AVX2__)
+#define JE2BE_PALETTE_INDEX_PACKER_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JE2BE_PALETTE_INDEX_PACKER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+
+namespace je2be::java {
+
+// Packs the 4096 palette indices of a Bedrock block storage into its u32 words. Each word holds 32 / bitsPerBlock indices from
+// the least significant bit, leaving the remaining upper bits zero, and is written in little endian. Indices are masked to
+// bitsPerBlock bits.
+class PaletteIndexPacker {
+  PaletteIndexPacker() = delete;
+
+public:
+  static constexpr size_t kNumIndices = 4096;
+
+  static size_t PackedSize(int bitsPerBlock) {
+    size_t perWord = 32 / bitsPerBlock;
+    return (kNumIndices + perWord - 1) / perWord * sizeof(u32);
+  }
+
+  // `out` must have PackedSize(bitsPerBlock) bytes. Returns false if bitsPerBlock is not one of the widths Bedrock uses.
+  static bool Pack(u16 const *indices, int bitsPerBlock, u8 *out) {
+    switch (bitsPerBlock) {
+    case 1:
+      PackPowerOfTwo<1>(indices, out);
+      return true;
+    case 2:
+      PackPowerOfTwo<2>(indices, out);
+      return true;
+    case 3:
+      PackScalar<3>(indices, out);
+      return true;
+    case 4:
+      PackPowerOfTwo<4>(indices, out);
+      return true;
+    case 5:
+      PackScalar<5>(indices, out);
+      return true;
+    case 6:
+      PackScalar<6>(indices, out);
+      return true;
+    case 8:
+      PackPowerOfTwo<8>(indices, out);
+      return true;
+    case 16:
+      PackPowerOfTwo<16>(indices, out);
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  // Same as Pack, without using SIMD instructions
+  static bool PackScalar(u16 const *indices, int bitsPerBlock, u8 *out) {
+    switch (bitsPerBlock) {
+    case 1:
+      PackScalar<1>(indices, out);
+      return true;
+    case 2:
+      PackScalar<2>(indices, out);
+      return true;
+    case 3:
+      PackScalar<3>(indices, out);
+      return true;
+    case 4:
+      PackScalar<4>(indices, out);
+      return true;
+    case 5:
+      PackScalar<5>(indices, out);
+      return true;
+    case 6:
+      PackScalar<6>(indices, out);
+      return true;
+    case 8:
+      PackScalar<8>(indices, out);
+      return true;
+    case 16:
+      PackScalar<16>(indices, out);
+      return true;
+    default:
+      return false;
+    }
+  }
+
+private:
+  template <int Bits>
+  static void PackScalar(u16 const *indices, u8 *out) {
+    constexpr size_t kPerWord = 32 / Bits;
+    constexpr size_t kNumFullWords = kNumIndices / kPerWord;
+    constexpr u32 kMask = ~((~((u32)0)) << Bits);
+    for (size_t w = 0; w < kNumFullWords; w++) {
+      u32 v = 0;
+      for (size_t j = 0; j < kPerWord; j++) {
+        v |= (kMask & (u32)indices[j]) << (j * Bits);
+      }
+      StoreU32(v, out);
+      indices += kPerWord;
+      out += sizeof(u32);
+    }
+    if constexpr (kNumIndices % kPerWord != 0) {
+      u32 v = 0;
+      for (size_t j = 0; j < kNumIndices % kPerWord; j++) {
+        v |= (kMask & (u32)indices[j]) << (j * Bits);
+      }
+      StoreU32(v, out);
+    }
+  }
+
+  // Widths dividing 32 leave no padding in the words, so the output is a continuous bit stream: index i is at bits
+  // [i * Bits, (i + 1) * Bits) of it.
+  template <int Bits>
+  static void PackPowerOfTwo(u16 const *indices, u8 *out) {
+#if defined(JE2BE_PALETTE_INDEX_PACKER_AVX2)
+    if constexpr (Bits == 16) {
+      // Masking 16 bit indices with 0xffff is no-op, and x86 is little endian
+      std::memcpy(out, indices, kNumIndices * sizeof(u16));
+    } else {
+      constexpr size_t kIndicesPerStore = 256 / Bits;
+      for (size_t i = 0; i < kNumIndices; i += kIndicesPerStore) {
+        _mm256_storeu_si256((__m256i *)(out + i * Bits / 8), Avx2Fields<Bits, 8>(indices + i));
+      }
+    }
+#elif defined(JE2BE_PALETTE_INDEX_PACKER_SSE2)
+    if constexpr (Bits == 16) {
+      std::memcpy(out, indices, kNumIndices * sizeof(u16));
+    } else {
+      constexpr size_t kIndicesPerStore = 128 / Bits;
+      for (size_t i = 0; i < kNumIndices; i += kIndicesPerStore) {
+        _mm_storeu_si128((__m128i *)(out + i * Bits / 8), Sse2Fields<Bits, 8>(indices + i));
+      }
+    }
+#else
+    PackScalar<Bits>(indices, out);
+#endif
+  }
+
+#if defined(JE2BE_PALETTE_INDEX_PACKER_AVX2)
+  // 32 bytes, each of them holding Field / Bits indices packed from the least significant bit. Reads 32 * Field / Bits indices.
+  template <int Bits, int Field>
+  static __m256i Avx2Fields(u16 const *indices) {
+    if constexpr (Field == Bits) {
+      __m256i const mask = _mm256_set1_epi16((1 << Bits) - 1);
+      __m256i lo = _mm256_and_si256(_mm256_loadu_si256((__m256i const *)indices), mask);
+      __m256i hi = _mm256_and_si256(_mm256_loadu_si256((__m256i const *)(indices + 16)), mask);
+      // packus works on each 128 bit lane separately, so the 64 bit quarters are put back in order
+      return _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8);
+    } else {
+      constexpr int kHalf = Field / 2;
+      __m256i a = Avx2Merge<kHalf>(Avx2Fields<Bits, kHalf>(indices));
+      __m256i b = Avx2Merge<kHalf>(Avx2Fields<Bits, kHalf>(indices + 32 * kHalf / Bits));
+      return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8);
+    }
+  }
+
+  // Combines the Field-bit groups in the two bytes of each 16 bit lane into its lower byte
+  template <int Field>
+  static __m256i Avx2Merge(__m256i v) {
+    __m256i merged = _mm256_or_si256(v, _mm256_srli_epi16(v, 8 - Field));
+    return _mm256_and_si256(merged, _mm256_set1_epi16((1 << (2 * Field)) - 1));
+  }
+#elif defined(JE2BE_PALETTE_INDEX_PACKER_SSE2)
+  // 16 bytes, each of them holding Field / Bits indices packed from the least significant bit. Reads 16 * Field / Bits indices.
+  template <int Bits, int Field>
+  static __m128i Sse2Fields(u16 const *indices) {
+    if constexpr (Field == Bits) {
+      __m128i const mask = _mm_set1_epi16((1 << Bits) - 1);
+      __m128i lo = _mm_and_si128(_mm_loadu_si128((__m128i const *)indices), mask);
+      __m128i hi = _mm_and_si128(_mm_loadu_si128((__m128i const *)(indices + 8)), mask);
+      return _mm_packus_epi16(lo, hi);
+    } else {
+      constexpr int kHalf = Field / 2;
+      __m128i a = Sse2Merge<kHalf>(Sse2Fields<Bits, kHalf>(indices));
+      __m128i b = Sse2Merge<kHalf>(Sse2Fields<Bits, kHalf>(indices + 16 * kHalf / Bits));
+      return _mm_packus_epi16(a, b);
+    }
+  }
+
+  // Combines the Field-bit groups in the two bytes of each 16 bit lane into its lower byte
+  template <int Field>
+  static __m128i Sse2Merge(__m128i v) {
+    __m128i merged = _mm_or_si128(v, _mm_srli_epi16(v, 8 - Field));
+    return _mm_and_si128(merged, _mm_set1_epi16((1 << (2 * Field)) - 1));
+  }
+#endif
+
+  static void StoreU32(u32 v, u8 *out) {
+    out[0] = (u8)v;
+    out[1] = (u8)(v >> 8);
+    out[2] = (u8)(v >> 16);
+    out[3] = (u8)(v >> 24);
+  }
+};
+
+} // namespace je2be::java
+
+#undef JE2BE_PALETTE_INDEX_PACKER_AVX2
+#undef JE2BE_PALETTE_INDEX_PACKER_SSE2
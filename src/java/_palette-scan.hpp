@@ -0,0 +1,84 @@
+#pragma once
+
+#include <minecraft-file.hpp>
+
+#include "_pos3.hpp"
+
+namespace je2be::java {
+
+// Finds blocks in a chunk through the palettes of its sections. `match` is called once per palette entry instead of once per
+// block: sections having no matching entry are skipped, and the blocks of the other sections are compared by palette index.
+class PaletteScan {
+  PaletteScan() = delete;
+
+public:
+  struct Found {
+    Pos3i fPos;
+    std::shared_ptr<mcfile::je::Block const> fBlock;
+  };
+
+  static bool Contains(mcfile::je::Chunk const &chunk, std::function<bool(mcfile::je::Block const &)> const &match) {
+    using namespace std;
+    for (auto const &section : chunk.fSections) {
+      if (!section) {
+        continue;
+      }
+      bool found = false;
+      section->eachBlockPalette([&found, &match](shared_ptr<mcfile::je::Block const> const &block, size_t) {
+        if (block && match(*block)) {
+          found = true;
+          return false;
+        }
+        return true;
+      });
+      if (found) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // All the matching blocks of `chunk`, from the bottom section to the top one. The result is collected before returning, so the
+  // chunk can be modified while it is being processed.
+  static std::vector<Found> Find(mcfile::je::Chunk const &chunk, std::function<bool(mcfile::je::Block const &)> const &match) {
+    using namespace std;
+    vector<Found> ret;
+    for (auto const &section : chunk.fSections) {
+      if (!section) {
+        continue;
+      }
+      vector<shared_ptr<mcfile::je::Block const>> matched;
+      bool found = false;
+      section->eachBlockPalette([&matched, &found, &match](shared_ptr<mcfile::je::Block const> const &block, size_t index) {
+        if (block && match(*block)) {
+          if (matched.size() <= index) {
+            matched.resize(index + 1);
+          }
+          matched[index] = block;
+          found = true;
+        }
+        return true;
+      });
+      if (!found) {
+        continue;
+      }
+      int const x0 = chunk.fChunkX * 16;
+      int const y0 = section->y() * 16;
+      int const z0 = chunk.fChunkZ * 16;
+      for (int y = 0; y < 16; y++) {
+        for (int z = 0; z < 16; z++) {
+          for (int x = 0; x < 16; x++) {
+            auto index = section->blockPaletteIndexAt(x, y, z);
+            if (!index || *index < 0 || matched.size() <= *index || !matched[*index]) {
+              continue;
+            }
+            ret.push_back({Pos3i(x0 + x, y0 + y, z0 + z), matched[*index]});
+          }
+        }
+      }
+    }
+    return ret;
+  }
+};
+
+} // namespace je2be::java
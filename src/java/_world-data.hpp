@@ -71,9 +71,7 @@ public:
     for (auto const &pos : fEndPortalsInEndDimension) {
       wd.fEndPortalsInEndDimension.insert(pos);
     }
-    for (StructurePiece const &p : fStructures) {
-      wd.fStructures.add(p, fDim);
-    }
+    wd.fStructures.drain(fStructures, fDim);
     if (!wd.fError && fError) {
       wd.fError = fError;
     }
@@ -106,9 +104,7 @@ public:
     }
     unordered_set<Pos3i, Pos3iHasher>().swap(fEndPortalsInEndDimension);
 
-    for (auto const &piece : fStructures) {
-      out.fStructures.add(piece);
-    }
+    fStructures.drain(out.fStructures);
     if (!out.fError && fError) {
       out.fError = fError;
     }
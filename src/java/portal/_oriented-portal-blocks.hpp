@@ -4,104 +4,105 @@
 
 namespace je2be::java {
 
+// Portal blocks of one axis. Blocks are collected unordered, and sorted once by extract: each plane is then a sequence of rows, and
+// each row a sequence of runs along the axis. A portal is a run extended upward by the runs having the same extent.
 class OrientedPortalBlocks {
 public:
   explicit OrientedPortalBlocks(bool xAxis) : fXAxis(xAxis) {}
 
-  void add(int x, int y, int z) { fBlocks.emplace(x, y, z); }
+  void add(int x, int y, int z) { fBlocks.emplace_back(x, y, z); }
 
   void extract(std::vector<Portal> &buffer, mcfile::Dimension dim) {
-    while (!fBlocks.empty()) {
-      Pos3i start = *fBlocks.begin();
-      Pos3i bottomNorthWest = lookupBottomNorthWestCorner(start);
-      Pos3i topSouthEast = lookupTopSouthEastCorner(start);
-      for (int x = bottomNorthWest.fX; x <= topSouthEast.fX; x++) {
-        for (int z = bottomNorthWest.fZ; z <= topSouthEast.fZ; z++) {
-          for (int y = bottomNorthWest.fY; y <= topSouthEast.fY; y++) {
-            Pos3i p(x, y, z);
-            fBlocks.erase(p);
-          }
-        }
+    using namespace std;
+    vector<Block> blocks;
+    blocks.reserve(fBlocks.size());
+    for (Pos3i const &p : fBlocks) {
+      if (fXAxis) {
+        blocks.push_back({p.fZ, p.fY, p.fX});
+      } else {
+        blocks.push_back({p.fX, p.fY, p.fZ});
       }
-      u8 span = (u8)(std::max(topSouthEast.fX - bottomNorthWest.fX, topSouthEast.fZ - bottomNorthWest.fZ) + 1);
-      Portal portal((i32)dim, span, bottomNorthWest.fX, bottomNorthWest.fY, bottomNorthWest.fZ, fXAxis ? 1 : 0, fXAxis ? 0 : 1);
-      buffer.push_back(portal);
     }
-  }
+    vector<Pos3i>().swap(fBlocks);
+    sort(blocks.begin(), blocks.end());
+    blocks.erase(unique(blocks.begin(), blocks.end()), blocks.end());
 
-  void drain(OrientedPortalBlocks &out) {
-    assert(out.fXAxis == fXAxis);
-    for (auto b : fBlocks) {
-      out.fBlocks.insert(b);
+    vector<Run> runs;
+    for (size_t i = 0; i < blocks.size();) {
+      Block const &b = blocks[i];
+      size_t j = i + 1;
+      while (j < blocks.size() && blocks[j].fPlane == b.fPlane && blocks[j].fY == b.fY && blocks[j].fAlong == blocks[j - 1].fAlong + 1) {
+        j++;
+      }
+      runs.push_back({b.fPlane, b.fY, b.fAlong, blocks[j - 1].fAlong, false});
+      i = j;
     }
-    std::unordered_set<Pos3i, Pos3iHasher>().swap(fBlocks);
-  }
 
-private:
-  Pos3i lookupBottomNorthWestCorner(Pos3i start) {
-    if (fXAxis) {
-      return lookupCorner<-1, -1, 0>(start);
-    } else {
-      return lookupCorner<0, -1, -1>(start);
+    for (size_t i = 0; i < runs.size(); i++) {
+      Run &run = runs[i];
+      if (run.fConsumed) {
+        continue;
+      }
+      run.fConsumed = true;
+      int y = run.fY;
+      while (true) {
+        // Runs are sorted by (plane, y, begin), so the run above starting at the same position is found by binary search
+        Run key{run.fPlane, y + 1, run.fBegin, run.fBegin, false};
+        auto above = lower_bound(runs.begin() + i + 1, runs.end(), key, [](Run const &lhs, Run const &rhs) {
+          return tie(lhs.fPlane, lhs.fY, lhs.fBegin) < tie(rhs.fPlane, rhs.fY, rhs.fBegin);
+        });
+        if (above == runs.end() || above->fPlane != run.fPlane || above->fY != y + 1 || above->fBegin != run.fBegin || above->fEnd != run.fEnd || above->fConsumed) {
+          break;
+        }
+        above->fConsumed = true;
+        y++;
+      }
+      u8 span = (u8)(run.fEnd - run.fBegin + 1);
+      if (fXAxis) {
+        buffer.push_back(Portal((i32)dim, span, run.fBegin, run.fY, run.fPlane, 1, 0));
+      } else {
+        buffer.push_back(Portal((i32)dim, span, run.fPlane, run.fY, run.fBegin, 0, 1));
+      }
     }
   }
 
-  Pos3i lookupTopSouthEastCorner(Pos3i start) {
-    if (fXAxis) {
-      return lookupCorner<1, 1, 0>(start);
+  void drain(OrientedPortalBlocks &out) {
+    assert(out.fXAxis == fXAxis);
+    if (out.fBlocks.empty()) {
+      out.fBlocks.swap(fBlocks);
     } else {
-      return lookupCorner<0, 1, 1>(start);
+      out.fBlocks.insert(out.fBlocks.end(), fBlocks.begin(), fBlocks.end());
     }
+    std::vector<Pos3i>().swap(fBlocks);
   }
 
-  template <int dx, int dy, int dz>
-  Pos3i lookupCorner(Pos3i p) {
-    int const x0 = p.fX;
-    int const y0 = p.fY;
-    int const z0 = p.fZ;
-    int currentX = x0;
-    int currentY = y0;
-    int currentZ = z0;
-    int width = 1;
-    int height = 1;
-    while (true) {
-      bool expandVertical = true;
-      for (int xz = 0; xz < width; xz++) {
-        Pos3i test(x0 + dx * xz, currentY + dy, z0 + dz * xz);
-        if (fBlocks.find(test) == fBlocks.end()) {
-          expandVertical = false;
-          break;
-        }
-      }
-      if (expandVertical) {
-        currentY += dy;
-        height++;
-      }
+private:
+  // Position of a block, with its coordinate perpendicular to the portal plane first
+  struct Block {
+    int fPlane;
+    int fY;
+    int fAlong;
 
-      bool expandHorizontal = true;
-      for (int y = 0; y < height; y++) {
-        Pos3i test(currentX + dx, y0 + dy * y, currentZ + dz);
-        if (fBlocks.find(test) == fBlocks.end()) {
-          expandHorizontal = false;
-          break;
-        }
-      }
-      if (!expandVertical && !expandHorizontal) {
-        break;
-      }
+    bool operator<(Block const &other) const {
+      return std::tie(fPlane, fY, fAlong) < std::tie(other.fPlane, other.fY, other.fAlong);
+    }
 
-      if (expandHorizontal) {
-        width++;
-        currentX += dx;
-        currentZ += dz;
-      }
+    bool operator==(Block const &other) const {
+      return fPlane == other.fPlane && fY == other.fY && fAlong == other.fAlong;
     }
-    return Pos3i(currentX, currentY, currentZ);
-  }
+  };
+
+  struct Run {
+    int fPlane;
+    int fY;
+    int fBegin;
+    int fEnd;
+    bool fConsumed;
+  };
 
 private:
   bool fXAxis;
-  std::unordered_set<Pos3i, Pos3iHasher> fBlocks;
+  std::vector<Pos3i> fBlocks;
 };
 
 } // namespace je2be::java
@@ -1,83 +1,67 @@
 #pragma once
 
+#include "_parallel.hpp"
 #include "structure/_structure-piece.hpp"
 
 namespace je2be::java {
 
+// Structure pieces of a dimension, bucketed by the chunks they intersect. Pieces are split into chunks when they are added, so the
+// buckets are built by the threads converting chunks, and only merged afterwards.
 class StructurePieceCollection {
 public:
-  void add(StructurePiece const &p) { fPieces.push_back(p); }
-
-  decltype(auto) begin() const { return fPieces.begin(); }
-
-  decltype(auto) end() const { return fPieces.end(); }
-
-  [[nodiscard]] Status put(DbInterface &db, mcfile::Dimension dim) {
-    using namespace std;
-    unordered_map<Pos3i, vector<StructurePiece>, Pos3iHasher> splitted;
-    for (auto const &it : fPieces) {
-      int minChunkX = mcfile::Coordinate::ChunkFromBlock(it.fVolume.fStart.fX);
-      int minChunkZ = mcfile::Coordinate::ChunkFromBlock(it.fVolume.fStart.fZ);
-      int maxChunkX = mcfile::Coordinate::ChunkFromBlock(it.fVolume.fEnd.fX);
-      int maxChunkZ = mcfile::Coordinate::ChunkFromBlock(it.fVolume.fEnd.fZ);
-      for (int cx = minChunkX; cx <= maxChunkX; cx++) {
-        for (int cz = minChunkZ; cz <= maxChunkZ; cz++) {
-          Volume chunkVolume(Pos3i(cx * 16, -64, cz * 16), Pos3i(cx * 16 + 15, 320, cz * 16 + 15));
-          auto intersection = Volume::Intersection(chunkVolume, it.fVolume);
-          if (intersection) {
-            Pos3i idx(cx, 0, cz);
-            StructurePiece p(intersection->fStart, intersection->fEnd, it.fType);
-            splitted[idx].push_back(p);
-          }
+  void add(StructurePiece const &p) {
+    int minChunkX = mcfile::Coordinate::ChunkFromBlock(p.fVolume.fStart.fX);
+    int minChunkZ = mcfile::Coordinate::ChunkFromBlock(p.fVolume.fStart.fZ);
+    int maxChunkX = mcfile::Coordinate::ChunkFromBlock(p.fVolume.fEnd.fX);
+    int maxChunkZ = mcfile::Coordinate::ChunkFromBlock(p.fVolume.fEnd.fZ);
+    for (int cx = minChunkX; cx <= maxChunkX; cx++) {
+      for (int cz = minChunkZ; cz <= maxChunkZ; cz++) {
+        Volume chunkVolume(Pos3i(cx * 16, -64, cz * 16), Pos3i(cx * 16 + 15, 320, cz * 16 + 15));
+        auto intersection = Volume::Intersection(chunkVolume, p.fVolume);
+        if (intersection) {
+          fChunks[Pos3i(cx, 0, cz)].push_back(StructurePiece(intersection->fStart, intersection->fEnd, p.fType));
         }
       }
     }
+  }
 
-    for (auto const &it : splitted) {
-      using namespace mcfile::stream;
-      auto s = std::make_shared<ByteStream>();
-      OutputStreamWriter w(s, mcfile::Encoding::LittleEndian);
-      if (!w.write((u32)it.second.size())) {
-        return JE2BE_ERROR;
-      }
-      for (auto const &piece : it.second) {
-        if (!w.write(piece.fVolume.fStart.fX)) {
-          return JE2BE_ERROR;
-        }
-        if (!w.write(piece.fVolume.fStart.fY)) {
-          return JE2BE_ERROR;
-        }
-        if (!w.write(piece.fVolume.fStart.fZ)) {
-          return JE2BE_ERROR;
-        }
-        if (!w.write(piece.fVolume.fEnd.fX)) {
-          return JE2BE_ERROR;
-        }
-        if (!w.write(piece.fVolume.fEnd.fY)) {
-          return JE2BE_ERROR;
-        }
-        if (!w.write(piece.fVolume.fEnd.fZ)) {
-          return JE2BE_ERROR;
-        }
-        if (!w.write((u8)piece.fType)) {
-          return JE2BE_ERROR;
-        }
+  void drain(StructurePieceCollection &out) {
+    if (out.fChunks.empty()) {
+      out.fChunks.swap(fChunks);
+    } else {
+      for (auto &it : fChunks) {
+        auto &pieces = out.fChunks[it.first];
+        pieces.insert(pieces.end(), it.second.begin(), it.second.end());
       }
-      vector<u8> buffer;
-      s->drain(buffer);
+    }
+    std::unordered_map<Pos3i, std::vector<StructurePiece>, Pos3iHasher>().swap(fChunks);
+  }
 
-      auto key = mcfile::be::DbKey::StructureBounds(it.first.fX, it.first.fZ, dim);
-      leveldb::Slice value((char const *)buffer.data(), buffer.size());
+  [[nodiscard]] Status put(DbInterface &db, mcfile::Dimension dim, unsigned int concurrency) const {
+    using namespace std;
+    vector<Pos3i> chunks;
+    chunks.reserve(fChunks.size());
+    for (auto const &it : fChunks) {
+      chunks.push_back(it.first);
+    }
+    return Parallel::Process<Pos3i>(chunks, concurrency, [this, &db, dim](Pos3i const &chunk) -> Status {
+      auto found = fChunks.find(chunk);
+      if (found == fChunks.end()) {
+        return JE2BE_ERROR;
+      }
+      string value;
+      StructurePiece::Write(found->second, value);
+      auto key = mcfile::be::DbKey::StructureBounds(chunk.fX, chunk.fZ, dim);
       if (auto st = db.put(key, value); !st.ok()) {
         return JE2BE_ERROR_PUSH(st);
       }
-    }
-
-    return Status::Ok();
+      return Status::Ok();
+    });
   }
 
 private:
-  std::vector<StructurePiece> fPieces;
+  // Pieces clipped to each chunk, keyed by (chunkX, 0, chunkZ)
+  std::unordered_map<Pos3i, std::vector<StructurePiece>, Pos3iHasher> fChunks;
 };
 
 } // namespace je2be::java
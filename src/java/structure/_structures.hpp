@@ -6,28 +6,28 @@ namespace je2be::java {
 
 class Structures {
 public:
-  void add(StructurePiece p, mcfile::Dimension dim) {
+  void drain(StructurePieceCollection &pieces, mcfile::Dimension dim) {
     switch (dim) {
     case mcfile::Dimension::Overworld:
-      fOverworld.add(p);
+      pieces.drain(fOverworld);
       break;
     case mcfile::Dimension::Nether:
-      fNether.add(p);
+      pieces.drain(fNether);
       break;
     case mcfile::Dimension::End:
-      fEnd.add(p);
+      pieces.drain(fEnd);
       break;
     }
   }
 
-  [[nodiscard]] Status put(DbInterface &db) {
-    if (auto st = fOverworld.put(db, mcfile::Dimension::Overworld); !st.ok()) {
+  [[nodiscard]] Status put(DbInterface &db, unsigned int concurrency) {
+    if (auto st = fOverworld.put(db, mcfile::Dimension::Overworld, concurrency); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
-    if (auto st = fNether.put(db, mcfile::Dimension::Nether); !st.ok()) {
+    if (auto st = fNether.put(db, mcfile::Dimension::Nether, concurrency); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
-    if (auto st = fEnd.put(db, mcfile::Dimension::End); !st.ok()) {
+    if (auto st = fEnd.put(db, mcfile::Dimension::End, concurrency); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
     return Status::Ok();
@@ -346,7 +346,41 @@ std::shared_ptr<mcfile::je::Block const> BlockData::unsafeToBlock() const {
   }
 }
 
-std::shared_ptr<mcfile::je::Block const> BlockData::toBlock() const {
+class BlockData::Impl {
+  Impl() = delete;
+
+public:
+  static std::vector<std::shared_ptr<mcfile::je::Block const>> *CreateBlockTable() {
+    using namespace std;
+    auto table = new vector<shared_ptr<mcfile::je::Block const>>(65536);
+    map<u8string, shared_ptr<mcfile::je::Block const>> interned;
+    for (int rawId = 0; rawId < 256; rawId++) {
+      for (int rawData = 0; rawData < 256; rawData++) {
+        auto block = BlockData(rawId, rawData).createBlock();
+        if (!block) {
+          continue;
+        }
+        u8string key = u8string(block->fName) + u8string(block->fData);
+        auto found = interned.find(key);
+        if (found == interned.end()) {
+          interned[key] = block;
+        } else {
+          block = found->second;
+        }
+        (*table)[(rawId << 8) | rawData] = block;
+      }
+    }
+    return table;
+  }
+};
+
+std::shared_ptr<mcfile::je::Block const> const &BlockData::toBlock() const {
+  using namespace std;
+  static unique_ptr<vector<shared_ptr<mcfile::je::Block const>> const> const sTable(Impl::CreateBlockTable());
+  return (*sTable)[((u16)fRawId << 8) | (u16)fRawData];
+}
+
+std::shared_ptr<mcfile::je::Block const> BlockData::createBlock() const {
   using namespace std;
   auto p = unsafeToBlock();
   if (p) {
@@ -3,12 +3,15 @@
 #include <je2be/lce/behavior.hpp>
 #include <je2be/nbt.hpp>
 
+#include <defer.hpp>
+
 #include "_data2d.hpp"
 #include "_data3d.hpp"
 #include "_mem.hpp"
 #include "_props.hpp"
 #include "lce/_biome.hpp"
 #include "lce/_block-data.hpp"
+#include "lce/_block-populator.hpp"
 #include "lce/_context.hpp"
 #include "lce/_entity.hpp"
 #include "lce/_grid.hpp"
@@ -26,7 +29,7 @@ class Chunk::Impl {
 
 public:
   static Status Convert(mcfile::Dimension dimension,
-                        std::filesystem::path const &region,
+                        mcfile::stream::InputStream &region,
                         int cx,
                         int cz,
                         std::shared_ptr<mcfile::je::WritableChunk> &result,
@@ -234,7 +237,7 @@ private:
   }
 
   static Status Extract(mcfile::Dimension dimension,
-                        std::filesystem::path const &region,
+                        mcfile::stream::InputStream &region,
                         int cx,
                         int cz,
                         std::shared_ptr<mcfile::je::WritableChunk> &result,
@@ -248,19 +251,21 @@ private:
     int localCx = cx - rx * 32;
     int localCz = cz - rz * 32;
 
-    auto f = make_shared<mcfile::stream::FileInputStream>(region);
-
-    vector<u8> buffer;
-    if (!Savegame::ExtractRawChunkFromRegionFile(*f, localCx, localCz, buffer)) {
+    ScratchBuffers &scratch = ThreadLocalScratchBuffers();
+    defer {
+      scratch.trim();
+    };
+    if (!Savegame::ExtractRawChunkFromRegionFile(region, localCx, localCz, scratch.fRaw)) {
       return JE2BE_ERROR;
     }
-    if (buffer.empty()) {
+    if (scratch.fRaw.empty()) {
       return Status::Ok();
     }
-    if (auto st = behavior.decompressChunk(buffer); !st.ok()) {
+    if (auto st = behavior.decompressChunk(scratch.fRaw, scratch.fDecompressed); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
-    Savegame::DecodeDecompressedChunk(buffer);
+    Savegame::DecodeDecompressedChunk(scratch.fDecompressed, scratch.fDecoded);
+    vector<u8> &buffer = scratch.fDecoded;
 
     if (buffer.size() < 2) {
       return JE2BE_ERROR;
@@ -312,6 +317,30 @@ private:
     }
   }
 
+  // Buffers used while extracting a chunk. They are kept per thread and reused for the following chunks, to avoid allocating
+  // three buffers for every chunk.
+  struct ScratchBuffers {
+    std::vector<u8> fRaw;
+    std::vector<u8> fDecompressed;
+    std::vector<u8> fDecoded;
+
+    void trim() {
+      // Don't keep the memory for an unusually large chunk
+      for (auto *buffer : {&fRaw, &fDecompressed, &fDecoded}) {
+        if (buffer->capacity() > kMaxRetainedBytes) {
+          std::vector<u8>().swap(*buffer);
+        }
+      }
+    }
+
+    static constexpr size_t kMaxRetainedBytes = 4 * 1024 * 1024;
+  };
+
+  static ScratchBuffers &ThreadLocalScratchBuffers() {
+    thread_local ScratchBuffers tBuffers;
+    return tBuffers;
+  }
+
   struct V8 {
     template <size_t BitPerBlock>
     static Status ParseGrid(
@@ -622,7 +651,7 @@ private:
       return JE2BE_ERROR_PUSH(st);
     }
 
-    PopulateBlocks(blockId, blockData, *chunk);
+    BlockPopulator::Populate(blockId, blockData, *chunk);
 
     if (buffer.size() < offset + 256) {
       return JE2BE_ERROR;
@@ -671,80 +700,6 @@ private:
     return Status::Ok();
   }
 
-  static void PopulateBlocks(Data3dSq<u8, 16> const &blockId,
-                             Data3dSq<u8, 16> const &blockData,
-                             mcfile::je::WritableChunk &chunk) {
-    using namespace std;
-    if (blockId.fStart != blockData.fStart) {
-      assert(false);
-      return;
-    }
-    if (blockId.fEnd != blockData.fEnd) {
-      assert(false);
-      return;
-    }
-    Pos3i origin(chunk.fChunkX * 16, 0, chunk.fChunkZ * 16);
-    for (int y = blockId.fStart.fY; y <= blockId.fEnd.fY; y++) {
-      for (int z = blockId.fStart.fZ; z <= blockId.fEnd.fZ; z++) {
-        for (int x = blockId.fStart.fX; x <= blockId.fEnd.fX; x++) {
-          u8 rawId = blockId[{x, y, z}];
-          u8 rawData = blockData[{x, y, z}];
-          BlockData bd(rawId, rawData);
-          u16 id = bd.id();
-          u8 data = bd.data();
-          shared_ptr<mcfile::je::Block const> block;
-          if (id == 175 && data == 10 && y - 1 >= 0) {
-            // upper half of tall flowers
-            u8 lowerId = blockId[{x, y - 1, z}];
-            u8 lowerData = blockData[{x, y - 1, z}];
-            if (auto lower = mcfile::je::Flatten::Block(lowerId, lowerData, chunk.getDataVersion()); lower) {
-              block = lower->applying({{u8"half", u8"upper"}});
-            }
-          } else if (id == 64) {
-            if (y - 1 >= 0) {
-              u8 lowerId = blockId[{x, y - 1, z}];
-              if (lowerId == 64) {
-                u8 lowerData = blockData[{x, y - 1, z}];
-                map<u8string, u8string> props;
-                mcfile::je::Flatten::Door(lowerData, props);
-                mcfile::je::Flatten::Door(data, props);
-                block = mcfile::je::Block::FromIdAndProperties(mcfile::blocks::minecraft::oak_door, Chunk::kTargetDataVersion, props);
-              }
-            }
-            if (!block && y + 1 < 256) {
-              u8 upperId = blockId[{x, y + 1, z}];
-              if (upperId == 64) {
-                u8 upperData = blockData[{x, y + 1, z}];
-                map<u8string, u8string> props;
-                mcfile::je::Flatten::Door(upperData, props);
-                mcfile::je::Flatten::Door(data, props);
-                block = mcfile::je::Block::FromIdAndProperties(mcfile::blocks::minecraft::oak_door, Chunk::kTargetDataVersion, props);
-              }
-            }
-            if (!block) {
-              block = bd.toBlock();
-            }
-          }
-          if (!block) {
-            block = bd.toBlock();
-          }
-          if (block) {
-            chunk.setBlockAt(origin + Pos3i{x, y, z}, block);
-          }
-          if (id == 26) {
-            // may be overwritten by ParseTileEntities later
-            auto tag = Compound();
-            tag->set(u8"id", u8"minecraft:bed");
-            tag->set(u8"x", Int(x));
-            tag->set(u8"y", Int(y));
-            tag->set(u8"z", Int(z));
-            chunk.fTileEntities[{x, y, z}] = tag;
-          }
-        }
-      }
-    }
-  }
-
   static Status ConvertV0(mcfile::Dimension dim,
                           int cx,
                           int cz,
@@ -828,7 +783,7 @@ private:
       }
     }
 
-    PopulateBlocks(blockId, blockData, *chunk);
+    BlockPopulator::Populate(blockId, blockData, *chunk);
 
     if (tileEntities) {
       ParseTileEntities(*tileEntities, *chunk, ctx);
@@ -1028,7 +983,7 @@ private:
       }
     }
 
-    PopulateBlocks(blockId, blockData, *chunk);
+    BlockPopulator::Populate(blockId, blockData, *chunk);
 
     int pos = maxSectionAddress + 0x4c;
     for (int i = 0; i < 4; i++) {
@@ -1158,7 +1113,7 @@ private:
 };
 
 Status Chunk::Convert(mcfile::Dimension dimension,
-                      std::filesystem::path const &region,
+                      mcfile::stream::InputStream &region,
                       int cx,
                       int cz,
                       std::shared_ptr<mcfile::je::WritableChunk> &result,
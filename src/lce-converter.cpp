@@ -7,19 +7,20 @@
 #include <je2be/zip-file.hpp>
 
 #include <defer.hpp>
+#include <zlib.h>
 
 #include "_dimension-ext.hpp"
-#include "_directory-iterator.hpp"
 #include "_file.hpp"
 #include "_java-level-dat.hpp"
 #include "_nbt-ext.hpp"
 #include "_nullable.hpp"
 #include "_props.hpp"
+#include "_span-input-stream.hpp"
 #include "bedrock/_constants.hpp"
 #include "lce/_chunk.hpp"
 #include "lce/_context.hpp"
 #include "lce/_entity.hpp"
-#include "lce/_savegame.hpp"
+#include "lce/_savegame-files.hpp"
 #include "lce/_tile-entity.hpp"
 #include "lce/_world.hpp"
 #include "xbox360/_save-bin.hpp"
@@ -39,27 +40,19 @@ public:
     using namespace std;
     namespace fs = std::filesystem;
 
-    auto tempRoot = options.getTempDirectory();
-    auto temp = mcfile::File::CreateTempDir(tempRoot);
-    if (!temp) {
-      return JE2BE_ERROR;
-    }
-    defer {
-      Fs::DeleteAll(*temp);
-    };
-
-    if (!Savegame::ExtractFilesFromDecompressedSavegame(inputSavegame, *temp)) {
+    auto files = SavegameFiles::Open(inputSavegame);
+    if (!files) {
       return JE2BE_ERROR;
     }
     Context ctx(TileEntity::Convert, Entity::MigrateName);
-    if (auto st = CopyMapFiles(*temp, outputDirectory); !st.ok()) {
+    if (auto st = CopyMapFiles(*files, outputDirectory); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
-    auto copyPlayersResult = CopyPlayers(*temp, outputDirectory, behavior, ctx, options);
+    auto copyPlayersResult = CopyPlayers(*files, outputDirectory, behavior, ctx, options);
     if (!copyPlayersResult) {
       return copyPlayersResult.status();
     }
-    if (auto st = CopyLevelDat(*temp, outputDirectory, options.fLastPlayed, copyPlayersResult->fLocalPlayer, ctx); !st.ok()) {
+    if (auto st = CopyLevelDat(*files, outputDirectory, options.fLastPlayed, copyPlayersResult->fLocalPlayer, ctx); !st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
     if (auto st = SetupResourcePack(outputDirectory); !st.ok()) {
@@ -78,7 +71,7 @@ public:
           continue;
         }
       }
-      if (auto st = World::Convert(*temp, outputDirectory, dimension, concurrency, behavior, ctx, options, progress, progressChunksOffset); !st.ok()) {
+      if (auto st = World::Convert(*files, outputDirectory, dimension, concurrency, behavior, ctx, options, progress, progressChunksOffset); !st.ok()) {
         return JE2BE_ERROR_PUSH(st);
       }
     }
@@ -96,7 +89,7 @@ private:
     std::shared_ptr<PlayerInfo> fLocalPlayer;
   };
 
-  static Nullable<CopyPlayersResult> CopyPlayers(std::filesystem::path const &inputDirectory,
+  static Nullable<CopyPlayersResult> CopyPlayers(SavegameFiles const &files,
                                                  std::filesystem::path const &outputDirectory,
                                                  Behavior const &behavior,
                                                  Context &ctx,
@@ -114,7 +107,7 @@ private:
     r.fLocalPlayer = nullptr;
 
     map<fs::path, CompoundTagPtr> tags;
-    if (auto st = behavior.loadPlayers(inputDirectory, tags); !st.ok()) {
+    if (auto st = behavior.loadPlayers(files, tags); !st.ok()) {
       return JE2BE_NULLABLE_NULL;
     }
 
@@ -332,22 +325,29 @@ private:
     return Status::Ok();
   }
 
-  static Status CopyLevelDat(std::filesystem::path const &inputDirectory,
+  static Status CopyLevelDat(SavegameFiles const &files,
                              std::filesystem::path const &outputDirectory,
                              std::optional<std::chrono::system_clock::time_point> lastPlayed,
                              std::shared_ptr<PlayerInfo> const &localPlayer,
                              Context &ctx) {
     using namespace std;
     namespace fs = std::filesystem;
-    auto datFrom = inputDirectory / "level.dat";
     auto datTo = outputDirectory / "level.dat";
-    if (!Fs::Exists(datFrom)) {
+    auto datFrom = files.get(u8"level.dat");
+    if (!datFrom) {
       return JE2BE_ERROR;
     }
 
-    auto inStream = make_shared<mcfile::stream::GzFileInputStream>(datFrom);
-    auto inRoot = CompoundTag::Read(inStream, mcfile::Encoding::Java);
-    inStream.reset();
+    CompoundTagPtr inRoot;
+    if (datFrom->size() >= 2 && (*datFrom)[0] == 0x1f && (*datFrom)[1] == 0x8b) {
+      vector<u8> decompressed;
+      if (!DecompressGzip(*datFrom, decompressed)) {
+        return JE2BE_ERROR;
+      }
+      inRoot = CompoundTag::Read(make_shared<SpanInputStream>(decompressed), mcfile::Encoding::Java);
+    } else {
+      inRoot = CompoundTag::Read(make_shared<SpanInputStream>(*datFrom), mcfile::Encoding::Java);
+    }
     if (!inRoot) {
       return JE2BE_ERROR;
     }
@@ -587,23 +587,43 @@ private:
     return flatSettings;
   }
 
-  static Status CopyMapFiles(std::filesystem::path const &inputDirectory, std::filesystem::path const &outputDirectory) {
+  static bool DecompressGzip(std::span<u8 const> in, std::vector<u8> &out) {
+    z_stream zs = {};
+    if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) {
+      return false;
+    }
+    zs.next_in = (Bytef *)in.data();
+    zs.avail_in = (uInt)in.size();
+    out.clear();
+    u8 buffer[16384];
+    int ret;
+    do {
+      zs.next_out = buffer;
+      zs.avail_out = sizeof(buffer);
+      ret = inflate(&zs, Z_NO_FLUSH);
+      if (ret != Z_OK && ret != Z_STREAM_END) {
+        inflateEnd(&zs);
+        return false;
+      }
+      out.insert(out.end(), buffer, buffer + sizeof(buffer) - zs.avail_out);
+    } while (ret != Z_STREAM_END);
+    inflateEnd(&zs);
+    return true;
+  }
+
+  static Status CopyMapFiles(SavegameFiles const &files, std::filesystem::path const &outputDirectory) {
     namespace fs = std::filesystem;
 
-    auto dataFrom = inputDirectory / "data";
     auto dataTo = outputDirectory / "data";
-    if (!Fs::Exists(dataFrom)) {
+    auto entries = files.list(u8"data");
+    if (entries.empty()) {
       return Status::Ok();
     }
     if (!Fs::CreateDirectories(dataTo)) {
       return JE2BE_ERROR;
     }
-    for (DirectoryIterator it(dataFrom); it.valid(); it.next()) {
-      if (!it->is_regular_file()) {
-        continue;
-      }
-      auto fileName = it->path().filename();
-      auto fileNameString = fileName.u8string();
+    for (auto const &entry : entries) {
+      auto fileNameString = fs::path(entry).filename().u8string();
       if (!fileNameString.starts_with(u8"map_") || !fileNameString.ends_with(u8".dat")) {
         continue;
       }
@@ -612,11 +632,13 @@ private:
       if (!number) {
         continue;
       }
-      std::error_code ec1;
-      fs::copy_options o = fs::copy_options::overwrite_existing;
-      fs::copy_file(dataFrom / fileNameString, dataTo / fileNameString, o, ec1);
-      if (ec1) {
-        return JE2BE_ERROR_WHAT(ec1.message());
+      auto data = files.get(entry);
+      if (!data) {
+        return JE2BE_ERROR;
+      }
+      auto stream = std::make_shared<mcfile::stream::FileOutputStream>(dataTo / fileNameString);
+      if (!stream->write(data->data(), data->size())) {
+        return JE2BE_ERROR;
       }
     }
     return Status::Ok();
@@ -1,13 +1,8 @@
 #include "lce/_savegame.hpp"
 
-// clang-format off
-
-#include <je2be/fs.hpp>
-
-#include <fstream>
-
 #include "_mem.hpp"
-// clang-format on
+
+#include <cstring>
 
 namespace je2be::lce {
 
@@ -15,39 +10,17 @@ class Savegame::Impl {
   Impl() = delete;
 
 public:
-  static void DecodeDecompressedChunk(std::vector<u8> &buffer) {
+  static void DecodeDecompressedChunk(std::span<u8 const> buffer, std::vector<u8> &out) {
     // This is a port of ExpandX function from https://sourceforge.net/projects/xboxtopcminecraftconverter/
+    // The output size is computed first, so that the output is allocated once and filled with memcpy/memset.
+    size_t size = Expand<false>(buffer.data(), buffer.size(), nullptr);
+    out.resize(size);
+    Expand<true>(buffer.data(), buffer.size(), out.data());
+  }
+
+  static void DecodeDecompressedChunk(std::vector<u8> &buffer) {
     std::vector<u8> out;
-    int i = 0;
-    while (i < buffer.size()) {
-      u8 b = buffer[i];
-      if (b != 0xff) {
-        out.push_back(b);
-        i++;
-        continue;
-      }
-      if (i + 1 >= buffer.size()) {
-        out.push_back(b);
-        break;
-      }
-      u8 count = buffer[i + 1];
-      if (count >= 3) {
-        if (i + 2 >= buffer.size()) {
-          out.push_back(count);
-          break;
-        }
-        u8 repeat = buffer[i + 2];
-        for (int j = 0; j <= count; j++) {
-          out.push_back(repeat);
-        }
-        i += 3;
-      } else {
-        for (int j = 0; j <= count; j++) {
-          out.push_back(0xff);
-        }
-        i += 2;
-      }
-    }
+    DecodeDecompressedChunk(buffer, out);
     buffer.swap(out);
   }
 
@@ -86,59 +59,54 @@ public:
     return stream.read(buffer.data(), size + 4);
   }
 
-  static bool ExtractFilesFromDecompressedSavegame(std::vector<u8> const &savegame, std::filesystem::path const &outputDirectory) {
-    if (savegame.size() < 8) {
-      return false;
-    }
-    u32 const indexOffset = mcfile::U32FromBE(Mem::Read<u32>(savegame, 0));
-    u32 const fileCount = mcfile::U32FromBE(Mem::Read<u32>(savegame, 4));
-    for (u32 i = 0; i < fileCount; i++) {
-      u32 pos = indexOffset + i * kIndexBytesPerFile;
-      if (!ExtractFile(savegame, pos, outputDirectory)) {
-        return false;
+private:
+  // Expands 0xff escapes: "0xff n v" (n >= 3) is n + 1 copies of v, "0xff n" (n < 3) is n + 1 copies of 0xff.
+  // Returns the number of output bytes. `out` is written only when Fill is true.
+  template <bool Fill>
+  static size_t Expand(u8 const *in, size_t size, u8 *out) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < size) {
+      u8 const *escape = (u8 const *)memchr(in + i, 0xff, size - i);
+      size_t literals = escape ? (size_t)(escape - (in + i)) : size - i;
+      if constexpr (Fill) {
+        memcpy(out + o, in + i, literals);
       }
-    }
-    return true;
-  }
-
-  static constexpr u32 kIndexBytesPerFile = 144;
-  static constexpr u32 kFileNameLength = 56;
-
-  static bool ExtractFile(std::vector<u8> const &buffer, u32 indexPosition, std::filesystem::path outputDirectory) {
-    using namespace std;
-    namespace fs = std::filesystem;
-    if (indexPosition + kIndexBytesPerFile > buffer.size()) {
-      return false;
-    }
-    u32 size = mcfile::U32FromBE(Mem::Read<u32>(buffer, indexPosition + 0x80));
-    u32 offset = mcfile::U32FromBE(Mem::Read<u32>(buffer, indexPosition + 0x84));
-    if (offset + size > buffer.size()) {
-      return false;
-    }
-    u16string name;
-    for (u32 i = 0; i < kFileNameLength; i++) {
-      char16_t c = mcfile::U16FromBE(Mem::Read<u16>(buffer, indexPosition + i * 2));
-      if (c == 0) {
+      o += literals;
+      i += literals;
+      if (!escape) {
         break;
       }
-      name.push_back(c);
-    }
-    fs::path file;
-    if (name.starts_with(u"DIM-1")) {
-      file = outputDirectory / "DIM-1" / "region" / name.substr(5);
-    } else if (name.starts_with(u"DIM1/")) {
-      file = outputDirectory / "DIM1" / "region" / name.substr(5);
-    } else if (name.ends_with(u".mcr")) {
-      file = outputDirectory / "region" / name;
-    } else {
-      file = outputDirectory / name;
-    }
-    auto parent = file.parent_path();
-    if (!Fs::CreateDirectories(parent)) {
-      return false;
+      if (i + 1 >= size) {
+        if constexpr (Fill) {
+          out[o] = 0xff;
+        }
+        o++;
+        break;
+      }
+      u8 count = in[i + 1];
+      if (count >= 3) {
+        if (i + 2 >= size) {
+          if constexpr (Fill) {
+            out[o] = count;
+          }
+          o++;
+          break;
+        }
+        if constexpr (Fill) {
+          memset(out + o, in[i + 2], (size_t)count + 1);
+        }
+        o += (size_t)count + 1;
+        i += 3;
+      } else {
+        if constexpr (Fill) {
+          memset(out + o, 0xff, (size_t)count + 1);
+        }
+        o += (size_t)count + 1;
+        i += 2;
+      }
     }
-    auto stream = make_shared<mcfile::stream::FileOutputStream>(file);
-    return stream->write(buffer.data() + offset, size);
+    return o;
   }
 };
 
@@ -146,12 +114,12 @@ void Savegame::DecodeDecompressedChunk(std::vector<u8> &buffer) {
   return Impl::DecodeDecompressedChunk(buffer);
 }
 
-bool Savegame::ExtractRawChunkFromRegionFile(mcfile::stream::InputStream &stream, int x, int z, std::vector<u8> &buffer) {
-  return Impl::ExtractRawChunkFromRegionFile(stream, x, z, buffer);
+void Savegame::DecodeDecompressedChunk(std::span<u8 const> buffer, std::vector<u8> &out) {
+  return Impl::DecodeDecompressedChunk(buffer, out);
 }
 
-bool Savegame::ExtractFilesFromDecompressedSavegame(std::vector<u8> const &savegame, std::filesystem::path const &outputDirectory) {
-  return Impl::ExtractFilesFromDecompressedSavegame(savegame, outputDirectory);
+bool Savegame::ExtractRawChunkFromRegionFile(mcfile::stream::InputStream &stream, int x, int z, std::vector<u8> &buffer) {
+  return Impl::ExtractRawChunkFromRegionFile(stream, x, z, buffer);
 }
 
 } // namespace je2be::lce
@@ -11,6 +11,8 @@
 #include "_parallel.hpp"
 #include "lce/_chunk.hpp"
 #include "lce/_context.hpp"
+#include "lce/_empty-region-writer.hpp"
+#include "lce/_savegame-files.hpp"
 #include "lce/_terraform.hpp"
 #include "terraform/java/_block-accessor-java-directory.hpp"
 #include "terraform/lighting/_lighting.hpp"
@@ -22,7 +24,7 @@ class World::Impl {
   Impl() = delete;
 
 public:
-  static Status Convert(std::filesystem::path const &levelRootDirectory,
+  static Status Convert(SavegameFiles const &files,
                         std::filesystem::path const &outputDirectory,
                         mcfile::Dimension dimension,
                         unsigned int concurrency,
@@ -73,8 +75,7 @@ public:
     for (int rz = minRegion; rz <= maxRegion; rz++) {
       for (int rx = minRegion; rx <= maxRegion; rx++) {
         if (-1 <= rx && rx <= 0 && -1 <= rz && rz <= 0) {
-          auto mcr = levelRootDirectory / worldDir / "region" / ("r." + std::to_string(rx) + "." + std::to_string(rz) + ".mcr");
-          if (!Fs::Exists(mcr)) {
+          if (!files.exists(SavegameFiles::RegionFilePath(dimension, rx, rz))) {
             skipChunks += 1024;
             continue;
           }
@@ -103,11 +104,14 @@ public:
     Status st = Parallel::Process<Pos2i>(
         innerChunks,
         concurrency,
-        [levelRootDirectory, worldDir, chunkTempDir, ctx, options, dimension, progress, &progressChunks, &behavior](Pos2i const &chunk) -> Status {
+        [&files, chunkTempDir, ctx, options, dimension, progress, &progressChunks, &behavior](Pos2i const &chunk) -> Status {
           int rx = mcfile::Coordinate::RegionFromChunk(chunk.fX);
           int rz = mcfile::Coordinate::RegionFromChunk(chunk.fZ);
-          auto mcr = levelRootDirectory / worldDir / "region" / ("r." + std::to_string(rx) + "." + std::to_string(rz) + ".mcr");
-          Status st = ProcessChunk(dimension, mcr, chunk.fX, chunk.fZ, *chunkTempDir, behavior, ctx, options);
+          auto mcr = files.open(SavegameFiles::RegionFilePath(dimension, rx, rz));
+          if (!mcr) {
+            return JE2BE_ERROR;
+          }
+          Status st = ProcessChunk(dimension, *mcr, chunk.fX, chunk.fZ, *chunkTempDir, behavior, ctx, options);
           if (!st.ok()) {
             return st;
           }
@@ -150,10 +154,14 @@ public:
       return JE2BE_ERROR;
     }
     progressChunks = progressChunksOffset + 3 * numChunksInWorld;
+    auto chunkCache = make_shared<terraform::java::ChunkCache>(2, kLightingChunkCacheCapacity);
+    for (Pos2i const &region : innerRegions) {
+      chunkCache->retain(dimension, region);
+    }
     st = Parallel::Process<Pos2i>(
         innerRegions,
         concurrency,
-        bind(Lighting, _1, dimension, outputDirectory / worldDir / "region_", outputDirectory / worldDir / "region", &progressChunks, progress));
+        bind(Lighting, _1, dimension, outputDirectory / worldDir / "region_", outputDirectory / worldDir / "region", chunkCache, &progressChunks, progress));
     if (!st.ok()) {
       return JE2BE_ERROR_PUSH(st);
     }
@@ -179,6 +187,18 @@ public:
 private:
   static Status CreateOuterRegion(Pos2i region, mcfile::Dimension dim, bool newSeaLevel, std::filesystem::path directory, std::atomic_uint64_t *progressChunks, Progress *progress) {
     auto file = directory / mcfile::je::Region::GetDefaultRegionFileName(region.fX, region.fZ);
+    if (auto writer = EmptyRegionWriter::Get(dim, newSeaLevel); writer) {
+      if (!writer->write(file, region.fX, region.fZ)) {
+        return JE2BE_ERROR;
+      }
+      if (progress) {
+        auto p = progressChunks->fetch_add(1024) + 1024;
+        if (!progress->report({p, kProgressWeightTotal})) {
+          return JE2BE_ERROR;
+        }
+      }
+      return Status::Ok();
+    }
     auto editor = mcfile::je::McaEditor::Open(file);
     if (!editor) {
       return JE2BE_ERROR;
@@ -213,13 +233,17 @@ private:
     }
   }
 
-  static Status Lighting(Pos2i const &region, mcfile::Dimension dim, std::filesystem::path inputDirectory, std::filesystem::path outputDirectory, std::atomic_uint64_t *progressChunks, Progress *progress) {
+  static Status Lighting(Pos2i const &region, mcfile::Dimension dim, std::filesystem::path inputDirectory, std::filesystem::path outputDirectory, std::shared_ptr<terraform::java::ChunkCache> chunkCache, std::atomic_uint64_t *progressChunks, Progress *progress) {
     using namespace std;
     namespace fs = std::filesystem;
 
     int rx = region.fX;
     int rz = region.fZ;
 
+    defer {
+      chunkCache->release(dim, region);
+    };
+
     auto report = [&]() {
       auto p = progressChunks->fetch_add(1024) + 1024;
       if (progress && !progress->report({p, World::kProgressWeightTotal})) {
@@ -252,7 +276,7 @@ private:
     }
 
     terraform::lighting::LightCache lightCache(rx, rz);
-    auto blockAccessor = make_shared<terraform::java::BlockAccessorJavaDirectory<5, 5>>(rx * 32 - 1, rz * 32 - 1, inputDirectory);
+    auto blockAccessor = make_shared<terraform::java::BlockAccessorJavaDirectory<5, 5>>(rx * 32 - 1, rz * 32 - 1, inputDirectory, dim, chunkCache);
 
     for (int z = 0; z < 32; z++) {
       for (int x = 0; x < 32; x++) {
@@ -270,7 +294,7 @@ private:
         }
 
         if (!blockAccessor) {
-          blockAccessor.reset(new terraform::java::BlockAccessorJavaDirectory<5, 5>(cx - 2, cz - 2, inputDirectory));
+          blockAccessor.reset(new terraform::java::BlockAccessorJavaDirectory<5, 5>(cx - 2, cz - 2, inputDirectory, dim, chunkCache));
         }
         if (blockAccessor->fChunkX != cx - 2 || blockAccessor->fChunkZ != cz - 2) {
           auto next = blockAccessor->makeRelocated(cx - 2, cz - 2);
@@ -292,7 +316,9 @@ private:
 
         terraform::BlockPropertyAccessorJava propertyAccessor(*ch);
         terraform::box360::NetherPortal::Do(*writable, *blockAccessor, propertyAccessor);
-        terraform::lighting::Lighting::Do(dim, *writable, *blockAccessor, lightCache);
+        terraform::BlockWindow<mcfile::je::Block> window(cx - 1, cz - 1);
+        blockAccessor->populate(window);
+        terraform::lighting::Lighting::Do(dim, *writable, window, lightCache);
 
         lightCache.dispose(cx - 1, cz - 1);
 
@@ -357,7 +383,7 @@ private:
   }
 
   static Status ProcessChunk(mcfile::Dimension dimension,
-                             std::filesystem::path mcr,
+                             mcfile::stream::InputStream &mcr,
                              int cx,
                              int cz,
                              std::filesystem::path chunkTempDir,
@@ -385,9 +411,13 @@ private:
 
     return Status::Ok();
   }
+
+private:
+  // Upper limit of the number of parsed chunks kept by terraform::java::ChunkCache during Lighting
+  static constexpr size_t kLightingChunkCacheCapacity = 2048;
 };
 
-Status World::Convert(std::filesystem::path const &levelRootDirectory,
+Status World::Convert(SavegameFiles const &files,
                       std::filesystem::path const &outputDirectory,
                       mcfile::Dimension dimension,
                       unsigned int concurrency,
@@ -396,7 +426,7 @@ Status World::Convert(std::filesystem::path const &levelRootDirectory,
                       Options const &options,
                       Progress *progress,
                       u64 progressChunksOffset) {
-  return Impl::Convert(levelRootDirectory, outputDirectory, dimension, concurrency, behavior, ctx, options, progress, progressChunksOffset);
+  return Impl::Convert(files, outputDirectory, dimension, concurrency, behavior, ctx, options, progress, progressChunksOffset);
 }
 
 } // namespace je2be::lce
@@ -26,13 +26,15 @@ public:
     return (fRawData & 0x80) == 0x80;
   }
 
-  std::shared_ptr<mcfile::je::Block const> toBlock() const;
+  // The block is looked up from a table built once for all the 65536 (fRawId, fRawData) pairs. Equal blocks share the same instance.
+  std::shared_ptr<mcfile::je::Block const> const &toBlock() const;
 
 public:
   u8 fRawId;
   u8 fRawData;
 
 private:
+  std::shared_ptr<mcfile::je::Block const> createBlock() const;
   std::shared_ptr<mcfile::je::Block const> unsafeToBlock() const;
 };
 
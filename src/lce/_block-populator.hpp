@@ -0,0 +1,215 @@
+#pragma once
+
+#include <je2be/nbt.hpp>
+
+#include "_data3d.hpp"
+#include "lce/_block-data.hpp"
+#include "lce/_chunk.hpp"
+
+namespace je2be::lce {
+
+class BlockPopulator {
+  BlockPopulator() = delete;
+
+public:
+  // Builds the palette and indices of each 16x16x16 section covered by blockId and blockData, and sets them to the chunk at once.
+  // Sections that are not fully covered take PopulatePerVoxel.
+  static void Populate(Data3dSq<u8, 16> const &blockId,
+                       Data3dSq<u8, 16> const &blockData,
+                       mcfile::je::WritableChunk &chunk) {
+    using namespace std;
+    if (blockId.fStart != blockData.fStart) {
+      assert(false);
+      return;
+    }
+    if (blockId.fEnd != blockData.fEnd) {
+      assert(false);
+      return;
+    }
+    int minSectionY = mcfile::Coordinate::ChunkFromBlock(blockId.fStart.fY);
+    int maxSectionY = mcfile::Coordinate::ChunkFromBlock(blockId.fEnd.fY);
+    bool fullColumns = blockId.fStart.fX == 0 && blockId.fStart.fZ == 0;
+
+    // Palette index of each (raw id, raw data) pair in the section being built, -1 when not in the palette yet
+    vector<i32> paletteIndexOfKey(65536, -1);
+
+    for (int sectionY = minSectionY; sectionY <= maxSectionY; sectionY++) {
+      int minY = sectionY * 16;
+      int maxY = minY + 15;
+      if (!fullColumns || minY < blockId.fStart.fY || blockId.fEnd.fY < maxY) {
+        PopulatePerVoxel(blockId, blockData, (std::max)(minY, blockId.fStart.fY), (std::min)(maxY, blockId.fEnd.fY), chunk);
+        continue;
+      }
+
+      vector<shared_ptr<mcfile::je::Block const>> palette;
+      vector<u16> indices(4096);
+      vector<u16> keys;
+      for (int y = minY; y <= maxY; y++) {
+        for (int z = 0; z < 16; z++) {
+          for (int x = 0; x < 16; x++) {
+            u8 rawId = blockId[{x, y, z}];
+            u8 rawData = blockData[{x, y, z}];
+            BlockData bd(rawId, rawData);
+            u16 id = bd.id();
+            int index = mcfile::je::chunksection::ChunkSection118::BlockIndex(x, y - minY, z);
+            if (id == 26) {
+              AddBedTileEntity(x, y, z, chunk);
+            }
+            if (IsBlockDependingOnNeighbors(bd)) {
+              auto block = BlockDependingOnNeighbors(blockId, blockData, x, y, z, chunk.getDataVersion());
+              if (!block) {
+                block = bd.toBlock();
+              }
+              indices[index] = PaletteIndex(palette, block);
+              continue;
+            }
+            u16 key = ((u16)rawId << 8) | (u16)rawData;
+            i32 paletteIndex = paletteIndexOfKey[key];
+            if (paletteIndex < 0) {
+              paletteIndex = PaletteIndex(palette, bd.toBlock());
+              paletteIndexOfKey[key] = paletteIndex;
+              keys.push_back(key);
+            }
+            indices[index] = (u16)paletteIndex;
+          }
+        }
+      }
+      for (u16 key : keys) {
+        paletteIndexOfKey[key] = -1;
+      }
+
+      shared_ptr<mcfile::je::ChunkSection> section;
+      if (chunk.getDataVersion() >= mcfile::je::chunksection::ChunkSectionGenerator::kMinDataVersionChunkSection118) {
+        auto s = mcfile::je::chunksection::ChunkSection118::MakeEmpty(sectionY, chunk.getDataVersion());
+        if (s->fBlocks.reset(palette, indices)) {
+          section = s;
+        }
+      } else {
+        auto s = mcfile::je::chunksection::ChunkSection116::MakeEmpty(sectionY, chunk.getDataVersion());
+        if (s->fBlocks.reset(palette, indices)) {
+          section = s;
+        }
+      }
+      if (!section) {
+        PopulatePerVoxel(blockId, blockData, minY, maxY, chunk);
+        continue;
+      }
+      int sectionIndex = sectionY - chunk.fChunkY;
+      if (sectionIndex < 0) {
+        PopulatePerVoxel(blockId, blockData, minY, maxY, chunk);
+        continue;
+      }
+      if (chunk.fSections.size() <= sectionIndex) {
+        chunk.fSections.resize(sectionIndex + 1);
+      }
+      chunk.fSections[sectionIndex] = section;
+    }
+  }
+
+  // Sets blocks one by one to the chunk, in the range minY <= y <= maxY
+  static void PopulatePerVoxel(Data3dSq<u8, 16> const &blockId,
+                               Data3dSq<u8, 16> const &blockData,
+                               int minY,
+                               int maxY,
+                               mcfile::je::WritableChunk &chunk) {
+    using namespace std;
+    Pos3i origin(chunk.fChunkX * 16, 0, chunk.fChunkZ * 16);
+    for (int y = minY; y <= maxY; y++) {
+      for (int z = blockId.fStart.fZ; z <= blockId.fEnd.fZ; z++) {
+        for (int x = blockId.fStart.fX; x <= blockId.fEnd.fX; x++) {
+          u8 rawId = blockId[{x, y, z}];
+          u8 rawData = blockData[{x, y, z}];
+          BlockData bd(rawId, rawData);
+          shared_ptr<mcfile::je::Block const> block;
+          if (IsBlockDependingOnNeighbors(bd)) {
+            block = BlockDependingOnNeighbors(blockId, blockData, x, y, z, chunk.getDataVersion());
+          }
+          if (!block) {
+            block = bd.toBlock();
+          }
+          if (block) {
+            chunk.setBlockAt(origin + Pos3i{x, y, z}, block);
+          }
+          if (bd.id() == 26) {
+            AddBedTileEntity(x, y, z, chunk);
+          }
+        }
+      }
+    }
+  }
+
+private:
+  static bool IsBlockDependingOnNeighbors(BlockData const &bd) {
+    u16 id = bd.id();
+    return (id == 175 && bd.data() == 10) || id == 64;
+  }
+
+  // Upper half of tall flowers and doors need the other half of them to determine their properties
+  static std::shared_ptr<mcfile::je::Block const> BlockDependingOnNeighbors(Data3dSq<u8, 16> const &blockId,
+                                                                            Data3dSq<u8, 16> const &blockData,
+                                                                            int x,
+                                                                            int y,
+                                                                            int z,
+                                                                            int dataVersion) {
+    using namespace std;
+    BlockData bd(blockId[{x, y, z}], blockData[{x, y, z}]);
+    u16 id = bd.id();
+    u8 data = bd.data();
+    shared_ptr<mcfile::je::Block const> block;
+    if (id == 175 && data == 10 && y - 1 >= 0) {
+      // upper half of tall flowers
+      u8 lowerId = blockId[{x, y - 1, z}];
+      u8 lowerData = blockData[{x, y - 1, z}];
+      if (auto lower = mcfile::je::Flatten::Block(lowerId, lowerData, dataVersion); lower) {
+        block = lower->applying({{u8"half", u8"upper"}});
+      }
+    } else if (id == 64) {
+      if (y - 1 >= 0) {
+        u8 lowerId = blockId[{x, y - 1, z}];
+        if (lowerId == 64) {
+          u8 lowerData = blockData[{x, y - 1, z}];
+          map<u8string, u8string> props;
+          mcfile::je::Flatten::Door(lowerData, props);
+          mcfile::je::Flatten::Door(data, props);
+          block = mcfile::je::Block::FromIdAndProperties(mcfile::blocks::minecraft::oak_door, Chunk::kTargetDataVersion, props);
+        }
+      }
+      if (!block && y + 1 < 256) {
+        u8 upperId = blockId[{x, y + 1, z}];
+        if (upperId == 64) {
+          u8 upperData = blockData[{x, y + 1, z}];
+          map<u8string, u8string> props;
+          mcfile::je::Flatten::Door(upperData, props);
+          mcfile::je::Flatten::Door(data, props);
+          block = mcfile::je::Block::FromIdAndProperties(mcfile::blocks::minecraft::oak_door, Chunk::kTargetDataVersion, props);
+        }
+      }
+    }
+    return block;
+  }
+
+  static u16 PaletteIndex(std::vector<std::shared_ptr<mcfile::je::Block const>> &palette, std::shared_ptr<mcfile::je::Block const> block) {
+    if (!block) {
+      block = mcfile::je::Block::FromId(mcfile::blocks::minecraft::air, Chunk::kTargetDataVersion);
+    }
+    for (size_t i = 0; i < palette.size(); i++) {
+      if (palette[i] == block || (palette[i]->fName == block->fName && palette[i]->fData == block->fData)) {
+        return (u16)i;
+      }
+    }
+    palette.push_back(block);
+    return (u16)(palette.size() - 1);
+  }
+
+  static void AddBedTileEntity(int x, int y, int z, mcfile::je::WritableChunk &chunk) {
+    // may be overwritten by ParseTileEntities later
+    auto tag = Compound();
+    tag->set(u8"id", u8"minecraft:bed");
+    tag->set(u8"x", Int(x));
+    tag->set(u8"y", Int(y));
+    tag->set(u8"z", Int(z));
+    chunk.fTileEntities[{x, y, z}] = tag;
+  }
+};
+
+} // namespace je2be::lce
@@ -23,7 +23,7 @@ public:
   }
 
   static Status Convert(mcfile::Dimension dimension,
-                        std::filesystem::path const &region,
+                        mcfile::stream::InputStream &region,
                         int cx,
                         int cz,
                         std::shared_ptr<mcfile::je::WritableChunk> &result,
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <je2be/integers.hpp>
+#include <je2be/nbt.hpp>
+
+#include <minecraft-file.hpp>
+#include <zlib.h>
+
+#include "lce/_chunk.hpp"
+
+#include <mutex>
+
+namespace je2be::lce {
+
+// Writes region files filled with Chunk::CreateEmptyChunk chunks.
+// The empty chunk of a (dimension, sea level) pair is serialized and compressed only once. The xPos and zPos values are placed
+// in stored (uncompressed) deflate blocks, so that each chunk of a region is produced by copying the template, patching the
+// two values and recomputing the Adler-32 checksum from precomputed parts.
+class EmptyRegionWriter {
+public:
+  // Returns nullptr when the template can't be made. Callers should fall back to writing the chunks one by one.
+  static std::shared_ptr<EmptyRegionWriter const> Get(mcfile::Dimension dim, bool newSeaLevel) {
+    using namespace std;
+    static mutex sMut;
+    static map<pair<mcfile::Dimension, bool>, shared_ptr<EmptyRegionWriter const>> sCache;
+
+    if (dim != mcfile::Dimension::Overworld) {
+      newSeaLevel = false;
+    }
+    auto key = make_pair(dim, newSeaLevel);
+    lock_guard<mutex> lock(sMut);
+    if (auto found = sCache.find(key); found != sCache.end()) {
+      return found->second;
+    }
+    auto writer = Create(dim, newSeaLevel);
+    sCache[key] = writer;
+    return writer;
+  }
+
+  bool write(std::filesystem::path const &file, int rx, int rz) const {
+    using namespace std;
+
+    u32 const payloadSize = 4 + 1 + (u32)fCompressed.size();
+    u32 const sectorsPerChunk = (payloadSize + kSectorSize - 1) / kSectorSize;
+    if (sectorsPerChunk > 0xff || 2 + 1024 * sectorsPerChunk > 0xffffff) {
+      return false;
+    }
+
+    auto stream = make_shared<mcfile::stream::FileOutputStream>(file);
+    if (!stream->valid()) {
+      return false;
+    }
+
+    vector<u8> header(kSectorSize * 2, 0);
+    for (u32 i = 0; i < 1024; i++) {
+      u32 location = ((2 + i * sectorsPerChunk) << 8) | sectorsPerChunk;
+      header[i * 4] = 0xff & (location >> 24);
+      header[i * 4 + 1] = 0xff & (location >> 16);
+      header[i * 4 + 2] = 0xff & (location >> 8);
+      header[i * 4 + 3] = 0xff & location;
+    }
+    if (!stream->write(header.data(), header.size())) {
+      return false;
+    }
+
+    vector<u8> sector(sectorsPerChunk * kSectorSize, 0);
+    u32 length = payloadSize - 4;
+    sector[0] = 0xff & (length >> 24);
+    sector[1] = 0xff & (length >> 16);
+    sector[2] = 0xff & (length >> 8);
+    sector[3] = 0xff & length;
+    sector[4] = kCompressionTypeZlib;
+    copy(fCompressed.begin(), fCompressed.end(), sector.begin() + 5);
+    u8 *data = sector.data() + 5;
+
+    for (int z = 0; z < 32; z++) {
+      for (int x = 0; x < 32; x++) {
+        i32 cx = rx * 32 + x;
+        i32 cz = rz * 32 + z;
+        u8 xPos[4];
+        u8 zPos[4];
+        StoreI32BE(cx, xPos);
+        StoreI32BE(cz, zPos);
+        copy_n(xPos, 4, data + fXPosOffset);
+        copy_n(zPos, 4, data + fZPosOffset);
+
+        u8 const *first = fXFirst ? xPos : zPos;
+        u8 const *second = fXFirst ? zPos : xPos;
+        uLong adler = fAdler[0];
+        adler = adler32_combine(adler, adler32(1, first, 4), 4);
+        adler = adler32_combine(adler, fAdler[1], fLength[1]);
+        adler = adler32_combine(adler, adler32(1, second, 4), 4);
+        adler = adler32_combine(adler, fAdler[2], fLength[2]);
+        StoreI32BE((i32)(u32)adler, data + fCompressed.size() - 4);
+
+        if (!stream->write(sector.data(), sector.size())) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+private:
+  EmptyRegionWriter() = default;
+
+  static std::shared_ptr<EmptyRegionWriter const> Create(mcfile::Dimension dim, bool newSeaLevel) {
+    using namespace std;
+
+    auto templateChunk = Chunk::CreateEmptyChunk(dim, 0, 0, newSeaLevel);
+    if (!templateChunk) {
+      return nullptr;
+    }
+    auto templateNbt = Serialize(*templateChunk, dim);
+    if (!templateNbt) {
+      return nullptr;
+    }
+    auto xPos = FindIntValue(*templateNbt, u8"xPos");
+    auto zPos = FindIntValue(*templateNbt, u8"zPos");
+    if (!xPos || !zPos) {
+      return nullptr;
+    }
+
+    // Make sure the chunk coordinate is the only difference between empty chunks
+    int const testCx = 0x12345;
+    int const testCz = -0x6789a;
+    auto testChunk = Chunk::CreateEmptyChunk(dim, testCx, testCz, newSeaLevel);
+    if (!testChunk) {
+      return nullptr;
+    }
+    auto testNbt = Serialize(*testChunk, dim);
+    if (!testNbt) {
+      return nullptr;
+    }
+    string expected = *templateNbt;
+    StoreI32BE(testCx, (u8 *)expected.data() + *xPos);
+    StoreI32BE(testCz, (u8 *)expected.data() + *zPos);
+    if (expected != *testNbt) {
+      return nullptr;
+    }
+
+    shared_ptr<EmptyRegionWriter> ret(new EmptyRegionWriter);
+    ret->fXFirst = *xPos < *zPos;
+    size_t first = (std::min)(*xPos, *zPos);
+    size_t second = (std::max)(*xPos, *zPos);
+    u8 const *nbt = (u8 const *)templateNbt->data();
+    span<u8 const> parts[3] = {
+        span<u8 const>(nbt, first),
+        span<u8 const>(nbt + first + 4, second - first - 4),
+        span<u8 const>(nbt + second + 4, templateNbt->size() - second - 4),
+    };
+
+    auto &out = ret->fCompressed;
+    // zlib header: deflate, 32K window, default compression
+    out.push_back(0x78);
+    out.push_back(0x9c);
+    size_t storedOffsets[2];
+    for (int i = 0; i < 3; i++) {
+      if (!DeflateRaw(parts[i], out)) {
+        return nullptr;
+      }
+      ret->fAdler[i] = adler32(1, parts[i].data(), (uInt)parts[i].size());
+      ret->fLength[i] = (z_off_t)parts[i].size();
+      if (i < 2) {
+        // Non-final stored block with 4 bytes
+        out.push_back(0x0);
+        out.push_back(0x4);
+        out.push_back(0x0);
+        out.push_back(0xfb);
+        out.push_back(0xff);
+        storedOffsets[i] = out.size();
+        out.insert(out.end(), 4, 0);
+      }
+    }
+    // Empty, final stored block
+    out.push_back(0x1);
+    out.push_back(0x0);
+    out.push_back(0x0);
+    out.push_back(0xff);
+    out.push_back(0xff);
+    // Placeholder for Adler-32
+    out.insert(out.end(), 4, 0);
+
+    if (ret->fXFirst) {
+      ret->fXPosOffset = storedOffsets[0];
+      ret->fZPosOffset = storedOffsets[1];
+    } else {
+      ret->fZPosOffset = storedOffsets[0];
+      ret->fXPosOffset = storedOffsets[1];
+    }
+    return ret;
+  }
+
+  static std::optional<std::string> Serialize(mcfile::je::WritableChunk &chunk, mcfile::Dimension dim) {
+    auto nbt = chunk.toCompoundTag(dim);
+    if (!nbt) {
+      return std::nullopt;
+    }
+    return CompoundTag::Write(*nbt, mcfile::Encoding::Java);
+  }
+
+  // Returns the offset of the value of the int tag `name`, only when the tag appears exactly once.
+  static std::optional<size_t> FindIntValue(std::string const &nbt, std::u8string const &name) {
+    std::string pattern;
+    pattern.push_back((char)Tag::Type::Int);
+    pattern.push_back((char)(0xff & (name.size() >> 8)));
+    pattern.push_back((char)(0xff & name.size()));
+    pattern.append((char const *)name.data(), name.size());
+    size_t pos = nbt.find(pattern);
+    if (pos == std::string::npos || nbt.find(pattern, pos + 1) != std::string::npos) {
+      return std::nullopt;
+    }
+    size_t value = pos + pattern.size();
+    if (value + 4 > nbt.size()) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  // Appends raw deflate data for `in` ending with a sync flush, so it can be followed by other blocks. The data doesn't refer to
+  // anything outside of `in`.
+  static bool DeflateRaw(std::span<u8 const> in, std::vector<u8> &out) {
+    z_stream zs{};
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      return false;
+    }
+    zs.next_in = (Bytef *)in.data();
+    zs.avail_in = (uInt)in.size();
+    u8 buffer[16384];
+    int ret;
+    do {
+      zs.next_out = buffer;
+      zs.avail_out = sizeof(buffer);
+      ret = deflate(&zs, Z_SYNC_FLUSH);
+      if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        deflateEnd(&zs);
+        return false;
+      }
+      out.insert(out.end(), buffer, buffer + (sizeof(buffer) - zs.avail_out));
+    } while (zs.avail_out == 0);
+    deflateEnd(&zs);
+    return zs.avail_in == 0;
+  }
+
+  static void StoreI32BE(i32 v, u8 *out) {
+    u32 u = (u32)v;
+    out[0] = 0xff & (u >> 24);
+    out[1] = 0xff & (u >> 16);
+    out[2] = 0xff & (u >> 8);
+    out[3] = 0xff & u;
+  }
+
+private:
+  static constexpr u32 kSectorSize = 4096;
+  static constexpr u8 kCompressionTypeZlib = 2;
+
+  std::vector<u8> fCompressed;
+  size_t fXPosOffset = 0;
+  size_t fZPosOffset = 0;
+  bool fXFirst = true;
+  uLong fAdler[3] = {};
+  z_off_t fLength[3] = {};
+};
+
+} // namespace je2be::lce
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <je2be/integers.hpp>
+
+#include <minecraft-file.hpp>
+
+#include <span>
+
+#include "_mem.hpp"
+#include "_span-input-stream.hpp"
+
+namespace je2be::lce {
+
+// Read-only view of the files embedded in a decompressed savegame. Nothing is copied: every entry refers into the savegame buffer,
+// so the buffer must outlive this object and any stream opened from it.
+// Entries are keyed by the path they would have when extracted to disk, eg. "region/r.0.0.mcr", "DIM-1/region/r.0.0.mcr", "level.dat".
+class SavegameFiles {
+public:
+  static std::shared_ptr<SavegameFiles> Open(std::vector<u8> const &savegame) {
+    using namespace std;
+    if (savegame.size() < 8) {
+      return nullptr;
+    }
+    u32 const indexOffset = mcfile::U32FromBE(Mem::Read<u32>(savegame, 0));
+    u32 const fileCount = mcfile::U32FromBE(Mem::Read<u32>(savegame, 4));
+    shared_ptr<SavegameFiles> ret(new SavegameFiles);
+    for (u32 i = 0; i < fileCount; i++) {
+      u64 pos = (u64)indexOffset + (u64)i * kIndexBytesPerFile;
+      if (pos + kIndexBytesPerFile > savegame.size()) {
+        return nullptr;
+      }
+      u32 size = mcfile::U32FromBE(Mem::Read<u32>(savegame, pos + 0x80));
+      u32 offset = mcfile::U32FromBE(Mem::Read<u32>(savegame, pos + 0x84));
+      if ((u64)offset + (u64)size > savegame.size()) {
+        return nullptr;
+      }
+      u16string name;
+      for (u32 j = 0; j < kFileNameLength; j++) {
+        char16_t c = mcfile::U16FromBE(Mem::Read<u16>(savegame, pos + j * 2));
+        if (c == 0) {
+          break;
+        }
+        name.push_back(c);
+      }
+      ret->fFiles[NormalizedPath(name)] = span<u8 const>(savegame.data() + offset, size);
+    }
+    return ret;
+  }
+
+  std::optional<std::span<u8 const>> get(std::u8string const &path) const {
+    auto found = fFiles.find(path);
+    if (found == fFiles.end()) {
+      return std::nullopt;
+    }
+    return found->second;
+  }
+
+  bool exists(std::u8string const &path) const {
+    return fFiles.count(path) > 0;
+  }
+
+  std::shared_ptr<mcfile::stream::InputStream> open(std::u8string const &path) const {
+    auto data = get(path);
+    if (!data) {
+      return nullptr;
+    }
+    return std::make_shared<SpanInputStream>(*data);
+  }
+
+  // Lists the files directly under the directory, eg. "players" or "data". Pass an empty string to list the root directory.
+  std::vector<std::u8string> list(std::u8string const &directory) const {
+    using namespace std;
+    vector<u8string> ret;
+    u8string prefix = directory.empty() ? u8"" : directory + u8"/";
+    for (auto it = fFiles.lower_bound(prefix); it != fFiles.end(); it++) {
+      auto const &path = it->first;
+      if (!path.starts_with(prefix)) {
+        break;
+      }
+      if (path.find(u8'/', prefix.size()) != u8string::npos) {
+        continue;
+      }
+      ret.push_back(path);
+    }
+    return ret;
+  }
+
+  static std::u8string RegionFilePath(mcfile::Dimension dimension, int rx, int rz) {
+    std::u8string name = u8"r." + mcfile::String::ToString(rx) + u8"." + mcfile::String::ToString(rz) + u8".mcr";
+    switch (dimension) {
+    case mcfile::Dimension::Nether:
+      return u8"DIM-1/region/" + name;
+    case mcfile::Dimension::End:
+      return u8"DIM1/region/" + name;
+    case mcfile::Dimension::Overworld:
+    default:
+      return u8"region/" + name;
+    }
+  }
+
+private:
+  SavegameFiles() = default;
+
+  static std::u8string NormalizedPath(std::u16string const &name) {
+    std::u16string path;
+    if (name.starts_with(u"DIM-1")) {
+      path = u"DIM-1/region/" + name.substr(5);
+    } else if (name.starts_with(u"DIM1/")) {
+      path = u"DIM1/region/" + name.substr(5);
+    } else if (name.ends_with(u".mcr")) {
+      path = u"region/" + name;
+    } else {
+      path = name;
+    }
+    return std::filesystem::path(path).generic_u8string();
+  }
+
+private:
+  static constexpr u32 kIndexBytesPerFile = 144;
+  static constexpr u32 kFileNameLength = 56;
+
+  std::map<std::u8string, std::span<u8 const>> fFiles;
+};
+
+} // namespace je2be::lce
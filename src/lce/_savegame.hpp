@@ -4,6 +4,8 @@
 
 #include <minecraft-file.hpp>
 
+#include <span>
+
 namespace je2be::lce {
 
 class Savegame {
@@ -12,10 +14,9 @@ class Savegame {
 
 public:
   static void DecodeDecompressedChunk(std::vector<u8> &buffer);
+  static void DecodeDecompressedChunk(std::span<u8 const> buffer, std::vector<u8> &out);
 
   static bool ExtractRawChunkFromRegionFile(mcfile::stream::InputStream &stream, int x, int z, std::vector<u8> &buffer);
-
-  static bool ExtractFilesFromDecompressedSavegame(std::vector<u8> const &savegame, std::filesystem::path const &outputDirectory);
 };
 
 } // namespace je2be::lce
@@ -11,6 +11,7 @@ class Context;
 class Options;
 class Progress;
 class Behavior;
+class SavegameFiles;
 
 class World {
   class Impl;
@@ -56,7 +57,7 @@ public:
     }
   }
 
-  static Status Convert(std::filesystem::path const &levelRootDirectory,
+  static Status Convert(SavegameFiles const &files,
                         std::filesystem::path const &outputDirectory,
                         mcfile::Dimension dimension,
                         unsigned int concurrency,
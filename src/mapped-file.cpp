@@ -0,0 +1,144 @@
+#include "_mapped-file.hpp"
+
+#include <minecraft-file.hpp>
+
+#if __has_include(<windows.h>)
+#define NOMINMAX
+#include <windows.h>
+#elif __has_include(<sys/mman.h>) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JE2BE_MAPPED_FILE_MMAP
+#endif
+
+#include <vector>
+
+namespace je2be {
+
+class MappedFile::Impl {
+public:
+  ~Impl() {
+#if __has_include(<windows.h>)
+    if (fView) {
+      UnmapViewOfFile(fView);
+    }
+    if (fMapping) {
+      CloseHandle(fMapping);
+    }
+    if (fFile != INVALID_HANDLE_VALUE) {
+      CloseHandle(fFile);
+    }
+#elif defined(JE2BE_MAPPED_FILE_MMAP)
+    if (fView) {
+      munmap(fView, fSize);
+    }
+#endif
+  }
+
+  static std::unique_ptr<Impl> Open(std::filesystem::path const &path) {
+    using namespace std;
+    unique_ptr<Impl> impl(new Impl);
+#if __has_include(<windows.h>)
+    impl->fFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (impl->fFile == INVALID_HANDLE_VALUE) {
+      return nullptr;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(impl->fFile, &size)) {
+      return nullptr;
+    }
+    impl->fSize = (size_t)size.QuadPart;
+    if (impl->fSize == 0) {
+      return impl;
+    }
+    impl->fMapping = CreateFileMappingW(impl->fFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!impl->fMapping) {
+      return nullptr;
+    }
+    impl->fView = MapViewOfFile(impl->fMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!impl->fView) {
+      return nullptr;
+    }
+    impl->fData = (u8 const *)impl->fView;
+#elif defined(JE2BE_MAPPED_FILE_MMAP)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      return nullptr;
+    }
+    impl->fSize = (size_t)st.st_size;
+    if (impl->fSize == 0) {
+      close(fd);
+      return impl;
+    }
+    void *view = mmap(nullptr, impl->fSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+      return nullptr;
+    }
+    impl->fView = view;
+    impl->fData = (u8 const *)view;
+#else
+    auto stream = make_shared<mcfile::stream::FileInputStream>(path);
+    if (!stream->valid()) {
+      return nullptr;
+    }
+    error_code ec;
+    auto size = filesystem::file_size(path, ec);
+    if (ec) {
+      return nullptr;
+    }
+    impl->fBuffer.resize(size);
+    if (stream->read(impl->fBuffer.data(), size) != size) {
+      return nullptr;
+    }
+    impl->fSize = size;
+    impl->fData = impl->fBuffer.data();
+#endif
+    return impl;
+  }
+
+  std::span<u8 const> data() const {
+    return std::span<u8 const>(fData, fSize);
+  }
+
+private:
+  Impl() = default;
+
+private:
+  u8 const *fData = nullptr;
+  size_t fSize = 0;
+#if __has_include(<windows.h>)
+  HANDLE fFile = INVALID_HANDLE_VALUE;
+  HANDLE fMapping = nullptr;
+  LPVOID fView = nullptr;
+#elif defined(JE2BE_MAPPED_FILE_MMAP)
+  void *fView = nullptr;
+#else
+  std::vector<u8> fBuffer;
+#endif
+};
+
+std::unique_ptr<MappedFile> MappedFile::Open(std::filesystem::path const &path) {
+  auto impl = Impl::Open(path);
+  if (!impl) {
+    return nullptr;
+  }
+  return std::unique_ptr<MappedFile>(new MappedFile(std::move(impl)));
+}
+
+MappedFile::MappedFile(std::unique_ptr<Impl> &&impl) : fImpl(std::move(impl)) {}
+
+MappedFile::~MappedFile() {}
+
+std::span<u8 const> MappedFile::data() const {
+  return fImpl->data();
+}
+
+} // namespace je2be
@@ -2,40 +2,34 @@
 
 #include <je2be/lce/behavior.hpp>
 
-#include "_directory-iterator.hpp"
+#include "lce/_savegame-files.hpp"
 
 namespace je2be::ps3 {
 
 class ConverterBehavior : public je2be::lce::Behavior {
 public:
-  Status decompressChunk(std::vector<uint8_t> &buffer) const override {
+  Status decompressChunk(std::span<uint8_t const> buffer, std::vector<uint8_t> &out) const override {
     if (buffer.size() < 9) {
       return JE2BE_ERROR;
     }
-    std::vector<uint8_t> decoded;
-    if (!mcfile::Compression::DecompressDeflate<decltype(decoded)>(buffer.data() + 8, buffer.size() - 8, decoded)) {
+    out.clear();
+    if (!mcfile::Compression::DecompressDeflate<std::vector<uint8_t>>(buffer.data() + 8, buffer.size() - 8, out)) {
       return JE2BE_ERROR;
     }
-    decoded.swap(buffer);
     return Status::Ok();
   }
 
-  Status loadPlayers(std::filesystem::path const &inputDirectory, std::map<std::filesystem::path, CompoundTagPtr> &outBuffer) const override {
-    for (DirectoryIterator it(inputDirectory); it.valid(); it.next()) {
-      if (!it->is_regular_file()) {
-        continue;
-      }
-      auto p = it->path();
-      if (!p.has_filename()) {
+  Status loadPlayers(je2be::lce::SavegameFiles const &files, std::map<std::filesystem::path, CompoundTagPtr> &outBuffer) const override {
+    for (auto const &name : files.list(u8"")) {
+      if (!name.starts_with(u8"P_") || !name.ends_with(u8".dat")) {
         continue;
       }
-      auto name = p.filename().u8string();
-      if (!name.starts_with(u8"P_") || !name.ends_with(u8".dat")) {
+      auto stream = files.open(name);
+      if (!stream) {
         continue;
       }
-      auto fs = std::make_shared<mcfile::stream::FileInputStream>(p);
-      if (auto tag = CompoundTag::Read(fs, mcfile::Encoding::Java); tag) {
-        outBuffer[p] = tag;
+      if (auto tag = CompoundTag::Read(stream, mcfile::Encoding::Java); tag) {
+        outBuffer[std::filesystem::path(name)] = tag;
       }
     }
     return Status::Ok();
@@ -56,6 +56,35 @@ struct StructurePiece {
     }
     return true;
   }
+
+  // Inverse of Parse. Each piece is a record of kRecordSize bytes, following the number of pieces
+  static void Write(std::vector<StructurePiece> const &pieces, std::string &out) {
+    out.resize(4 + pieces.size() * kRecordSize);
+    char *ptr = out.data();
+    ptr = WriteU32((u32)pieces.size(), ptr);
+    for (StructurePiece const &piece : pieces) {
+      ptr = WriteU32((u32)piece.fVolume.fStart.fX, ptr);
+      ptr = WriteU32((u32)piece.fVolume.fStart.fY, ptr);
+      ptr = WriteU32((u32)piece.fVolume.fStart.fZ, ptr);
+      ptr = WriteU32((u32)piece.fVolume.fEnd.fX, ptr);
+      ptr = WriteU32((u32)piece.fVolume.fEnd.fY, ptr);
+      ptr = WriteU32((u32)piece.fVolume.fEnd.fZ, ptr);
+      *ptr = (char)piece.fType;
+      ptr++;
+    }
+  }
+
+private:
+  static char *WriteU32(u32 v, char *out) {
+    out[0] = (char)(v & 0xff);
+    out[1] = (char)((v >> 8) & 0xff);
+    out[2] = (char)((v >> 16) & 0xff);
+    out[3] = (char)((v >> 24) & 0xff);
+    return out + 4;
+  }
+
+  // Six i32 for the volume, and an u8 for the type
+  static constexpr size_t kRecordSize = 6 * 4 + 1;
 };
 
 } // namespace je2be
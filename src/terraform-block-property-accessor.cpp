@@ -313,6 +313,7 @@ public:
 BlockPropertyAccessorBedrock::BlockPropertyAccessorBedrock(mcfile::be::Chunk const &chunk) : BlockPropertyAccessor(chunk.fChunkX, chunk.fChunkY, chunk.fChunkZ), fChunk(chunk) {
   using namespace std;
   fSections.resize(chunk.fSubChunks.size());
+  fSectionProperties.resize(chunk.fSubChunks.size(), 0);
   for (int i = 0; i < chunk.fSubChunks.size(); i++) {
     auto const &section = chunk.fSubChunks[i];
     if (!section) {
@@ -324,6 +325,7 @@ BlockPropertyAccessorBedrock::BlockPropertyAccessorBedrock(mcfile::be::Chunk con
       auto p = BlockProperties(*blockB);
       updateHasProperties(p);
       fSections[i][j] = p;
+      fSectionProperties[i] |= u32(1) << p;
     }
   }
 }
@@ -366,6 +368,7 @@ BlockPropertyAccessor::DataType BlockPropertyAccessorBedrock::property(int bx, i
 BlockPropertyAccessorJava::BlockPropertyAccessorJava(mcfile::je::Chunk const &chunk) : BlockPropertyAccessor(chunk.fChunkX, chunk.fChunkY, chunk.fChunkZ), fChunk(chunk) {
   using namespace std;
   fSections.resize(chunk.fSections.size());
+  fSectionProperties.resize(chunk.fSections.size(), 0);
   for (int i = 0; i < chunk.fSections.size(); i++) {
     auto const &section = chunk.fSections[i];
     if (!section) {
@@ -375,6 +378,7 @@ BlockPropertyAccessorJava::BlockPropertyAccessorJava(mcfile::je::Chunk const &ch
       auto p = BlockProperties(*blockJ);
       updateHasProperties(p);
       fSections[i].push_back(p);
+      fSectionProperties[i] |= u32(1) << p;
       return true;
     });
   }
@@ -390,6 +394,35 @@ int BlockPropertyAccessorJava::maxBlockY() const {
   return fChunk.maxBlockY();
 }
 
+void BlockPropertyAccessorBedrock::collectPositions(int sectionIndex, u32 mask, std::vector<Position> &out) const {
+  auto const &section = fChunk.fSubChunks[sectionIndex];
+  if (!section) {
+    return;
+  }
+  auto const &properties = fSections[sectionIndex];
+  auto const &indices = section->fPaletteIndices;
+  int const x0 = fChunkX * 16;
+  int const y0 = (fChunkY + sectionIndex) * 16;
+  int const z0 = fChunkZ * 16;
+  for (int ly = 0; ly < 16; ly++) {
+    for (int lz = 0; lz < 16; lz++) {
+      for (int lx = 0; lx < 16; lx++) {
+        int index = mcfile::be::SubChunk::BlockIndex(lx, ly, lz);
+        if (indices.size() <= index) {
+          continue;
+        }
+        auto i = indices[index];
+        if (properties.size() <= i) {
+          continue;
+        }
+        if ((mask >> properties[i]) & 1) {
+          out.push_back({x0 + lx, y0 + ly, z0 + lz});
+        }
+      }
+    }
+  }
+}
+
 BlockPropertyAccessor::DataType BlockPropertyAccessorJava::property(int bx, int by, int bz) const {
   using namespace mcfile;
   using namespace mcfile::be;
@@ -418,6 +451,46 @@ BlockPropertyAccessor::DataType BlockPropertyAccessorJava::property(int bx, int
   }
 }
 
+void BlockPropertyAccessorJava::collectPositions(int sectionIndex, u32 mask, std::vector<Position> &out) const {
+  auto const &section = fChunk.fSections[sectionIndex];
+  if (!section) {
+    return;
+  }
+  auto const &properties = fSections[sectionIndex];
+  int const x0 = fChunkX * 16;
+  int const y0 = (fChunkY + sectionIndex) * 16;
+  int const z0 = fChunkZ * 16;
+  for (int ly = 0; ly < 16; ly++) {
+    for (int lz = 0; lz < 16; lz++) {
+      for (int lx = 0; lx < 16; lx++) {
+        auto index = section->blockPaletteIndexAt(lx, ly, lz);
+        if (!index || *index < 0 || properties.size() <= *index) {
+          continue;
+        }
+        if ((mask >> properties[*index]) & 1) {
+          out.push_back({x0 + lx, y0 + ly, z0 + lz});
+        }
+      }
+    }
+  }
+}
+
+std::vector<BlockPropertyAccessor::Position> BlockPropertyAccessor::positions(std::initializer_list<DataType> properties) const {
+  using namespace std;
+  u32 mask = 0;
+  for (DataType p : properties) {
+    mask |= u32(1) << p;
+  }
+  vector<Position> ret;
+  for (int i = 0; i < fSectionProperties.size(); i++) {
+    if ((fSectionProperties[i] & mask) == 0) {
+      continue;
+    }
+    collectPositions(i, mask, ret);
+  }
+  return ret;
+}
+
 BlockPropertyAccessor::DataType BlockPropertyAccessor::BlockProperties(mcfile::be::Block const &b) {
   return Impl::GetBlockProperties(b);
 }
@@ -20,39 +20,29 @@ public:
     if (!accessor.fHasFence) {
       return;
     }
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
 
     static vector<pair<u8string, Pos2i>> const nesw({{u8"north", Pos2i(0, -1)}, {u8"east", Pos2i(1, 0)}, {u8"south", Pos2i(0, 1)}, {u8"west", Pos2i(-1, 0)}});
 
-    for (int y = accessor.minBlockY(); y <= accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          if (p != BlockPropertyAccessor::FENCE) {
-            continue;
-          }
-          auto blockJ = out.blockAt(x, y, z);
-          if (!blockJ) {
-            continue;
-          }
-          map<u8string, optional<u8string>> props;
-          Pos2i const pos(x, z);
-          for (auto const &it : nesw) {
-            Pos2i direction = it.second;
-            Pos2i targetPos = pos + direction;
-            auto target = cache.blockAt(targetPos.fX, y, targetPos.fZ);
-            if (target) {
-              props[it.first] = ToString(IsFenceConnectable(*blockJ, *target, direction));
-            } else {
-              props[it.first] = ToString(false);
-            }
-          }
-          auto replace = blockJ->applying(props);
-          out.setBlockAt(x, y, z, replace);
+    accessor.forEach(BlockPropertyAccessor::FENCE, 0, 0, [&](int x, int y, int z) {
+      auto blockJ = out.blockAt(x, y, z);
+      if (!blockJ) {
+        return;
+      }
+      map<u8string, optional<u8string>> props;
+      Pos2i const center(x, z);
+      for (auto const &it : nesw) {
+        Pos2i direction = it.second;
+        Pos2i targetPos = center + direction;
+        auto target = cache.blockAt(targetPos.fX, y, targetPos.fZ);
+        if (target) {
+          props[it.first] = ToString(IsFenceConnectable(*blockJ, *target, direction));
+        } else {
+          props[it.first] = ToString(false);
         }
       }
-    }
+      auto replace = blockJ->applying(props);
+      out.setBlockAt(x, y, z, replace);
+    });
   }
 
   static std::u8string ToString(bool b) {
@@ -97,39 +87,29 @@ public:
     if (!accessor.fHasGlassPaneOrMetalBars) {
       return;
     }
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
 
     static vector<pair<u8string, Pos2i>> const nesw({{u8"north", Pos2i(0, -1)}, {u8"east", Pos2i(1, 0)}, {u8"south", Pos2i(0, 1)}, {u8"west", Pos2i(-1, 0)}});
 
-    for (int y = accessor.minBlockY(); y <= accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          if (p != BlockPropertyAccessor::GLASS_PANE_OR_METAL_BARS) {
-            continue;
-          }
-          auto blockJ = out.blockAt(x, y, z);
-          if (!blockJ) {
-            continue;
-          }
-          map<u8string, optional<u8string>> props;
-          Pos2i const pos(x, z);
-          for (auto const &it : nesw) {
-            Pos2i direction = it.second;
-            Pos2i targetPos = pos + direction;
-            auto target = cache.blockAt(targetPos.fX, y, targetPos.fZ);
-            if (target) {
-              props[it.first] = ToString(IsGlassPaneOrIronBarsConnectable(*target, direction));
-            } else {
-              props[it.first] = ToString(false);
-            }
-          }
-          auto replace = blockJ->applying(props);
-          out.setBlockAt(x, y, z, replace);
+    accessor.forEach(BlockPropertyAccessor::GLASS_PANE_OR_METAL_BARS, 0, 0, [&](int x, int y, int z) {
+      auto blockJ = out.blockAt(x, y, z);
+      if (!blockJ) {
+        return;
+      }
+      map<u8string, optional<u8string>> props;
+      Pos2i const center(x, z);
+      for (auto const &it : nesw) {
+        Pos2i direction = it.second;
+        Pos2i targetPos = center + direction;
+        auto target = cache.blockAt(targetPos.fX, y, targetPos.fZ);
+        if (target) {
+          props[it.first] = ToString(IsGlassPaneOrIronBarsConnectable(*target, direction));
+        } else {
+          props[it.first] = ToString(false);
         }
       }
-    }
+      auto replace = blockJ->applying(props);
+      out.setBlockAt(x, y, z, replace);
+    });
   }
 
   static bool IsGlassPaneOrIronBarsConnectable(mcfile::je::Block const &target, Pos2i const &targetDirection) {
@@ -4,6 +4,7 @@
 #include "_data3d.hpp"
 #include "_volume.hpp"
 #include "java/_block-data.hpp"
+#include "terraform/_block-window.hpp"
 
 namespace je2be::terraform {
 
@@ -11,8 +12,8 @@ class Leaves::Impl {
   Impl() = delete;
 
 public:
-  template <class Block>
-  static void Do(mcfile::je::Chunk &out, BlockAccessor<Block> &cache, BlockPropertyAccessor const &accessor) {
+  template <class Cache>
+  static void Do(mcfile::je::Chunk &out, Cache &cache, BlockPropertyAccessor const &accessor) {
     using namespace std;
 
     enum Distance : i8 {
@@ -67,7 +68,7 @@ public:
           if (data.get(p) == Leaves) {
             continue;
           }
-          shared_ptr<Block const> block = cache.blockAt(p.fX, p.fY, p.fZ);
+          auto block = cache.blockAt(p.fX, p.fY, p.fZ);
           if (!block) {
             continue;
           }
@@ -196,4 +197,8 @@ void Leaves::Do(mcfile::je::Chunk &out, BlockAccessor<mcfile::be::Block> &cache,
   Impl::Do(out, cache, accessor);
 }
 
+void Leaves::Do(mcfile::je::Chunk &out, BlockWindow<mcfile::je::Block, 3, 3> const &window, BlockPropertyAccessor const &accessor) {
+  Impl::Do(out, window, accessor);
+}
+
 } // namespace je2be::terraform
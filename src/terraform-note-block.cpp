@@ -18,56 +18,45 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY() + 1; y <= accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          if (p != BlockPropertyAccessor::NOTE_BLOCK) {
-            continue;
-          }
-          auto blockJ = out.blockAt(x, y, z);
-          if (!blockJ) {
-            continue;
-          }
-          u8string instrument = u8"harp";
-          auto lowerJ = out.blockAt(x, y - 1, z);
-          if (lowerJ) {
-            instrument = NoteBlockInstrument(lowerJ->fId);
-          }
-          auto upperJ = out.blockAt(x, y + 1, z);
-          if (upperJ) {
-            switch (upperJ->fId) {
-            case minecraft::skeleton_skull:
-              instrument = u8"skeleton";
-              break;
-            case minecraft::wither_skeleton_skull:
-              instrument = u8"wither_skeleton";
-              break;
-            case minecraft::player_head:
-              instrument = u8"custom_head";
-              break;
-            case minecraft::zombie_head:
-              instrument = u8"zombie";
-              break;
-            case minecraft::creeper_head:
-              instrument = u8"creeper";
-              break;
-            case minecraft::piglin_head:
-              instrument = u8"piglin";
-              break;
-            case minecraft::dragon_head:
-              instrument = u8"dragon";
-              break;
-            }
-          }
-          auto replace = blockJ->applying({{u8"instrument", instrument}});
-          out.setBlockAt(x, y, z, replace);
+    accessor.forEach(BlockPropertyAccessor::NOTE_BLOCK, 1, 0, [&](int x, int y, int z) {
+      auto blockJ = out.blockAt(x, y, z);
+      if (!blockJ) {
+        return;
+      }
+      u8string instrument = u8"harp";
+      auto lowerJ = out.blockAt(x, y - 1, z);
+      if (lowerJ) {
+        instrument = NoteBlockInstrument(lowerJ->fId);
+      }
+      auto upperJ = out.blockAt(x, y + 1, z);
+      if (upperJ) {
+        switch (upperJ->fId) {
+        case minecraft::skeleton_skull:
+          instrument = u8"skeleton";
+          break;
+        case minecraft::wither_skeleton_skull:
+          instrument = u8"wither_skeleton";
+          break;
+        case minecraft::player_head:
+          instrument = u8"custom_head";
+          break;
+        case minecraft::zombie_head:
+          instrument = u8"zombie";
+          break;
+        case minecraft::creeper_head:
+          instrument = u8"creeper";
+          break;
+        case minecraft::piglin_head:
+          instrument = u8"piglin";
+          break;
+        case minecraft::dragon_head:
+          instrument = u8"dragon";
+          break;
         }
       }
-    }
+      auto replace = blockJ->applying({{u8"instrument", instrument}});
+      out.setBlockAt(x, y, z, replace);
+    });
   }
 
   static std::u8string NoteBlockInstrumentAutogenCode(mcfile::blocks::BlockId id) {
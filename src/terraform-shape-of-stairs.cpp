@@ -15,70 +15,57 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY(); y <= accessor.maxBlockY(); y++) {
-      for (int lz = 0; lz < 16; lz++) {
-        int z = cz * 16 + lz;
-        for (int lx = 0; lx < 16; lx++) {
-          int x = cx * 16 + lx;
-          auto p = accessor.property(x, y, z);
-          if (p != BlockPropertyAccessor::STAIRS) {
-            continue;
-          }
-          auto stairs = StairsBlockData(dataAccessor, x, y, z);
-          assert(stairs);
-          if (!stairs) {
-            continue;
-          }
-          auto direction = stairs->facing();
-          auto upsideDown = stairs->half();
-          auto blockJ = out.blockAt(x, y, z);
-          if (!blockJ) {
-            continue;
-          }
-
-          Pos2i vec = VecFromWeirdoDirection(direction);
-          optional<mcfile::blocks::data::Directional::BlockFace> outerWeirdoDirection;
-          optional<mcfile::blocks::data::Directional::BlockFace> innerWeirdoDirection;
-          optional<mcfile::blocks::data::Directional::BlockFace> leftWeirdoDirection;
-          optional<mcfile::blocks::data::Directional::BlockFace> rightWeirdoDirection;
-
-          Pos2i outer = Pos2i(x, z) + vec;
-          if (auto outerBlock = StairsBlockData(dataAccessor, outer.fX, y, outer.fZ); outerBlock) {
-            if (upsideDown == outerBlock->half()) {
-              outerWeirdoDirection = outerBlock->facing();
-            }
-          }
-
-          Pos2i inner = Pos2i(x, z) + Pos2i(-vec.fX, -vec.fZ);
-          if (auto innerBlock = StairsBlockData(dataAccessor, inner.fX, y, inner.fZ); innerBlock) {
-            if (upsideDown == innerBlock->half()) {
-              innerWeirdoDirection = innerBlock->facing();
-            }
-          }
-
-          Pos2i left = Pos2i(x, z) + Left90(vec);
-          if (auto leftBlock = StairsBlockData(dataAccessor, left.fX, y, left.fZ); leftBlock) {
-            if (upsideDown == leftBlock->half()) {
-              leftWeirdoDirection = leftBlock->facing();
-            }
-          }
-
-          Pos2i right = Pos2i(x, z) + Right90(vec);
-          if (auto rightBlock = StairsBlockData(dataAccessor, right.fX, y, right.fZ); rightBlock) {
-            if (upsideDown == rightBlock->half()) {
-              rightWeirdoDirection = rightBlock->facing();
-            }
-          }
-
-          auto shape = Shape(direction, outerWeirdoDirection, innerWeirdoDirection, leftWeirdoDirection, rightWeirdoDirection);
-          auto newBlock = blockJ->applying({{u8"shape", shape}});
-          out.setBlockAt(x, y, z, newBlock);
+    accessor.forEach(BlockPropertyAccessor::STAIRS, 0, 0, [&](int x, int y, int z) {
+      auto stairs = StairsBlockData(dataAccessor, x, y, z);
+      assert(stairs);
+      if (!stairs) {
+        return;
+      }
+      auto direction = stairs->facing();
+      auto upsideDown = stairs->half();
+      auto blockJ = out.blockAt(x, y, z);
+      if (!blockJ) {
+        return;
+      }
+
+      Pos2i vec = VecFromWeirdoDirection(direction);
+      optional<mcfile::blocks::data::Directional::BlockFace> outerWeirdoDirection;
+      optional<mcfile::blocks::data::Directional::BlockFace> innerWeirdoDirection;
+      optional<mcfile::blocks::data::Directional::BlockFace> leftWeirdoDirection;
+      optional<mcfile::blocks::data::Directional::BlockFace> rightWeirdoDirection;
+
+      Pos2i outer = Pos2i(x, z) + vec;
+      if (auto outerBlock = StairsBlockData(dataAccessor, outer.fX, y, outer.fZ); outerBlock) {
+        if (upsideDown == outerBlock->half()) {
+          outerWeirdoDirection = outerBlock->facing();
         }
       }
-    }
+
+      Pos2i inner = Pos2i(x, z) + Pos2i(-vec.fX, -vec.fZ);
+      if (auto innerBlock = StairsBlockData(dataAccessor, inner.fX, y, inner.fZ); innerBlock) {
+        if (upsideDown == innerBlock->half()) {
+          innerWeirdoDirection = innerBlock->facing();
+        }
+      }
+
+      Pos2i left = Pos2i(x, z) + Left90(vec);
+      if (auto leftBlock = StairsBlockData(dataAccessor, left.fX, y, left.fZ); leftBlock) {
+        if (upsideDown == leftBlock->half()) {
+          leftWeirdoDirection = leftBlock->facing();
+        }
+      }
+
+      Pos2i right = Pos2i(x, z) + Right90(vec);
+      if (auto rightBlock = StairsBlockData(dataAccessor, right.fX, y, right.fZ); rightBlock) {
+        if (upsideDown == rightBlock->half()) {
+          rightWeirdoDirection = rightBlock->facing();
+        }
+      }
+
+      auto shape = Shape(direction, outerWeirdoDirection, innerWeirdoDirection, leftWeirdoDirection, rightWeirdoDirection);
+      auto newBlock = blockJ->applying({{u8"shape", shape}});
+      out.setBlockAt(x, y, z, newBlock);
+    });
   }
 
   static std::u8string Shape(mcfile::blocks::data::Directional::BlockFace direction,
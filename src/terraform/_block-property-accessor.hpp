@@ -5,6 +5,7 @@
 #include "_mcfile-fwd.hpp"
 
 #include <cstdint>
+#include <initializer_list>
 #include <vector>
 
 namespace je2be::terraform {
@@ -42,6 +43,12 @@ public:
     DOUBLE_PLANT_UPPER_SUNFLOWER = 25,
   };
 
+  struct Position {
+    int fX;
+    int fY;
+    int fZ;
+  };
+
 public:
   static DataType BlockProperties(mcfile::be::Block const &b);
   static DataType BlockProperties(mcfile::je::Block const &b);
@@ -54,6 +61,24 @@ public:
 
   void updateHasProperties(DataType p);
 
+  // Returns the positions of blocks having one of the properties, in ascending (y, z, x) order.
+  // Sections whose palette has none of the properties are skipped without looking at their blocks.
+  std::vector<Position> positions(std::initializer_list<DataType> properties) const;
+
+  // Calls `func(x, y, z)` for each block having `property`, in the same order as positions. `below` and `above` are how far under and
+  // over the block the pass looks: blocks closer than that to the bottom or top of the chunk are skipped.
+  template <class Func>
+  void forEach(DataType property, int below, int above, Func &&func) const {
+    int const minY = minBlockY() + below;
+    int const maxY = maxBlockY() - above;
+    for (auto const &pos : positions({property})) {
+      if (pos.fY < minY || maxY < pos.fY) {
+        continue;
+      }
+      func(pos.fX, pos.fY, pos.fZ);
+    }
+  }
+
   static bool IsChorusPlant(mcfile::je::Block const &b);
   static bool IsLeaves(mcfile::je::Block const &b);
   static bool IsLeaves(mcfile::be::Block const &b);
@@ -84,8 +109,13 @@ public:
   bool fHasBed = false;
   bool fHasDoublePlantUpperSunflower = false;
 
+protected:
+  virtual void collectPositions(int sectionIndex, u32 mask, std::vector<Position> &out) const = 0;
+
 protected:
   std::vector<std::vector<DataType>> fSections;
+  // Bit p is set when the palette of the section contains a block having property p
+  std::vector<u32> fSectionProperties;
   int const fChunkX;
   int const fChunkY;
   int const fChunkZ;
@@ -102,6 +132,9 @@ public:
 
   int maxBlockY() const override;
 
+protected:
+  void collectPositions(int sectionIndex, u32 mask, std::vector<Position> &out) const override;
+
 private:
   mcfile::be::Chunk const &fChunk;
 };
@@ -117,6 +150,9 @@ public:
 
   int maxBlockY() const override;
 
+protected:
+  void collectPositions(int sectionIndex, u32 mask, std::vector<Position> &out) const override;
+
 private:
   mcfile::je::Chunk const &fChunk;
 };
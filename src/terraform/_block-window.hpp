@@ -0,0 +1,201 @@
+#pragma once
+
+#include <je2be/integers.hpp>
+
+#include <minecraft-file.hpp>
+
+#include <type_traits>
+
+namespace je2be::terraform {
+
+// Read-only view of the blocks of Width x Height chunks, starting at chunk (fChunkX, fChunkZ).
+// Unlike BlockAccessor, lookups are not virtual and return pointers borrowed from the chunks, so they don't touch any reference
+// count. The window keeps the chunks alive. Palette indices of a section are unpacked into a flat array on first access, so that
+// lookups inside a section are plain array reads.
+// Sections are unpacked lazily, so a window must not be shared between threads.
+template <class Block, size_t Width = 3, size_t Height = 3>
+class BlockWindow {
+  static_assert(std::is_same_v<Block, mcfile::je::Block> || std::is_same_v<Block, mcfile::be::Block>);
+
+public:
+  using Chunk = std::conditional_t<std::is_same_v<Block, mcfile::je::Block>, mcfile::je::Chunk, mcfile::be::Chunk>;
+
+  class Section {
+  public:
+    static int Index(int lx, int ly, int lz) {
+      return (ly * 16 + lz) * 16 + lx;
+    }
+
+    // Palette index of the block. Blocks missing in the source section have the index of the trailing nullptr entry of the palette.
+    u16 paletteIndexAt(int lx, int ly, int lz) const {
+      return fIndices[Index(lx, ly, lz)];
+    }
+
+    Block const *blockAt(int lx, int ly, int lz) const {
+      return fPalette[fIndices[Index(lx, ly, lz)]];
+    }
+
+    std::vector<Block const *> const &palette() const {
+      return fPalette;
+    }
+
+    // Palette indices of the 4096 blocks, in the order of Index.
+    std::vector<u16> const &indices() const {
+      return fIndices;
+    }
+
+  private:
+    friend class BlockWindow;
+
+    std::vector<u16> fIndices;
+    std::vector<Block const *> fPalette;
+  };
+
+  BlockWindow(int cx, int cz) : fChunkX(cx), fChunkZ(cz), fColumns(Width * Height) {}
+
+  void set(std::shared_ptr<Chunk const> const &chunk) {
+    if (!chunk) {
+      return;
+    }
+    int x = chunk->fChunkX - fChunkX;
+    int z = chunk->fChunkZ - fChunkZ;
+    if (x < 0 || Width <= x || z < 0 || Height <= z) {
+      return;
+    }
+    Column &column = fColumns[z * Width + x];
+    column.fChunk = chunk;
+    column.fChunkY = chunk->fChunkY;
+    column.fSections.clear();
+    column.fSections.resize(SectionCount(*chunk));
+    column.fUnpacked.assign(column.fSections.size(), false);
+  }
+
+  Chunk const *chunkAt(int cx, int cz) const {
+    int x = cx - fChunkX;
+    int z = cz - fChunkZ;
+    if (x < 0 || Width <= x || z < 0 || Height <= z) {
+      return nullptr;
+    }
+    return fColumns[z * Width + x].fChunk.get();
+  }
+
+  // Returns nullptr when the chunk isn't loaded or the section doesn't exist.
+  Section const *sectionAt(int cx, int cy, int cz) const {
+    int x = cx - fChunkX;
+    int z = cz - fChunkZ;
+    if (x < 0 || Width <= x || z < 0 || Height <= z) {
+      return nullptr;
+    }
+    Column &column = fColumns[z * Width + x];
+    int y = cy - column.fChunkY;
+    if (y < 0 || column.fSections.size() <= y) {
+      return nullptr;
+    }
+    if (!column.fUnpacked[y]) {
+      column.fSections[y] = Unpack(*column.fChunk, cy);
+      column.fUnpacked[y] = true;
+    }
+    return column.fSections[y].get();
+  }
+
+  Block const *blockAt(int bx, int by, int bz) const {
+    Section const *section = sectionAt(bx >> 4, by >> 4, bz >> 4);
+    if (!section) {
+      return nullptr;
+    }
+    return section->blockAt(bx & 0xf, by & 0xf, bz & 0xf);
+  }
+
+private:
+  struct Column {
+    std::shared_ptr<Chunk const> fChunk;
+    int fChunkY = 0;
+    std::vector<std::unique_ptr<Section>> fSections;
+    std::vector<bool> fUnpacked;
+  };
+
+  static size_t SectionCount(mcfile::je::Chunk const &chunk) {
+    int count = 0;
+    for (auto const &section : chunk.fSections) {
+      if (section) {
+        count = (std::max)(count, section->y() - chunk.fChunkY + 1);
+      }
+    }
+    return count;
+  }
+
+  static size_t SectionCount(mcfile::be::Chunk const &chunk) {
+    return chunk.fSubChunks.size();
+  }
+
+  static std::unique_ptr<Section> Unpack(mcfile::je::Chunk const &chunk, int cy) {
+    using namespace std;
+    shared_ptr<mcfile::je::ChunkSection> source;
+    for (auto const &section : chunk.fSections) {
+      if (section && section->y() == cy) {
+        source = section;
+        break;
+      }
+    }
+    if (!source) {
+      return nullptr;
+    }
+    auto ret = make_unique<Section>();
+    source->eachBlockPalette([&ret](shared_ptr<mcfile::je::Block const> const &block, size_t) {
+      ret->fPalette.push_back(block.get());
+      return true;
+    });
+    u16 const missing = (u16)ret->fPalette.size();
+    ret->fPalette.push_back(nullptr);
+    ret->fIndices.resize(4096);
+    for (int y = 0; y < 16; y++) {
+      for (int z = 0; z < 16; z++) {
+        for (int x = 0; x < 16; x++) {
+          auto index = source->blockPaletteIndexAt(x, y, z);
+          ret->fIndices[Section::Index(x, y, z)] = index && *index < missing ? (u16)*index : missing;
+        }
+      }
+    }
+    return ret;
+  }
+
+  static std::unique_ptr<Section> Unpack(mcfile::be::Chunk const &chunk, int cy) {
+    using namespace std;
+    int i = cy - chunk.fChunkY;
+    if (i < 0 || chunk.fSubChunks.size() <= i) {
+      return nullptr;
+    }
+    auto const &source = chunk.fSubChunks[i];
+    if (!source) {
+      return nullptr;
+    }
+    auto ret = make_unique<Section>();
+    ret->fPalette.reserve(source->fPalette.size() + 1);
+    for (auto const &block : source->fPalette) {
+      ret->fPalette.push_back(block.get());
+    }
+    u16 const missing = (u16)source->fPalette.size();
+    ret->fPalette.push_back(nullptr);
+    auto const &indices = source->fPaletteIndices;
+    ret->fIndices.resize(4096);
+    for (int x = 0; x < 16; x++) {
+      for (int z = 0; z < 16; z++) {
+        for (int y = 0; y < 16; y++) {
+          size_t index = mcfile::be::SubChunk::BlockIndex(x, y, z);
+          u16 paletteIndex = index < indices.size() ? indices[index] : missing;
+          ret->fIndices[Section::Index(x, y, z)] = paletteIndex < missing ? paletteIndex : missing;
+        }
+      }
+    }
+    return ret;
+  }
+
+public:
+  int const fChunkX;
+  int const fChunkZ;
+
+private:
+  mutable std::vector<Column> fColumns;
+};
+
+} // namespace je2be::terraform
@@ -16,46 +16,35 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY(); y <= accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          if (p != BlockPropertyAccessor::CHORUS_PLANT) {
-            continue;
-          }
-          auto blockB = cache.blockAt(x, y, z);
-          if (!blockB) {
-            continue;
-          }
-          if (blockB->fName == u8"minecraft:chorus_flower") {
-            continue;
-          }
-          auto blockJ = out.blockAt(x, y, z);
-          if (!blockJ) {
-            continue;
-          }
-          auto up = accessor.property(x, y + 1, z) == BlockPropertyAccessor::CHORUS_PLANT;
-          auto down = cache.blockAt(x, y - 1, z);
-          auto north = cache.blockAt(x, y, z - 1);
-          auto east = cache.blockAt(x + 1, y, z);
-          auto south = cache.blockAt(x, y, z + 1);
-          auto west = cache.blockAt(x - 1, y, z);
-
-          auto replace = blockJ->applying({
-              {u8"up", up ? u8"true" : u8"false"},
-              {u8"down", IsChorusPlantConnectable(down)},
-              {u8"north", IsChorusPlantConnectable(north)},
-              {u8"east", IsChorusPlantConnectable(east)},
-              {u8"south", IsChorusPlantConnectable(south)},
-              {u8"west", IsChorusPlantConnectable(west)},
-          });
-          out.setBlockAt(x, y, z, replace);
-        }
+    accessor.forEach(BlockPropertyAccessor::CHORUS_PLANT, 0, 0, [&](int x, int y, int z) {
+      auto blockB = cache.blockAt(x, y, z);
+      if (!blockB) {
+        return;
       }
-    }
+      if (blockB->fName == u8"minecraft:chorus_flower") {
+        return;
+      }
+      auto blockJ = out.blockAt(x, y, z);
+      if (!blockJ) {
+        return;
+      }
+      auto up = accessor.property(x, y + 1, z) == BlockPropertyAccessor::CHORUS_PLANT;
+      auto down = cache.blockAt(x, y - 1, z);
+      auto north = cache.blockAt(x, y, z - 1);
+      auto east = cache.blockAt(x + 1, y, z);
+      auto south = cache.blockAt(x, y, z + 1);
+      auto west = cache.blockAt(x - 1, y, z);
+
+      auto replace = blockJ->applying({
+          {u8"up", up ? u8"true" : u8"false"},
+          {u8"down", IsChorusPlantConnectable(down)},
+          {u8"north", IsChorusPlantConnectable(north)},
+          {u8"east", IsChorusPlantConnectable(east)},
+          {u8"south", IsChorusPlantConnectable(south)},
+          {u8"west", IsChorusPlantConnectable(west)},
+      });
+      out.setBlockAt(x, y, z, replace);
+    });
   }
 
 private:
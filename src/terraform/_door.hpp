@@ -13,51 +13,43 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY(); y < accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto lowerP = accessor.property(x, y, z);
-          auto upperP = accessor.property(x, y + 1, z);
-          if (lowerP != BlockPropertyAccessor::DOOR || upperP != BlockPropertyAccessor::DOOR) {
-            continue;
-          }
-          auto lowerB = out.blockAt(x, y, z);
-          auto upperB = out.blockAt(x, y + 1, z);
-          if (!lowerB || !upperB) {
-            continue;
-          }
-          if (lowerB->fName != upperB->fName) {
-            continue;
-          }
-          auto lowerJ = out.blockAt(x, y, z);
-          auto upperJ = out.blockAt(x, y + 1, z);
-          if (!lowerJ || !upperJ) {
-            continue;
-          }
-          if (lowerJ->property(u8"half") != u8"lower" || upperJ->property(u8"half") != u8"upper") {
-            continue;
-          }
-          u8string facing(lowerJ->property(u8"facing"));
-          u8string open(lowerJ->property(u8"open"));
-          u8string hinge(upperJ->property(u8"hinge"));
-          if (facing.empty() || open.empty() || hinge.empty()) {
-            continue;
-          }
-
-          // NOTE: Doors in villages usually need this repair.
-          auto replaceUpper = upperJ->applying({
-              {u8"facing", facing},
-              {u8"open", open},
-          });
-          auto replaceLower = lowerJ->applying({{u8"hinge", hinge}});
-          out.setBlockAt(x, y, z, replaceLower);
-          out.setBlockAt(x, y + 1, z, replaceUpper);
-        }
+    accessor.forEach(BlockPropertyAccessor::DOOR, 0, 1, [&](int x, int y, int z) {
+      auto upperP = accessor.property(x, y + 1, z);
+      if (upperP != BlockPropertyAccessor::DOOR) {
+        return;
       }
-    }
+      auto lowerB = out.blockAt(x, y, z);
+      auto upperB = out.blockAt(x, y + 1, z);
+      if (!lowerB || !upperB) {
+        return;
+      }
+      if (lowerB->fName != upperB->fName) {
+        return;
+      }
+      auto lowerJ = out.blockAt(x, y, z);
+      auto upperJ = out.blockAt(x, y + 1, z);
+      if (!lowerJ || !upperJ) {
+        return;
+      }
+      if (lowerJ->property(u8"half") != u8"lower" || upperJ->property(u8"half") != u8"upper") {
+        return;
+      }
+      u8string facing(lowerJ->property(u8"facing"));
+      u8string open(lowerJ->property(u8"open"));
+      u8string hinge(upperJ->property(u8"hinge"));
+      if (facing.empty() || open.empty() || hinge.empty()) {
+        return;
+      }
+
+      // NOTE: Doors in villages usually need this repair.
+      auto replaceUpper = upperJ->applying({
+          {u8"facing", facing},
+          {u8"open", open},
+      });
+      auto replaceLower = lowerJ->applying({{u8"hinge", hinge}});
+      out.setBlockAt(x, y, z, replaceLower);
+      out.setBlockAt(x, y + 1, z, replaceUpper);
+    });
   }
 };
 
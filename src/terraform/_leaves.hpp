@@ -6,6 +6,9 @@
 
 namespace je2be::terraform {
 
+template <class Block, size_t Width, size_t Height>
+class BlockWindow;
+
 class Leaves {
   Leaves() = delete;
   class Impl;
@@ -13,6 +16,7 @@ class Leaves {
 public:
   static void Do(mcfile::je::Chunk &out, BlockAccessor<mcfile::je::Block> &cache, BlockPropertyAccessor const &accessor);
   static void Do(mcfile::je::Chunk &out, BlockAccessor<mcfile::be::Block> &cache, BlockPropertyAccessor const &accessor);
+  static void Do(mcfile::je::Chunk &out, BlockWindow<mcfile::je::Block, 3, 3> const &window, BlockPropertyAccessor const &accessor);
 };
 
 } // namespace je2be::terraform
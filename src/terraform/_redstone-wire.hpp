@@ -17,114 +17,103 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
+    accessor.forEach(BlockPropertyAccessor::REDSTONE_WIRE, 0, 0, [&](int x, int y, int z) {
+      auto blockJ = out.blockAt(x, y, z);
+      if (!blockJ) {
+        return;
+      }
+      map<u8string, optional<u8string>> props;
+
+      // Looking for redstone connectable block in same Y.
+      vector<pair<u8string, Pos2i>> const nesw({{u8"north", Pos2i(0, -1)}, {u8"east", Pos2i(1, 0)}, {u8"south", Pos2i(0, 1)}, {u8"west", Pos2i(-1, 0)}});
+      for (auto d : nesw) {
+        auto vec = d.second;
+        auto block = cache.blockAt(x + vec.fX, y, z + vec.fZ);
+        bool connect = false;
+        if (block) {
+          connect = IsRedstoneConnectable(*block, vec);
+        }
+        props[d.first] = connect ? u8"side" : u8"none";
+      }
 
-    for (int y = accessor.minBlockY(); y <= accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          if (p != BlockPropertyAccessor::REDSTONE_WIRE) {
-            continue;
-          }
-          auto blockJ = out.blockAt(x, y, z);
-          if (!blockJ) {
+      // Check Y + 1, NESW blocks when the upper block is transparent against redstone wire.
+      auto upperJ = cache.blockAt(x, y + 1, z);
+      bool transparentUpper = true;
+      if (upperJ) {
+        transparentUpper = IsTransparentAgainstRedstoneWire(*upperJ);
+      }
+      if (transparentUpper) {
+        for (auto d : nesw) {
+          Pos2i vec = d.second;
+          if (props[d.first] == u8"side") {
             continue;
           }
-          map<u8string, optional<u8string>> props;
-
-          // Looking for redstone connectable block in same Y.
-          vector<pair<u8string, Pos2i>> const nesw({{u8"north", Pos2i(0, -1)}, {u8"east", Pos2i(1, 0)}, {u8"south", Pos2i(0, 1)}, {u8"west", Pos2i(-1, 0)}});
-          for (auto d : nesw) {
-            auto vec = d.second;
-            auto block = cache.blockAt(x + vec.fX, y, z + vec.fZ);
-            bool connect = false;
-            if (block) {
-              connect = IsRedstoneConnectable(*block, vec);
-            }
-            props[d.first] = connect ? u8"side" : u8"none";
-          }
-
-          // Check Y + 1, NESW blocks when the upper block is transparent against redstone wire.
-          auto upperJ = cache.blockAt(x, y + 1, z);
-          bool transparentUpper = true;
-          if (upperJ) {
-            transparentUpper = IsTransparentAgainstRedstoneWire(*upperJ);
-          }
-          if (transparentUpper) {
-            for (auto d : nesw) {
-              Pos2i vec = d.second;
-              if (props[d.first] == u8"side") {
-                continue;
-              }
-              auto block = cache.blockAt(x + vec.fX, y + 1, z + vec.fZ);
-              if (block && block->fName == u8"minecraft:redstone_wire") {
-                auto side = cache.blockAt(x + vec.fX, y, z + vec.fZ);
-                if (side) {
-                  if (side->fName.find(u8"_slab") != string::npos && side->fName.find(u8"double") == string::npos) {
-                    props[d.first] = u8"side";
-                  } else {
-                    props[d.first] = u8"up";
-                  }
-                } else {
-                  props[d.first] = u8"side";
-                }
-              }
-            }
-          }
-
-          // Check Y - 1, NESW blocks when NESW block is transparent against redstone wire.
-          for (auto d : nesw) {
-            if (props[d.first] != u8"none") {
-              continue;
-            }
-            Pos2i vec = d.second;
-            auto sideJ = cache.blockAt(x + vec.fX, y, z + vec.fZ);
-            bool transparentSide = true;
-            if (sideJ) {
-              transparentSide = IsTransparentAgainstRedstoneWire(*sideJ);
-            }
-            if (transparentSide) {
-              auto lower = cache.blockAt(x + vec.fX, y - 1, z + vec.fZ);
-              if (lower && lower->fId == mcfile::blocks::minecraft::redstone_wire) {
+          auto block = cache.blockAt(x + vec.fX, y + 1, z + vec.fZ);
+          if (block && block->fName == u8"minecraft:redstone_wire") {
+            auto side = cache.blockAt(x + vec.fX, y, z + vec.fZ);
+            if (side) {
+              if (side->fName.find(u8"_slab") != string::npos && side->fName.find(u8"double") == string::npos) {
                 props[d.first] = u8"side";
+              } else {
+                props[d.first] = u8"up";
               }
-            }
-          }
-
-          // Change "none" to "side", if there are 3 "none" and 1 "side"/"up" properties.
-          int notNoneCount = 0;
-          int noneCount = 0;
-          u8string notNone;
-          for (auto d : nesw) {
-            if (props[d.first] == u8"none") {
-              noneCount++;
             } else {
-              notNoneCount++;
-              notNone = d.first;
+              props[d.first] = u8"side";
             }
           }
-          if (notNoneCount == 1 && noneCount == 3) {
-            if (notNone == u8"north") {
-              props[u8"south"] = u8"side";
-            } else if (notNone == u8"east") {
-              props[u8"west"] = u8"side";
-            } else if (notNone == u8"south") {
-              props[u8"north"] = u8"side";
-            } else if (notNone == u8"west") {
-              props[u8"east"] = u8"side";
-            }
-          } else if (noneCount == 4) {
-            for (auto it : nesw) {
-              props[it.first] = u8"side";
-            }
+        }
+      }
+
+      // Check Y - 1, NESW blocks when NESW block is transparent against redstone wire.
+      for (auto d : nesw) {
+        if (props[d.first] != u8"none") {
+          continue;
+        }
+        Pos2i vec = d.second;
+        auto sideJ = cache.blockAt(x + vec.fX, y, z + vec.fZ);
+        bool transparentSide = true;
+        if (sideJ) {
+          transparentSide = IsTransparentAgainstRedstoneWire(*sideJ);
+        }
+        if (transparentSide) {
+          auto lower = cache.blockAt(x + vec.fX, y - 1, z + vec.fZ);
+          if (lower && lower->fId == mcfile::blocks::minecraft::redstone_wire) {
+            props[d.first] = u8"side";
           }
+        }
+      }
 
-          auto replace = blockJ->applying(props);
-          out.setBlockAt(x, y, z, replace);
+      // Change "none" to "side", if there are 3 "none" and 1 "side"/"up" properties.
+      int notNoneCount = 0;
+      int noneCount = 0;
+      u8string notNone;
+      for (auto d : nesw) {
+        if (props[d.first] == u8"none") {
+          noneCount++;
+        } else {
+          notNoneCount++;
+          notNone = d.first;
         }
       }
-    }
+      if (notNoneCount == 1 && noneCount == 3) {
+        if (notNone == u8"north") {
+          props[u8"south"] = u8"side";
+        } else if (notNone == u8"east") {
+          props[u8"west"] = u8"side";
+        } else if (notNone == u8"south") {
+          props[u8"north"] = u8"side";
+        } else if (notNone == u8"west") {
+          props[u8"east"] = u8"side";
+        }
+      } else if (noneCount == 4) {
+        for (auto it : nesw) {
+          props[it.first] = u8"side";
+        }
+      }
+
+      auto replace = blockJ->applying(props);
+      out.setBlockAt(x, y, z, replace);
+    });
   }
 
   static bool IsRedstoneConnectable(mcfile::je::Block const &block, Pos2i direction) {
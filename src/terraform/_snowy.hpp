@@ -13,32 +13,21 @@ public:
       return;
     }
 
-    int cx = out.fChunkX;
-    int cz = out.fChunkZ;
-
-    for (int y = accessor.minBlockY(); y < accessor.maxBlockY(); y++) {
-      for (int z = cz * 16; z < cz * 16 + 16; z++) {
-        for (int x = cx * 16; x < cx * 16 + 16; x++) {
-          auto p = accessor.property(x, y, z);
-          if (p != BlockPropertyAccessor::SNOWY) {
-            continue;
-          }
-          auto upper = cache.blockAt(x, y + 1, z);
-          if (!upper) {
-            continue;
-          }
-          if (upper->fId != mcfile::blocks::minecraft::snow) {
-            continue;
-          }
-          auto blockJ = out.blockAt(x, y, z);
-          if (!blockJ) {
-            continue;
-          }
-          auto replace = blockJ->applying({{u8"snowy", u8"true"}});
-          out.setBlockAt(x, y, z, replace);
-        }
+    accessor.forEach(BlockPropertyAccessor::SNOWY, 0, 1, [&](int x, int y, int z) {
+      auto upper = cache.blockAt(x, y + 1, z);
+      if (!upper) {
+        return;
       }
-    }
+      if (upper->fId != mcfile::blocks::minecraft::snow) {
+        return;
+      }
+      auto blockJ = out.blockAt(x, y, z);
+      if (!blockJ) {
+        return;
+      }
+      auto replace = blockJ->applying({{u8"snowy", u8"true"}});
+      out.setBlockAt(x, y, z, replace);
+    });
   }
 };
 
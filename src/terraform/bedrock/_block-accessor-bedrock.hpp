@@ -6,6 +6,7 @@
 
 #include "_pos3.hpp"
 #include "terraform/_block-accessor.hpp"
+#include "terraform/_block-window.hpp"
 
 namespace je2be::terraform::bedrock {
 
@@ -84,6 +85,15 @@ public:
     return ret;
   }
 
+  template <size_t WindowWidth, size_t WindowHeight>
+  void populate(BlockWindow<mcfile::be::Block, WindowWidth, WindowHeight> &window) {
+    for (int z = 0; z < WindowHeight; z++) {
+      for (int x = 0; x < WindowWidth; x++) {
+        window.set(ensureLoadedAt(window.fChunkX + x, window.fChunkZ + z));
+      }
+    }
+  }
+
   void set(int cx, int cz, std::shared_ptr<mcfile::be::Chunk> const &chunk) {
     auto index = getIndex(cx, cz);
     if (!index) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "terraform/java/_block-accessor-java.hpp"
+#include "terraform/java/_chunk-cache.hpp"
 
 namespace je2be::terraform::java {
 
@@ -11,6 +12,11 @@ public:
       : fChunkX(cx), fChunkZ(cz), fCache(Width * Height), fCacheLoaded(Width * Height, false), fDir(directory) {
   }
 
+  // Chunks outside of the region of the central chunk are looked up through `chunkCache`
+  BlockAccessorJavaDirectory(int cx, int cz, std::filesystem::path const &directory, mcfile::Dimension dim, std::shared_ptr<ChunkCache> const &chunkCache)
+      : fChunkX(cx), fChunkZ(cz), fCache(Width * Height), fCacheLoaded(Width * Height, false), fDir(directory), fDim(dim), fChunkCache(chunkCache) {
+  }
+
   std::shared_ptr<mcfile::je::Block const> blockAt(int bx, int by, int bz) override {
     int cx = mcfile::Coordinate::ChunkFromBlock(bx);
     int cz = mcfile::Coordinate::ChunkFromBlock(bz);
@@ -48,11 +54,15 @@ public:
       return nullptr;
     }
     if (!fCacheLoaded[*idx]) {
-      int rx = mcfile::Coordinate::RegionFromChunk(cx);
-      int rz = mcfile::Coordinate::RegionFromChunk(cz);
-      auto file = fDir / mcfile::je::Region::GetDefaultRegionFileName(rx, rz);
-      if (auto region = mcfile::je::Region::MakeRegion(file, rx, rz); region) {
-        fCache[*idx] = region->chunkAt(cx, cz);
+      if (fChunkCache && !isInCentralRegion(cx, cz)) {
+        fCache[*idx] = fChunkCache->get(fDim, fDir, cx, cz);
+      } else {
+        int rx = mcfile::Coordinate::RegionFromChunk(cx);
+        int rz = mcfile::Coordinate::RegionFromChunk(cz);
+        auto file = fDir / mcfile::je::Region::GetDefaultRegionFileName(rx, rz);
+        if (auto region = mcfile::je::Region::MakeRegion(file, rx, rz); region) {
+          fCache[*idx] = region->chunkAt(cx, cz);
+        }
       }
       fCacheLoaded[*idx] = true;
     }
@@ -69,6 +79,14 @@ public:
     }
   }
 
+  // Whether the chunk is in the same region as the central chunk, which is the one being processed. Such chunks are read from the
+  // region file directly, so that ChunkCache only holds chunks of neighbor regions
+  bool isInCentralRegion(int cx, int cz) const {
+    int centerX = fChunkX + (int)Width / 2;
+    int centerZ = fChunkZ + (int)Height / 2;
+    return mcfile::Coordinate::RegionFromChunk(cx) == mcfile::Coordinate::RegionFromChunk(centerX) && mcfile::Coordinate::RegionFromChunk(cz) == mcfile::Coordinate::RegionFromChunk(centerZ);
+  }
+
   void set(std::shared_ptr<mcfile::je::Chunk> const &chunk) {
     if (!chunk) {
       return;
@@ -82,7 +100,7 @@ public:
   }
 
   BlockAccessorJavaDirectory<Width, Height> *makeRelocated(int cx, int cz) const {
-    auto ret = std::make_unique<BlockAccessorJavaDirectory<Width, Height>>(cx, cz, fDir);
+    auto ret = std::make_unique<BlockAccessorJavaDirectory<Width, Height>>(cx, cz, fDir, fDim, fChunkCache);
     for (int x = 0; x < Width; x++) {
       for (int z = 0; z < Height; z++) {
         auto idx = getIndex(fChunkX + x, fChunkZ + z);
@@ -103,6 +121,8 @@ private:
   std::vector<std::shared_ptr<mcfile::je::Chunk>> fCache;
   std::vector<bool> fCacheLoaded;
   std::filesystem::path fDir;
+  mcfile::Dimension fDim = mcfile::Dimension::Overworld;
+  std::shared_ptr<ChunkCache> fChunkCache;
 };
 
 } // namespace je2be::terraform::java
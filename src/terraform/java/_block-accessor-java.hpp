@@ -1,6 +1,7 @@
 #pragma once
 
 #include "terraform/_block-accessor.hpp"
+#include "terraform/_block-window.hpp"
 
 namespace je2be::terraform::java {
 
@@ -8,6 +9,15 @@ class BlockAccessorJava : public BlockAccessor<mcfile::je::Block> {
 public:
   virtual ~BlockAccessorJava() {}
   virtual std::shared_ptr<mcfile::je::Chunk> chunkAt(int cx, int cz) = 0;
+
+  template <size_t Width, size_t Height>
+  void populate(BlockWindow<mcfile::je::Block, Width, Height> &window) {
+    for (int z = 0; z < Height; z++) {
+      for (int x = 0; x < Width; x++) {
+        window.set(chunkAt(window.fChunkX + x, window.fChunkZ + z));
+      }
+    }
+  }
 };
 
 } // namespace je2be::terraform::java
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <minecraft-file.hpp>
+
+#include <je2be/pos2.hpp>
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+
+namespace je2be::terraform::java {
+
+// Parsed chunks shared by the workers of a terraform step, for the lookups BlockAccessorJavaDirectory makes outside of the region
+// being processed. Region files read through this cache must not be modified while it is in use, and the chunks it returns are
+// shared between threads, so they must be treated as read-only.
+// Chunks are dropped in least-recently-used order when there are more than `capacity` of them. Regions to be processed are
+// registered with retain(), and release() is called when one of them is done: the cached chunks no remaining region can look up
+// are dropped right away.
+class ChunkCache {
+public:
+  // `halo` is how far, in chunks, a region looks up chunks outside of it.
+  ChunkCache(int halo, size_t capacity) : fHalo(halo), fCapacity(capacity) {}
+
+  std::shared_ptr<mcfile::je::Chunk> get(mcfile::Dimension dim, std::filesystem::path const &directory, int cx, int cz) {
+    using namespace std;
+    Key key{dim, cx, cz};
+    {
+      lock_guard<mutex> lock(fMut);
+      if (auto found = fEntries.find(key); found != fEntries.end()) {
+        fOrder.splice(fOrder.begin(), fOrder, found->second.fOrder);
+        return found->second.fChunk;
+      }
+    }
+
+    shared_ptr<mcfile::je::Chunk> chunk;
+    int rx = mcfile::Coordinate::RegionFromChunk(cx);
+    int rz = mcfile::Coordinate::RegionFromChunk(cz);
+    auto file = directory / mcfile::je::Region::GetDefaultRegionFileName(rx, rz);
+    if (auto region = mcfile::je::Region::MakeRegion(file, rx, rz); region) {
+      chunk = region->chunkAt(cx, cz);
+    }
+
+    lock_guard<mutex> lock(fMut);
+    if (!isNeeded(key)) {
+      return chunk;
+    }
+    if (auto found = fEntries.find(key); found != fEntries.end()) {
+      // Loaded by another thread in the meantime
+      fOrder.splice(fOrder.begin(), fOrder, found->second.fOrder);
+      return found->second.fChunk;
+    }
+    fOrder.push_front(key);
+    fEntries[key] = Entry{chunk, fOrder.begin()};
+    while (fEntries.size() > fCapacity) {
+      fEntries.erase(fOrder.back());
+      fOrder.pop_back();
+    }
+    return chunk;
+  }
+
+  void retain(mcfile::Dimension dim, Pos2i const &region) {
+    std::lock_guard<std::mutex> lock(fMut);
+    fPending[dim].insert(region);
+  }
+
+  void release(mcfile::Dimension dim, Pos2i const &region) {
+    using namespace std;
+    lock_guard<mutex> lock(fMut);
+    fPending[dim].erase(region);
+    int x0 = region.fX * 32 - fHalo;
+    int z0 = region.fZ * 32 - fHalo;
+    int x1 = region.fX * 32 + 31 + fHalo;
+    int z1 = region.fZ * 32 + 31 + fHalo;
+    for (auto it = fEntries.begin(); it != fEntries.end();) {
+      Key const &key = it->first;
+      if (key.fDim == dim && x0 <= key.fChunkX && key.fChunkX <= x1 && z0 <= key.fChunkZ && key.fChunkZ <= z1 && !isNeeded(key)) {
+        fOrder.erase(it->second.fOrder);
+        it = fEntries.erase(it);
+      } else {
+        it++;
+      }
+    }
+  }
+
+private:
+  struct Key {
+    mcfile::Dimension fDim;
+    int fChunkX;
+    int fChunkZ;
+
+    bool operator<(Key const &other) const {
+      if (fDim != other.fDim) {
+        return fDim < other.fDim;
+      }
+      if (fChunkX != other.fChunkX) {
+        return fChunkX < other.fChunkX;
+      }
+      return fChunkZ < other.fChunkZ;
+    }
+  };
+
+  struct Entry {
+    std::shared_ptr<mcfile::je::Chunk> fChunk;
+    std::list<Key>::iterator fOrder;
+  };
+
+  // Whether a pending region can look up the chunk
+  bool isNeeded(Key const &key) const {
+    auto found = fPending.find(key.fDim);
+    if (found == fPending.end()) {
+      return false;
+    }
+    int rx0 = mcfile::Coordinate::RegionFromChunk(key.fChunkX - fHalo);
+    int rx1 = mcfile::Coordinate::RegionFromChunk(key.fChunkX + fHalo);
+    int rz0 = mcfile::Coordinate::RegionFromChunk(key.fChunkZ - fHalo);
+    int rz1 = mcfile::Coordinate::RegionFromChunk(key.fChunkZ + fHalo);
+    for (int rz = rz0; rz <= rz1; rz++) {
+      for (int rx = rx0; rx <= rx1; rx++) {
+        if (found->second.count(Pos2i(rx, rz)) > 0) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+private:
+  int const fHalo;
+  size_t const fCapacity;
+  std::mutex fMut;
+  std::map<Key, Entry> fEntries;
+  std::list<Key> fOrder;
+  std::map<mcfile::Dimension, std::unordered_set<Pos2i, Pos2iHasher>> fPending;
+};
+
+} // namespace je2be::terraform::java
@@ -9,7 +9,7 @@
 #include "enums/_facing4.hpp"
 #include "enums/_facing6.hpp"
 #include "terraform/_block-property-accessor.hpp"
-#include "terraform/java/_block-accessor-java.hpp"
+#include "terraform/_block-window.hpp"
 #include "terraform/lighting/_chunk-light-cache.hpp"
 #include "terraform/lighting/_light-cache.hpp"
 
@@ -17,7 +17,7 @@ namespace je2be::terraform::lighting {
 
 class Lighting {
 public:
-  static void Do(mcfile::Dimension dim, mcfile::je::Chunk &out, terraform::java::BlockAccessorJava &blockAccessor, LightCache &cache) {
+  static void Do(mcfile::Dimension dim, mcfile::je::Chunk &out, BlockWindow<mcfile::je::Block, 3, 3> const &window, LightCache &cache) {
     using namespace std;
     using namespace mcfile;
 
@@ -33,7 +33,7 @@ public:
     size_t const height = maxBlockY - minBlockY + 1;
 
     Data3dSq<LightingModel, 44> models(chunkOrigin, height, LightingModel(CLEAR));
-    EnsureLightingModels(cache, models, cx, minChunkY, cz, blockAccessor);
+    EnsureLightingModels(cache, models, cx, minChunkY, cz, window);
 
     shared_ptr<Data3dSq<u8, 44>> skyLight;
     Data2d<optional<Volume>> skyVolumes({cx - 1, cz - 1}, 3, 3, nullopt);
@@ -189,7 +189,7 @@ private:
       int cx,
       int cy,
       int cz,
-      terraform::java::BlockAccessorJava &blockAccessor) {
+      BlockWindow<mcfile::je::Block, 3, 3> const &window) {
     using namespace std;
 
     for (int dz = -1; dz <= 1; dz++) {
@@ -198,9 +198,9 @@ private:
         if (auto cachedModel = lightCache.getModel(cx + dx, cz + dz); cachedModel) {
           chunkModel = cachedModel;
         } else {
-          auto chunk = blockAccessor.chunkAt(cx + dx, cz + dz);
+          auto chunk = window.chunkAt(cx + dx, cz + dz);
           if (chunk) {
-            chunkModel = CreateChunkLightingModel(*chunk, cy);
+            chunkModel = CreateChunkLightingModel(window, *chunk, cy);
             lightCache.setModel(cx + dx, cz + dz, chunkModel);
           }
         }
@@ -631,7 +631,7 @@ private:
     }
   }
 
-  static std::shared_ptr<ChunkLightingModel> CreateChunkLightingModel(mcfile::je::Chunk const &chunk, int minChunkY) {
+  static std::shared_ptr<ChunkLightingModel> CreateChunkLightingModel(BlockWindow<mcfile::je::Block, 3, 3> const &window, mcfile::je::Chunk const &chunk, int minChunkY) {
     using namespace std;
 
     auto ret = make_shared<ChunkLightingModel>(chunk.fChunkX, minChunkY, chunk.fChunkZ);
@@ -640,23 +640,21 @@ private:
       if (!section) {
         continue;
       }
+      auto unpacked = window.sectionAt(chunk.fChunkX, section->y(), chunk.fChunkZ);
+      if (!unpacked) {
+        continue;
+      }
       auto s = make_shared<ChunkLightingModel::Section>();
       vector<LightingModel> palette;
-      section->eachBlockPalette([&](shared_ptr<mcfile::je::Block const> const &block, size_t) {
-        palette.push_back(GetLightingModel(*block));
-        return true;
-      });
-      vector<u16> index;
-      index.resize(4096);
-      for (int y = 0; y < 16; y++) {
-        for (int z = 0; z < 16; z++) {
-          for (int x = 0; x < 16; x++) {
-            if (auto i = section->blockPaletteIndexAt(x, y, z); i) {
-              index[(y * 16 + z) * 16 + x] = *i;
-            }
-          }
+      for (auto block : unpacked->palette()) {
+        if (block) {
+          palette.push_back(GetLightingModel(*block));
+        } else {
+          // Blocks missing in the section are given the first entry of the palette
+          palette.push_back(palette.empty() ? LightingModel(CLEAR) : palette[0]);
         }
       }
+      vector<u16> index = unpacked->indices();
       s->reset(palette, index);
       ret->setSection(section->y(), s);
     }
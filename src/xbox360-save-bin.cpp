@@ -18,12 +18,11 @@ public:
     }
     // u32 inputSize = mcfile::U32FromBE(Mem::Read<u32>(buffer, 0));
     u32 outputSize = mcfile::U32FromBE(mcfile::Mem::Read<u32>(buffer, 8));
-    for (int i = 0; i < 12; i++) {
-      buffer.erase(buffer.begin());
-    }
-    if (lce::detail::LzxDecoder::Decode(buffer) != outputSize) {
+    vector<u8> out;
+    if (lce::detail::LzxDecoder::Decode(span<u8 const>(buffer).subspan(12), out, outputSize) != outputSize) {
       return false;
     }
+    buffer.swap(out);
     return true;
   }
 
@@ -46,16 +45,20 @@ public:
     namespace fs = std::filesystem;
 
     try {
-      auto pkg = make_unique<xbox360::detail::StfsPackage>(new xbox360::detail::FileIO2(saveBinFile));
+      unique_ptr<xbox360::detail::BaseIO> io;
+      if (auto mapped = MappedFile::Open(saveBinFile); mapped) {
+        io.reset(new xbox360::detail::MappedFileIO(std::move(mapped)));
+      } else {
+        io.reset(new xbox360::detail::FileIO2(saveBinFile));
+      }
+      auto pkg = make_unique<xbox360::detail::StfsPackage>(io.release());
 
       auto listing = pkg->GetFileListing();
       auto entry = FindSavegameFileEntry(listing);
       if (!entry) {
         return nullopt;
       }
-      xbox360::detail::MemoryIO out;
-      pkg->Extract(entry, out);
-      out.Drain(buffer);
+      pkg->Extract(entry, buffer);
 
       SaveBin::SavegameInfo info;
       info.fCreatedTime = TimePointFromFatTimestamp(entry->createdTimeStamp);
@@ -2,20 +2,20 @@
 
 #include <je2be/lce/behavior.hpp>
 
-#include "_directory-iterator.hpp"
 #include "lce/_lzx-decoder.hpp"
+#include "lce/_savegame-files.hpp"
 
 namespace je2be::xbox360 {
 
 class ConverterBehavior : public je2be::lce::Behavior {
 public:
-  Status decompressChunk(std::vector<uint8_t> &buffer) const override {
+  Status decompressChunk(std::span<uint8_t const> buffer, std::vector<uint8_t> &out) const override {
     if (buffer.size() < 4) {
       return JE2BE_ERROR;
     }
     // u32 decompressedSize = mcfile::U32FromBE(Mem::Read<u32>(buffer, 0));
-    buffer.erase(buffer.begin(), buffer.begin() + 4);
-    size_t decodedSize = lce::detail::LzxDecoder::Decode(buffer);
+    out.clear();
+    size_t decodedSize = lce::detail::LzxDecoder::Decode(buffer.subspan(4), out);
     if (decodedSize == 0) {
       return JE2BE_ERROR;
     } else {
@@ -23,18 +23,15 @@ public:
     }
   }
 
-  Status loadPlayers(std::filesystem::path const &inputDirectory, std::map<std::filesystem::path, CompoundTagPtr> &outBuffer) const override {
-    auto playersFrom = inputDirectory / "players";
-
-    for (DirectoryIterator it(playersFrom); it.valid(); it.next()) {
-      if (!it->is_regular_file()) {
+  Status loadPlayers(je2be::lce::SavegameFiles const &files, std::map<std::filesystem::path, CompoundTagPtr> &outBuffer) const override {
+    for (auto const &name : files.list(u8"players")) {
+      auto stream = files.open(name);
+      if (!stream) {
         continue;
       }
-      auto path = it->path();
-      auto stream = std::make_shared<mcfile::stream::FileInputStream>(path);
       auto in = CompoundTag::Read(stream, mcfile::Encoding::Java);
       if (in) {
-        outBuffer[path] = in;
+        outBuffer[std::filesystem::path(name)] = in;
       }
     }
     return Status::Ok();
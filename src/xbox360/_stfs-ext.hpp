@@ -1,5 +1,7 @@
 #pragma once
 
+#include "_mapped-file.hpp"
+
 namespace je2be::xbox360::detail {
 
 class MemoryIO : public BaseIO {
@@ -66,6 +68,60 @@ private:
   u64 position = 0;
 };
 
+class MappedFileIO : public BaseIO {
+public:
+  explicit MappedFileIO(std::unique_ptr<MappedFile> &&file) : fFile(std::move(file)), fData(fFile->data()) {}
+
+  void SetPosition(u64 position, std::ios_base::seekdir dir = std::ios_base::beg) override {
+    u64 pos;
+    switch (dir) {
+    case std::ios_base::cur:
+      pos = fPosition + position;
+      break;
+    case std::ios_base::end:
+      pos = fData.size() + position;
+      break;
+    case std::ios_base::beg:
+    default:
+      pos = position;
+      break;
+    }
+    if (pos > fData.size()) {
+      throw std::string("MappedFileIO::SetPosition; index out of range");
+    }
+    fPosition = pos;
+  }
+
+  u64 GetPosition() override {
+    return fPosition;
+  }
+
+  u64 Length() override {
+    return fData.size();
+  }
+
+  void ReadBytes(u8 *outBuffer, u32 len) override {
+    if (fPosition + len > fData.size()) {
+      throw std::string("MappedFileIO::ReadBytes; index out of range");
+    }
+    std::copy_n(fData.data() + fPosition, len, outBuffer);
+    fPosition += len;
+  }
+
+  void WriteBytes(u8 *buffer, u32 len) override {
+    throw std::string("MappedFileIO::WriteBytes; unsupported operation");
+  }
+
+  void Flush() override {}
+
+  void Close() override {}
+
+private:
+  std::unique_ptr<MappedFile> fFile;
+  std::span<u8 const> fData;
+  u64 fPosition = 0;
+};
+
 class FileIO2 : public BaseIO {
 public:
   explicit FileIO2(std::filesystem::path const &path) : fStream(nullptr) {
@@ -1263,6 +1263,26 @@ public:
     out.Close();
   }
 
+  // Description: extract a file (by FileEntry) into memory. The data is read straight from the package into `out`, without intermediate buffers
+  void Extract(StfsFileEntry *entry, std::vector<u8> &out) {
+    if (entry->nameLen == 0) {
+      except.str(std::string());
+      except << "STFS: File '" << entry->name.c_str() << "' doesn't exist in the package.\n";
+      throw except.str();
+    }
+
+    std::vector<std::pair<u32, u32>> segments;
+    GetFileSegments(entry, segments);
+
+    out.resize(entry->fileSize);
+    u32 offset = 0;
+    for (auto const &[address, length] : segments) {
+      io->SetPosition(address);
+      io->ReadBytes(out.data() + offset, length);
+      offset += length;
+    }
+  }
+
   // Description: convert a block into an address in the file
   u32 BlockToAddress(u32 blockNum) {
     // check for invalid block number
@@ -1389,6 +1409,61 @@ private:
     writtenToFile = fileListing;
   }
 
+  // Description: list the (address, length) ranges holding the file's data, in order. Adjacent ranges are merged
+  void GetFileSegments(StfsFileEntry *entry, std::vector<std::pair<u32, u32>> &segments) {
+    auto push = [&segments](u32 address, u32 length) {
+      if (length == 0) {
+        return;
+      }
+      if (!segments.empty() && segments.back().first + segments.back().second == address) {
+        segments.back().second += length;
+      } else {
+        segments.push_back(std::make_pair(address, length));
+      }
+    };
+
+    u32 fileSize = entry->fileSize;
+    if (fileSize == 0) {
+      return;
+    }
+
+    if (entry->flags & 1) {
+      // all the blocks are consecutive, only the hash tables have to be skipped
+      u32 address = BlockToAddress(entry->startingBlockNum);
+      u32 blockCount = (ComputeLevel0BackingHashBlockNumber(entry->startingBlockNum) + blockStep[0]) - ((address - firstHashTableAddress) >> 0xC);
+      if ((u32)entry->blocksForFile <= blockCount) {
+        push(address, fileSize);
+        return;
+      }
+      push(address, blockCount << 0xC);
+      address += blockCount << 0xC;
+
+      u32 tempSize = fileSize - (blockCount << 0xC);
+      while (tempSize >= 0xAA000) {
+        address += GetHashTableSkipSize(address);
+        push(address, 0xAA000);
+        address += 0xAA000;
+        tempSize -= 0xAA000;
+      }
+      if (tempSize != 0) {
+        address += GetHashTableSkipSize(address);
+        push(address, tempSize);
+      }
+    } else {
+      u32 block = entry->startingBlockNum;
+      while (fileSize > 0) {
+        if (block >= metaData->stfsVolumeDescriptor.allocatedBlockCount)
+          throw std::string("STFS: Reference to illegal block number.\n");
+        u32 length = (std::min)(fileSize, (u32)0x1000);
+        push(BlockToAddress(block), length);
+        fileSize -= length;
+        if (fileSize > 0) {
+          block = GetBlockHashEntry(block).nextBlock;
+        }
+      }
+    }
+  }
+
   // Description: extract a block's data
   void ExtractBlock(u32 blockNum, u8 *data, u32 length = 0x1000) {
     if (blockNum >= metaData->stfsVolumeDescriptor.allocatedBlockCount)
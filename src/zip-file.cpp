@@ -2,6 +2,8 @@
 
 #include <je2be/fs.hpp>
 
+#include "_parallel.hpp"
+
 #include <iostream>
 
 #include <mz.h>
@@ -9,11 +11,262 @@
 #include <mz_strm.h>
 #include <mz_strm_os.h>
 #include <mz_zip.h>
+#include <zlib.h>
 
 #include <defer.hpp>
 
 namespace je2be {
 
+class ZipFile::Impl {
+  Impl() = delete;
+
+public:
+  struct Entry {
+    std::filesystem::path fPath;
+    std::string fName;
+    u64 fSize;
+    bool fStore;
+  };
+
+  // Part of an entry, compressed independently of the other parts
+  struct Block {
+    size_t fEntry;
+    u64 fOffset;
+    u64 fSize;
+    bool fLast;
+  };
+
+  struct CompressedBlock {
+    std::vector<u8> fData;
+    u64 fSize = 0;
+    u32 fCrc = 0;
+  };
+
+  static ZipResult Zip(std::filesystem::path const &inputDirectory, std::filesystem::path const &outputZipFile, unsigned int concurrency, std::function<bool(int done, int total)> progress) {
+    using namespace std;
+    namespace fs = std::filesystem;
+
+    ZipResult ret;
+
+    vector<Entry> entries;
+    error_code ec;
+    for (auto it : fs::recursive_directory_iterator(inputDirectory, ec)) {
+      auto path = it.path();
+      if (!fs::is_regular_file(path)) {
+        continue;
+      }
+      fs::path rel = fs::relative(path, inputDirectory, ec);
+      if (ec) {
+        ret.fStatus = JE2BE_ERROR;
+        return ret;
+      }
+      auto size = Fs::FileSize(path);
+      if (!size) {
+        ret.fStatus = JE2BE_ERROR;
+        return ret;
+      }
+      Entry entry;
+      entry.fPath = path;
+      entry.fName = rel.string();
+      entry.fSize = *size;
+      entry.fStore = path.extension() == ".ldb";
+      entries.push_back(entry);
+    }
+    if (ec) {
+      ret.fStatus = JE2BE_ERROR;
+      return ret;
+    }
+    int const total = (int)entries.size();
+    if (!progress(0, total)) {
+      ret.fStatus = JE2BE_ERROR;
+      return ret;
+    }
+
+    ZipFile file(outputZipFile);
+    int done = 0;
+    size_t first = 0;
+    while (first < entries.size()) {
+      // Compress a batch of entries in parallel, then write them in order. Batches end on an entry boundary, so an entry larger
+      // than kBatchSize makes a batch of its own.
+      vector<Block> blocks;
+      u64 batchSize = 0;
+      size_t last = first;
+      for (; last < entries.size() && (last == first || batchSize < kBatchSize); last++) {
+        Entry const &entry = entries[last];
+        u64 offset = 0;
+        do {
+          Block block;
+          block.fEntry = last;
+          block.fOffset = offset;
+          block.fSize = (std::min)(kBlockSize, entry.fSize - offset);
+          block.fLast = offset + block.fSize == entry.fSize;
+          blocks.push_back(block);
+          offset += block.fSize;
+        } while (offset < entry.fSize);
+        batchSize += entry.fSize;
+      }
+
+      vector<CompressedBlock> compressed;
+      auto st = Parallel::Map<Block, CompressedBlock>(
+          blocks,
+          (std::max)(concurrency, 1u),
+          [&entries](Block const &block, int) -> pair<CompressedBlock, Status> {
+            CompressedBlock out;
+            if (Compress(entries[block.fEntry], block, out)) {
+              return make_pair(std::move(out), Status::Ok());
+            } else {
+              return make_pair(CompressedBlock(), JE2BE_ERROR);
+            }
+          },
+          compressed);
+      if (!st.ok()) {
+        ret.fStatus = JE2BE_ERROR_PUSH(st);
+        ret.fZip64Used = file.fZip64Used;
+        return ret;
+      }
+
+      size_t index = 0;
+      for (size_t i = first; i < last; i++) {
+        size_t begin = index;
+        while (index < blocks.size() && blocks[index].fEntry == i) {
+          index++;
+        }
+        if (auto result = Append(file, entries[i], span<CompressedBlock const>(compressed.data() + begin, index - begin)); !result.fStatus.ok()) {
+          ret.fStatus = result.fStatus;
+          ret.fZip64Used = result.fZip64Used;
+          return ret;
+        }
+        done++;
+        if (!progress(done, total)) {
+          ret.fStatus = JE2BE_ERROR;
+          ret.fZip64Used = file.fZip64Used;
+          return ret;
+        }
+      }
+      first = last;
+    }
+    return file.close();
+  }
+
+  static bool Compress(Entry const &entry, Block const &block, CompressedBlock &out) {
+    using namespace std;
+
+    // The last 32 KiB before the block is used as the preset dictionary, so splitting a file into blocks costs little in the
+    // compression ratio
+    u64 dictionarySize = entry.fStore ? 0 : (std::min)(kDictionarySize, block.fOffset);
+    mcfile::ScopedFile fp(mcfile::File::Open(entry.fPath, mcfile::File::Mode::Read));
+    if (!fp) {
+      return false;
+    }
+    if (!mcfile::File::Fseek(fp.get(), block.fOffset - dictionarySize, SEEK_SET)) {
+      return false;
+    }
+    vector<u8> buffer(dictionarySize + block.fSize);
+    if (!buffer.empty() && !mcfile::File::Fread(buffer.data(), buffer.size(), 1, fp.get())) {
+      return false;
+    }
+    u8 const *data = buffer.data() + dictionarySize;
+    out.fSize = block.fSize;
+    out.fCrc = (u32)crc32(0, data, (uInt)block.fSize);
+
+    if (entry.fStore) {
+      buffer.swap(out.fData);
+      return true;
+    }
+
+    z_stream zs{};
+    if (deflateInit2(&zs, kCompressionLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      return false;
+    }
+    defer {
+      deflateEnd(&zs);
+    };
+    if (dictionarySize > 0 && deflateSetDictionary(&zs, buffer.data(), (uInt)dictionarySize) != Z_OK) {
+      return false;
+    }
+    // Blocks other than the last one end with a sync flush, so that the compressed blocks can be concatenated into one stream
+    int const flush = block.fLast ? Z_FINISH : Z_SYNC_FLUSH;
+    out.fData.resize(deflateBound(&zs, (uLong)block.fSize) + 16);
+    zs.next_in = (Bytef *)data;
+    zs.avail_in = (uInt)block.fSize;
+    size_t written = 0;
+    while (true) {
+      zs.next_out = out.fData.data() + written;
+      zs.avail_out = (uInt)(out.fData.size() - written);
+      int ret = deflate(&zs, flush);
+      written = out.fData.size() - zs.avail_out;
+      if (ret == Z_STREAM_ERROR) {
+        return false;
+      }
+      if (flush == Z_FINISH ? ret == Z_STREAM_END : zs.avail_out > 0) {
+        break;
+      }
+      out.fData.resize(out.fData.size() * 2);
+    }
+    out.fData.resize(written);
+    return true;
+  }
+
+  static StoreResult Append(ZipFile &file, Entry const &entry, std::span<CompressedBlock const> blocks) {
+    StoreResult ret;
+
+    u32 crc = 0;
+    u64 compressedSize = 0;
+    for (auto const &block : blocks) {
+      crc = (u32)crc32_combine(crc, block.fCrc, (z_off_t)block.fSize);
+      compressedSize += block.fData.size();
+    }
+
+    mz_zip_file s = {0};
+    s.version_madeby = MZ_VERSION_MADEBY;
+    s.compression_method = entry.fStore ? MZ_COMPRESS_METHOD_STORE : MZ_COMPRESS_METHOD_DEFLATE;
+    s.filename = entry.fName.c_str();
+    s.uncompressed_size = (i64)entry.fSize;
+    s.compressed_size = (i64)compressedSize;
+    s.crc = crc;
+    u8 raw = 1;
+    if (MZ_OK != mz_zip_entry_write_open(file.fHandle, &s, entry.fStore ? 0 : kCompressionLevel, raw, nullptr)) {
+      ret.fStatus = JE2BE_ERROR;
+      ret.fZip64Used = file.fZip64Used;
+      return ret;
+    }
+    bool ok = true;
+    for (auto const &block : blocks) {
+      if (block.fData.empty()) {
+        continue;
+      }
+      if (mz_zip_entry_write(file.fHandle, block.fData.data(), (i32)block.fData.size()) != (i32)block.fData.size()) {
+        ok = false;
+        break;
+      }
+    }
+    file.fZip64Used = file.fZip64Used || (entry.fSize >= UINT32_MAX || compressedSize >= UINT32_MAX);
+
+    if (mz_zip_entry_close_raw(file.fHandle, (i64)entry.fSize, crc) != MZ_OK || !ok) {
+      ret.fStatus = JE2BE_ERROR;
+      ret.fZip64Used = file.fZip64Used;
+      return ret;
+    }
+
+    if (!file.fZip64Used) {
+      mz_zip_file *info = nullptr;
+      mz_zip_entry_get_info(file.fHandle, &info);
+      if (info && info->disk_offset >= UINT32_MAX) {
+        file.fZip64Used = true;
+      }
+    }
+    ret.fZip64Used = file.fZip64Used;
+    return ret;
+  }
+
+private:
+  static constexpr u64 kBlockSize = 1024 * 1024;
+  static constexpr u64 kDictionarySize = 32 * 1024;
+  // Total size of the input files compressed before being written
+  static constexpr u64 kBatchSize = 256 * 1024 * 1024;
+  static constexpr int kCompressionLevel = 9;
+};
+
 ZipFile::ZipFile(std::filesystem::path const &zipFilePath) : fHandle(nullptr), fStream(nullptr) {
   fStream = mz_stream_os_create();
   if (!fStream) {
@@ -277,4 +530,12 @@ ZipFile::ZipResult ZipFile::Zip(
   return file.close();
 }
 
+ZipFile::ZipResult ZipFile::Zip(
+    std::filesystem::path const &inputDirectory,
+    std::filesystem::path const &outputZipFile,
+    unsigned int concurrency,
+    std::function<bool(int done, int total)> progress) {
+  return Impl::Zip(inputDirectory, outputZipFile, concurrency, progress);
+}
+
 } // namespace je2be
@@ -0,0 +1,131 @@
+#pragma once
+
+namespace {
+
+std::vector<std::shared_ptr<mcfile::je::Block const>> BlockStateCacheSampleBlocks() {
+  using namespace std;
+  vector<shared_ptr<mcfile::je::Block const>> blocks;
+  for (auto name : {u8"minecraft:stone", u8"minecraft:dirt", u8"minecraft:grass_block", u8"minecraft:water", u8"minecraft:lava", u8"minecraft:flowing_water", u8"minecraft:deepslate", u8"minecraft:chest", u8"j2b:piston_arm_collision", u8"minecraft:unknown_block_for_block_state_cache"}) {
+    blocks.push_back(mcfile::je::Block::FromName(name, kJavaDataVersion));
+  }
+  for (auto facing : {u8"north", u8"east", u8"south", u8"west"}) {
+    for (auto half : {u8"top", u8"bottom"}) {
+      blocks.push_back(mcfile::je::Block::FromNameAndProperties(u8"minecraft:oak_stairs", kJavaDataVersion, map<u8string, u8string>{{u8"facing", facing}, {u8"half", half}, {u8"waterlogged", u8"false"}}));
+    }
+  }
+  for (auto axis : {u8"x", u8"y", u8"z"}) {
+    blocks.push_back(mcfile::je::Block::FromNameAndProperties(u8"minecraft:oak_log", kJavaDataVersion, map<u8string, u8string>{{u8"axis", axis}}));
+  }
+  return blocks;
+}
+
+} // namespace
+
+TEST_CASE("block-state-cache") {
+  using namespace je2be::java;
+  auto blocks = BlockStateCacheSampleBlocks();
+  for (auto mode : {ChunkConversionMode::CavesAndCliffs2, ChunkConversionMode::Legacy}) {
+    DataVersion dataVersion(kJavaDataVersion, mode);
+    for (int trial = 0; trial < 2; trial++) {
+      for (auto const &block : blocks) {
+        auto expected = BlockData::From(block, nullptr, dataVersion, {});
+        REQUIRE(expected);
+        auto expectedNbt = CompoundTag::Write(*expected, mcfile::Encoding::LittleEndian);
+        REQUIRE(expectedNbt);
+
+        auto entry = BlockStateCache::Get(block, dataVersion);
+        REQUIRE(entry);
+        CHECK(entry->fNbt == *expectedNbt);
+        CHECK(entry->fTag->equals(*expected));
+        CHECK(BlockStateCache::Get(block, dataVersion) == entry);
+      }
+    }
+  }
+  auto air = BlockStateCache::Get(nullptr, DataVersion(kJavaDataVersion, kJavaDataVersion));
+  REQUIRE(air);
+  CHECK(air->fTag->string(u8"name") == u8"minecraft:air");
+
+  // Entries without known NBT are serialized on demand, and duplicates are merged by their NBT
+  BlockPalette palette;
+  auto stone = BlockStateCache::Get(blocks[0], DataVersion(kJavaDataVersion, kJavaDataVersion));
+  palette.append(stone->fTag, make_shared<string const>(stone->fNbt));
+  palette.append(BlockData::From(blocks[1], nullptr, DataVersion(kJavaDataVersion, kJavaDataVersion), {}));
+  palette.append(BlockData::From(blocks[0], nullptr, DataVersion(kJavaDataVersion, kJavaDataVersion), {}));
+  palette.fIndices[1] = 1;
+  palette.fIndices[2] = 2;
+  palette.resolveDuplication();
+  REQUIRE(palette.size() == 2);
+  CHECK(palette.fIndices[0] == 0);
+  CHECK(palette.fIndices[1] == 1);
+  CHECK(palette.fIndices[2] == 0);
+  CHECK(*palette.serializedAt(0) == stone->fNbt);
+  CHECK(*palette.serializedAt(1) == *CompoundTag::Write(*palette[1], mcfile::Encoding::LittleEndian));
+  palette.swap(0, 1);
+  CHECK(*palette.serializedAt(1) == stone->fNbt);
+  CHECK(palette[1]->equals(*stone->fTag));
+}
+
+TEST_CASE("block-state-cache-benchmark" * doctest::skip()) {
+  using namespace je2be::java;
+  auto blocks = BlockStateCacheSampleBlocks();
+  DataVersion dataVersion(kJavaDataVersion, kJavaDataVersion);
+  mt19937 rng(1);
+  int const numChunks = 10000;
+  vector<shared_ptr<mcfile::je::WritableChunk>> chunks;
+  for (int i = 0; i < numChunks; i++) {
+    int cx = i % 100;
+    int cz = i / 100;
+    auto chunk = mcfile::je::WritableChunk::MakeEmpty(cx, -4, cz, kJavaDataVersion);
+    for (int y = 0; y < 16; y++) {
+      for (int z = cz * 16; z < cz * 16 + 16; z++) {
+        for (int x = cx * 16; x < cx * 16 + 16; x++) {
+          chunk->setBlockAt(x, y, z, blocks[rng() % blocks.size()]);
+        }
+      }
+    }
+    chunks.push_back(chunk);
+  }
+
+  // Palette serialization as java::SubChunk did it before BlockStateCache
+  size_t bytes = 0;
+  auto start = chrono::high_resolution_clock::now();
+  for (auto const &chunk : chunks) {
+    for (auto const &section : chunk->fSections) {
+      if (!section) {
+        continue;
+      }
+      section->eachBlockPalette([&](shared_ptr<mcfile::je::Block const> const &block, size_t) {
+        auto tag = BlockData::From(block, nullptr, dataVersion, {});
+        bytes += CompoundTag::Write(*tag, mcfile::Encoding::LittleEndian)->size();
+        return true;
+      });
+    }
+  }
+  auto elapsedUncached = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+  start = chrono::high_resolution_clock::now();
+  for (auto const &chunk : chunks) {
+    for (auto const &section : chunk->fSections) {
+      if (!section) {
+        continue;
+      }
+      section->eachBlockPalette([&](shared_ptr<mcfile::je::Block const> const &block, size_t) {
+        bytes += BlockStateCache::Get(block, dataVersion)->fNbt.size();
+        return true;
+      });
+    }
+  }
+  auto elapsedCached = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+  start = chrono::high_resolution_clock::now();
+  for (auto const &chunk : chunks) {
+    ChunkData cd(chunk->fChunkX, chunk->fChunkZ, mcfile::Dimension::Overworld, ChunkConversionMode::CavesAndCliffs2, dataVersion);
+    ChunkDataPackage cdp(ChunkConversionMode::CavesAndCliffs2);
+    WorldData wd(mcfile::Dimension::Overworld);
+    CHECK(SubChunk::Convert(*chunk, mcfile::Dimension::Overworld, 0, cd, cdp, wd).ok());
+    bytes += cd.fSubChunks[0].size();
+  }
+  auto elapsedSubChunk = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+  cout << "block-state-cache-benchmark: " << numChunks << " chunks, palette serialization: uncached=" << elapsedUncached << "ms, cached=" << elapsedCached << "ms, SubChunk::Convert=" << elapsedSubChunk << "ms, " << bytes << " bytes" << endl;
+}
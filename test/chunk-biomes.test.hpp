@@ -0,0 +1,99 @@
+#pragma once
+
+namespace {
+
+// Makes a chunk with a stone block in each section from chunkY to maxChunkY, and sets the biome of every block of the chunk's
+// sections with `biome(by, cellX, cellY, cellZ)`. Returns the Data2D biomes the chunk is expected to give, for sections from
+// minChunkY, with sections below chunkY filled with `below`.
+std::pair<std::shared_ptr<mcfile::je::WritableChunk>, std::shared_ptr<mcfile::be::BiomeMap>> ChunkBiomesFixture(
+    int chunkY,
+    int maxChunkY,
+    int minChunkY,
+    mcfile::biomes::BiomeId below,
+    std::function<mcfile::biomes::BiomeId(int by, int cellX, int cellY, int cellZ)> biome) {
+  using namespace std;
+  int const cx = 3;
+  int const cz = -2;
+  auto chunk = mcfile::je::WritableChunk::MakeEmpty(cx, chunkY, cz, kJavaDataVersion);
+  auto stone = mcfile::je::Block::FromName(u8"minecraft:stone", kJavaDataVersion);
+  for (int cy = chunkY; cy <= maxChunkY; cy++) {
+    chunk->setBlockAt(cx * 16, cy * 16, cz * 16, stone);
+  }
+  int top = maxChunkY;
+  for (auto const &section : chunk->fSections) {
+    if (section) {
+      top = (std::max)(top, section->y());
+    }
+  }
+  auto expected = make_shared<mcfile::be::BiomeMap>(minChunkY, top);
+  for (int by = minChunkY * 16; by < (top + 1) * 16; by++) {
+    for (int lz = 0; lz < 16; lz++) {
+      for (int lx = 0; lx < 16; lx++) {
+        if (by < chunkY * 16) {
+          expected->set(lx, by, lz, below);
+        } else {
+          auto b = biome(by, lx / 4, (by & 0xf) / 4, lz / 4);
+          chunk->setBiomeAt(cx * 16 + lx, by, cz * 16 + lz, b);
+          expected->set(lx, by, lz, b);
+        }
+      }
+    }
+  }
+  return make_pair(chunk, expected);
+}
+
+void ChunkBiomesCheck(mcfile::je::Chunk const &chunk, mcfile::Dimension dim, mcfile::be::BiomeMap &expected) {
+  auto actual = je2be::java::ChunkBiomes::Build(chunk, dim);
+  REQUIRE(actual);
+  auto actualEncoded = actual->encode();
+  auto expectedEncoded = expected.encode();
+  REQUIRE(actualEncoded);
+  REQUIRE(expectedEncoded);
+  CHECK(*actualEncoded == *expectedEncoded);
+}
+
+} // namespace
+
+TEST_CASE("chunk-biomes") {
+  using namespace mcfile::biomes::minecraft;
+  using mcfile::biomes::BiomeId;
+
+  SUBCASE("sections with one biome and with several biomes") {
+    auto [chunk, expected] = ChunkBiomesFixture(-4, 1, -4, plains, [](int by, int x, int y, int z) -> BiomeId {
+      int cy = by >> 4;
+      if (cy <= -3) {
+        return desert;
+      } else if (cy == -2) {
+        return (x + y + z) % 2 == 0 ? ocean : forest;
+      } else if (cy == -1) {
+        return y < 2 ? jungle : swamp;
+      } else {
+        return savanna;
+      }
+    });
+    ChunkBiomesCheck(*chunk, mcfile::Dimension::Overworld, *expected);
+  }
+
+  SUBCASE("overworld chunk starting above the bottom of the world") {
+    // 48 of the 64 cells of the lowest section are birch forest, so the sections below it are filled with birch forest
+    auto [chunk, expected] = ChunkBiomesFixture(0, 2, -4, birch_forest, [](int by, int x, int y, int z) -> BiomeId {
+      if (by < 16) {
+        return x == 3 ? river : birch_forest;
+      } else {
+        return taiga;
+      }
+    });
+    ChunkBiomesCheck(*chunk, mcfile::Dimension::Overworld, *expected);
+  }
+
+  SUBCASE("nether") {
+    auto [chunk, expected] = ChunkBiomesFixture(0, 7, 0, nether_wastes, [](int by, int x, int y, int z) -> BiomeId {
+      if (by < 64) {
+        return basalt_deltas;
+      } else {
+        return (x + z) % 2 == 0 ? crimson_forest : warped_forest;
+      }
+    });
+    ChunkBiomesCheck(*chunk, mcfile::Dimension::Nether, *expected);
+  }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+namespace {
+
+// Writes empty chunks into region files under `dir`
+void ChunkCacheWriteChunks(std::filesystem::path const &dir, std::vector<Pos2i> const &chunks) {
+  using namespace std;
+  map<Pos2i, vector<Pos2i>, function<bool(Pos2i const &, Pos2i const &)>> regions([](Pos2i const &a, Pos2i const &b) {
+    return tie(a.fX, a.fZ) < tie(b.fX, b.fZ);
+  });
+  for (Pos2i const &chunk : chunks) {
+    regions[Pos2i(mcfile::Coordinate::RegionFromChunk(chunk.fX), mcfile::Coordinate::RegionFromChunk(chunk.fZ))].push_back(chunk);
+  }
+  for (auto const &[region, list] : regions) {
+    auto file = dir / mcfile::je::Region::GetDefaultRegionFileName(region.fX, region.fZ);
+    auto editor = mcfile::je::McaEditor::Open(file);
+    REQUIRE(editor);
+    for (Pos2i const &chunk : list) {
+      auto c = mcfile::je::WritableChunk::MakeEmpty(chunk.fX, -4, chunk.fZ, kJavaDataVersion);
+      c->setBlockAt(chunk.fX * 16, 0, chunk.fZ * 16, mcfile::je::Block::FromName(u8"minecraft:stone", kJavaDataVersion));
+      auto tag = c->toCompoundTag(mcfile::Dimension::Overworld);
+      REQUIRE(tag);
+      REQUIRE(editor->insert(chunk.fX - region.fX * 32, chunk.fZ - region.fZ * 32, *tag));
+    }
+    REQUIRE(editor->write(file));
+  }
+}
+
+} // namespace
+
+TEST_CASE("chunk-cache") {
+  using namespace je2be::terraform::java;
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+  auto const dim = mcfile::Dimension::Overworld;
+  Pos2i const a(0, 0);
+  Pos2i const b(1, 0);
+  Pos2i const c(2, 0);
+  Pos2i const neighbor(32, 0);
+  ChunkCacheWriteChunks(*tmp, {a, b, c, neighbor});
+
+  SUBCASE("chunks no pending region can look up aren't cached") {
+    ChunkCache cache(1, 4);
+    auto first = cache.get(dim, *tmp, a.fX, a.fZ);
+    REQUIRE(first);
+    CHECK(cache.get(dim, *tmp, a.fX, a.fZ) != first);
+  }
+
+  SUBCASE("least recently used chunk is evicted when capacity is exceeded") {
+    ChunkCache cache(1, 2);
+    cache.retain(dim, Pos2i(0, 0));
+    auto chunkA = cache.get(dim, *tmp, a.fX, a.fZ);
+    auto chunkB = cache.get(dim, *tmp, b.fX, b.fZ);
+    REQUIRE(chunkA);
+    REQUIRE(chunkB);
+    // a becomes the most recently used, so b is evicted when c is loaded
+    CHECK(cache.get(dim, *tmp, a.fX, a.fZ) == chunkA);
+    auto chunkC = cache.get(dim, *tmp, c.fX, c.fZ);
+    REQUIRE(chunkC);
+    CHECK(cache.get(dim, *tmp, a.fX, a.fZ) == chunkA);
+    CHECK(cache.get(dim, *tmp, c.fX, c.fZ) == chunkC);
+    CHECK(cache.get(dim, *tmp, b.fX, b.fZ) != chunkB);
+  }
+
+  SUBCASE("release drops chunks unless another pending region can look them up") {
+    ChunkCache cache(1, 16);
+    cache.retain(dim, Pos2i(0, 0));
+    cache.retain(dim, Pos2i(1, 0));
+    // `neighbor` is in region (1, 0), and within the halo of region (0, 0). `a` is only reachable from region (0, 0)
+    auto chunkA = cache.get(dim, *tmp, a.fX, a.fZ);
+    auto chunkNeighbor = cache.get(dim, *tmp, neighbor.fX, neighbor.fZ);
+    REQUIRE(chunkA);
+    REQUIRE(chunkNeighbor);
+
+    cache.release(dim, Pos2i(0, 0));
+    CHECK(cache.get(dim, *tmp, neighbor.fX, neighbor.fZ) == chunkNeighbor);
+    CHECK(cache.get(dim, *tmp, a.fX, a.fZ) != chunkA);
+
+    cache.release(dim, Pos2i(1, 0));
+    CHECK(cache.get(dim, *tmp, neighbor.fX, neighbor.fZ) != chunkNeighbor);
+  }
+}
@@ -47,3 +47,55 @@ TEST_CASE("command") {
     CHECK(actual[2].second == false);
   }
 }
+
+TEST_CASE("command-fuzz") {
+  using namespace je2be::command;
+  using namespace std;
+
+  // Commands assembled from fragments, covering target selectors, string literals, escapes, comments and broken syntax
+  vector<u8string> fragments = {
+      u8"@e", u8"@a", u8"@p", u8"@s", u8"@initiator", u8"@x", u8"@", u8"[", u8"]", u8"=", u8",", u8"scores={", u8"}", u8"foo=1..2",
+      u8"distance=..10", u8"r=3", u8"rm=1", u8"type=zombie", u8"\"", u8"'", u8"\\", u8"\\\"", u8" ", u8"  ", u8"#", u8"/", u8"function ",
+      u8"ns:f", u8"\x0d", u8"\n", u8"x", u8"limit=1", u8"gamemode=survival", u8"c=1", u8"l=1", u8"ry=20", u8"rxm=-3", u8"level=1..",
+      u8"x_rotation=1..2", u8"tag=!a"};
+  mt19937 rng(1);
+  int numParsed = 0;
+  for (int i = 0; i < 20000; i++) {
+    u8string command;
+    int numFragments = rng() % 14;
+    for (int j = 0; j < numFragments; j++) {
+      command += fragments[rng() % fragments.size()];
+    }
+
+    // Tokens cover the whole command
+    vector<shared_ptr<Token>> tokens;
+    if (Command::Parse(command, tokens)) {
+      u8string raw;
+      for (auto const &token : tokens) {
+        raw += token->fRaw;
+      }
+      CHECK(raw == command);
+      numParsed++;
+    }
+
+    // Java -> Bedrock -> Java is stable
+    u8string java = Command::TranspileBedrockToJava(command);
+    CHECK(Command::TranspileBedrockToJava(Command::TranspileJavaToBedrock(java)) == java);
+  }
+  CHECK(numParsed > 0);
+
+  unordered_map<u8string, u8string> expected = {
+      {u8"say \"", u8"say \""},
+      {u8"say \"foo\\\"", u8"say \"foo\\\""},
+      {u8"say \"foo\\\n\" @e[distance=..1]", u8"say \"foo\\\n\" @e[distance=..1]"},
+      {u8"kill @e[scores={foo=1},distance=..1]", u8"kill @e[scores={foo=1},r=1]"},
+      {u8"kill @e[scores={foo=1},distance=..1,tag=a\nb]", u8"kill @e[scores={foo=1},distance=..1,tag=a\nb]"},
+      {u8"kill @e[scores=1]", u8"kill @e[scores=1]"},
+      {u8"kill @e[name=\"]\",distance=..1]", u8"kill @e[name=\"]\",r=1]"},
+      {u8"kill @x[distance=..1] @e[distance=..1", u8"kill @x[distance=..1] @e[distance=..1"},
+      {u8"kill @initiator[distance=..1]", u8"kill @initiator[r=1]"},
+  };
+  for (auto const &it : expected) {
+    CHECK(Command::TranspileJavaToBedrock(it.first) == it.second);
+  }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+namespace {
+
+// Records shaped like the ones of converted chunks: small Version and FinalizedState values, and sub chunks of a few KB
+std::vector<std::pair<std::string, std::string>> ConcurrentDbChunkRecords(int numChunks) {
+  using namespace std;
+  mt19937 rng(1);
+  vector<pair<string, string>> ret;
+  for (int i = 0; i < numChunks; i++) {
+    int cx = i % 64;
+    int cz = i / 64;
+    ret.push_back(make_pair(mcfile::be::DbKey::Version(cx, cz, mcfile::Dimension::Overworld), string(1, (char)40)));
+    ret.push_back(make_pair(mcfile::be::DbKey::FinalizedState(cx, cz, mcfile::Dimension::Overworld), string("\x02\x00\x00\x00", 4)));
+    for (int y = -4; y < 4; y++) {
+      string subChunk;
+      int numEntries = 1 + rng() % 8;
+      for (int j = 0; j < numEntries; j++) {
+        subChunk += "minecraft:block" + to_string(rng() % 16);
+      }
+      subChunk.resize(512 + rng() % 2048, (char)(rng() % 4));
+      ret.push_back(make_pair(mcfile::be::DbKey::SubChunk(cx, y, cz, mcfile::Dimension::Overworld), subChunk));
+    }
+  }
+  return ret;
+}
+
+struct ConcurrentDbWriteResult {
+  u64 fDbSize = 0;
+  i64 fWriteMilliseconds = 0;
+  i64 fScanMilliseconds = 0;
+  std::map<std::string, std::string> fContents;
+};
+
+ConcurrentDbWriteResult ConcurrentDbWrite(std::filesystem::path const &dir, size_t blockSize, std::vector<std::pair<std::string, std::string>> const &records) {
+  using namespace std;
+  ConcurrentDbWriteResult ret;
+  auto start = chrono::high_resolution_clock::now();
+  {
+    ConcurrentDb db(dir, 4, nullopt, blockSize);
+    auto st = Parallel::Process<pair<string, string>>(records, 4, [&db](pair<string, string> const &record) {
+      return db.put(record.first, record.second);
+    });
+    REQUIRE(st.ok());
+    REQUIRE(db.close().ok());
+  }
+  ret.fWriteMilliseconds = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+  for (auto const &item : fs::directory_iterator(dir)) {
+    if (auto size = Fs::FileSize(item.path()); size) {
+      ret.fDbSize += *size;
+    }
+  }
+
+  // Same as the game: open the db, and read all of it
+  start = chrono::high_resolution_clock::now();
+  leveldb::DB *ptr = nullptr;
+  leveldb::Options o;
+  o.compression = leveldb::kZlibRawCompression;
+  REQUIRE(leveldb::DB::Open(o, dir, &ptr).ok());
+  unique_ptr<leveldb::DB> db(ptr);
+  unique_ptr<leveldb::Iterator> itr(db->NewIterator({}));
+  for (itr->SeekToFirst(); itr->Valid(); itr->Next()) {
+    ret.fContents[itr->key().ToString()] = itr->value().ToString();
+  }
+  ret.fScanMilliseconds = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+  return ret;
+}
+
+} // namespace
+
+TEST_CASE("concurrent-db") {
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+  auto records = ConcurrentDbChunkRecords(256);
+  map<string, string> expected(records.begin(), records.end());
+  for (size_t blockSize : {0, 4096, 16384}) {
+    auto result = ConcurrentDbWrite(*tmp / to_string(blockSize), blockSize, records);
+    CHECK(result.fContents == expected);
+  }
+}
+
+TEST_CASE("concurrent-db-table-size") {
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+  // 4 MiB of values under one key prefix, so that all of them go to the same range of tables
+  auto records = [](bool compressible) {
+    mt19937 rng(1);
+    vector<pair<string, string>> ret;
+    for (int i = 0; i < 1024; i++) {
+      string value(4096, 'a');
+      if (!compressible) {
+        for (auto &c : value) {
+          c = (char)rng();
+        }
+      }
+      ret.push_back(make_pair("k" + to_string(1000000 + i), value));
+    }
+    return ret;
+  };
+  auto tableSizes = [](fs::path const &dir) {
+    vector<u64> ret;
+    for (auto const &item : fs::directory_iterator(dir)) {
+      if (item.path().extension() == ".ldb") {
+        ret.push_back(*Fs::FileSize(item.path()));
+      }
+    }
+    return ret;
+  };
+  for (size_t blockSize : {0, 4096, 16384}) {
+    // Tables are split by the size they take in the db, not by the size of the values
+    auto dir = *tmp / ("compressible" + to_string(blockSize));
+    auto result = ConcurrentDbWrite(dir, blockSize, records(true));
+    CHECK(result.fContents.size() == 1024);
+    CHECK(tableSizes(dir).size() == 1);
+
+    dir = *tmp / ("incompressible" + to_string(blockSize));
+    result = ConcurrentDbWrite(dir, blockSize, records(false));
+    CHECK(result.fContents.size() == 1024);
+    auto sizes = tableSizes(dir);
+    CHECK(sizes.size() >= 2);
+    CHECK(count_if(sizes.begin(), sizes.end(), [](u64 size) { return size < 2 * 1024 * 1024; }) <= 1);
+  }
+}
+
+TEST_CASE("concurrent-db-benchmark" * doctest::skip()) {
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+  auto records = ConcurrentDbChunkRecords(20000);
+  for (size_t blockSize : {0, 4096, 8192, 16384}) {
+    auto result = ConcurrentDbWrite(*tmp / to_string(blockSize), blockSize, records);
+    CHECK(result.fContents.size() == records.size());
+    cout << "concurrent-db-benchmark: blockSize=" << blockSize << ", size=" << result.fDbSize << " bytes, write=" << result.fWriteMilliseconds << "ms, open and scan=" << result.fScanMilliseconds << "ms" << endl;
+  }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+namespace {
+
+std::map<std::string, std::string> DatapacksReadAll(std::filesystem::path const &dir) {
+  using namespace std;
+  map<string, string> ret;
+  for (auto const &item : fs::recursive_directory_iterator(dir)) {
+    if (!item.is_regular_file()) {
+      continue;
+    }
+    ifstream in(item.path(), ios::binary);
+    ret[fs::relative(item.path(), dir).generic_string()] = string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  }
+  return ret;
+}
+
+void DatapacksWriteFile(std::filesystem::path const &path, std::string const &contents) {
+  Fs::CreateDirectories(path.parent_path());
+  std::ofstream out(path, std::ios::binary);
+  out.write(contents.data(), contents.size());
+}
+
+} // namespace
+
+TEST_CASE("datapacks") {
+  using namespace je2be::java;
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+
+  auto input = *tmp / "input";
+  for (string pack : {"pack_a", "pack_b"}) {
+    auto root = input / "datapacks" / pack;
+    DatapacksWriteFile(root / "pack.mcmeta", R"({"pack":{"pack_format":57,"description":")" + pack + R"( description"}})");
+    for (string module : {"alpha", "beta", "gamma"}) {
+      for (int i = 0; i < 50; i++) {
+        DatapacksWriteFile(root / "data" / module / "function" / ("f" + to_string(i) + ".mcfunction"), "function " + module + ":f" + to_string(i + 1) + "\n\nkill @e[type=zombie,distance=..10]");
+      }
+    }
+    DatapacksWriteFile(root / "data" / "no_function" / "function" / "readme.txt", "function foo:bar");
+  }
+
+  map<string, string> expected;
+  for (unsigned int concurrency : {0, 1, 4}) {
+    auto output = *tmp / ("output" + to_string(concurrency));
+    DirectoryFileSink sink(output);
+    REQUIRE(Datapacks::Import(input, sink, concurrency));
+    auto actual = DatapacksReadAll(output);
+    if (expected.empty()) {
+      expected = actual;
+    } else {
+      // Manifests and UUIDs don't depend on concurrency
+      CHECK(actual == expected);
+    }
+  }
+  CHECK(expected.size() == 2 * 3 * 50 + 2 + 1);
+  CHECK(expected["behavior_packs/pack_a/functions/beta/f3.mcfunction"] == "function beta/f4\n\nkill @e[type=zombie,r=10]\n");
+  CHECK(expected.count("world_behavior_packs.json") == 1);
+  CHECK(expected.count("behavior_packs/pack_b/manifest.json") == 1);
+}
+
+TEST_CASE("datapacks-one-module") {
+  using namespace je2be::java;
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+
+  // Every function goes into the same output directory, which the workers race to create
+  auto input = *tmp / "input";
+  auto root = input / "datapacks" / "pack";
+  DatapacksWriteFile(root / "pack.mcmeta", R"({"pack":{"pack_format":57,"description":"one module"}})");
+  int const numFunctions = 500;
+  for (int i = 0; i < numFunctions; i++) {
+    DatapacksWriteFile(root / "data" / "alpha" / "function" / ("f" + to_string(i) + ".mcfunction"), "function alpha:f" + to_string(i + 1));
+  }
+
+  for (int trial = 0; trial < 8; trial++) {
+    auto output = *tmp / ("output" + to_string(trial));
+    DirectoryFileSink sink(output);
+    REQUIRE(Datapacks::Import(input, sink, 8));
+    auto actual = DatapacksReadAll(output);
+    CHECK(actual.size() == numFunctions + 2);
+    CHECK(actual["behavior_packs/pack/functions/alpha/f123.mcfunction"] == "function alpha/f124\n");
+    CHECK(actual.count("behavior_packs/pack/manifest.json") == 1);
+  }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+namespace {
+
+std::map<std::string, std::string> DbWriteBatchReadAll(std::filesystem::path const &dir) {
+  using namespace std;
+  map<string, string> ret;
+  leveldb::DB *ptr = nullptr;
+  leveldb::Options o;
+  o.compression = leveldb::kZlibRawCompression;
+  REQUIRE(leveldb::DB::Open(o, dir, &ptr).ok());
+  unique_ptr<leveldb::DB> db(ptr);
+  unique_ptr<leveldb::Iterator> itr(db->NewIterator({}));
+  for (itr->SeekToFirst(); itr->Valid(); itr->Next()) {
+    ret[itr->key().ToString()] = itr->value().ToString();
+  }
+  return ret;
+}
+
+} // namespace
+
+TEST_CASE("db-write-batch") {
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+
+  // Chunks of records, each of them written with one batch
+  mt19937 rng(1);
+  vector<vector<pair<string, string>>> chunks;
+  map<string, string> expected;
+  for (int i = 0; i < 500; i++) {
+    vector<pair<string, string>> records;
+    int numRecords = 1 + rng() % 8;
+    for (int j = 0; j < numRecords; j++) {
+      string key = "chunk" + to_string(i) + "/" + to_string(j);
+      string value(rng() % 4096, (char)('a' + rng() % 26));
+      records.push_back(make_pair(key, value));
+      expected[key] = value;
+    }
+    chunks.push_back(records);
+  }
+
+  for (bool useBatch : {false, true}) {
+    auto dir = *tmp / (useBatch ? "concurrent-batch" : "concurrent-put");
+    ConcurrentDb db(dir, 4);
+    auto st = Parallel::Process<vector<pair<string, string>>>(chunks, 4, [&db, useBatch](vector<pair<string, string>> const &records) -> Status {
+      if (useBatch) {
+        leveldb::WriteBatch batch;
+        for (auto const &[key, value] : records) {
+          batch.Put(key, value);
+        }
+        batch.Delete("deleted");
+        return db.write(batch);
+      } else {
+        for (auto const &[key, value] : records) {
+          if (auto st = db.put(key, value); !st.ok()) {
+            return st;
+          }
+        }
+        return Status::Ok();
+      }
+    });
+    REQUIRE(st.ok());
+    REQUIRE(db.close().ok());
+    CHECK(DbWriteBatchReadAll(dir) == expected);
+  }
+
+  {
+    auto dir = *tmp / "db";
+    {
+      Db db(dir);
+      REQUIRE(db.valid());
+      REQUIRE(db.put("deleted", "value").ok());
+      for (auto const &records : chunks) {
+        leveldb::WriteBatch batch;
+        for (auto const &[key, value] : records) {
+          batch.Put(key, value);
+        }
+        batch.Delete("deleted");
+        REQUIRE(db.write(batch).ok());
+      }
+      REQUIRE(db.close().ok());
+    }
+    CHECK(DbWriteBatchReadAll(dir) == expected);
+  }
+
+  NullDb null;
+  leveldb::WriteBatch batch;
+  batch.Put("key", "value");
+  CHECK(null.write(batch).ok());
+}
@@ -15,6 +15,7 @@
 
 #include "_nullable.hpp"
 #include "_file.hpp"
+#include "_file-sink.hpp"
 #include "_pos3.hpp"
 #include "_volume.hpp"
 #include "_optional.hpp"
@@ -56,6 +57,7 @@
 #include "item/_fireworks.hpp"
 #include "item/_banner.hpp"
 #include "item/_tipped-arrow-potion.hpp"
+#include "item/_map-color-cache.hpp"
 #include "item/_map-color.hpp"
 #include "item/_goat-horn.hpp"
 
@@ -79,6 +81,7 @@
 
 #include "terraform/_block-property-accessor.hpp"
 #include "terraform/_block-accessor.hpp"
+#include "terraform/_block-window.hpp"
 #include "terraform/bedrock/_block-accessor-bedrock.hpp"
 #include "terraform/xbox360/_block-accessor-box360.hpp"
 #include "terraform/_shape-of-stairs.hpp"
@@ -95,14 +98,37 @@
 #include "terraform/xbox360/_attached-stem.hpp"
 #include "terraform/xbox360/_chest.hpp"
 #include "terraform/java/_block-accessor-java-directory.hpp"
+#include "terraform/java/_chunk-cache.hpp"
 #include "terraform/java/_block-accessor-java-mca.hpp"
 
+#include "lce/_block-populator.hpp"
+#include "lce/_empty-region-writer.hpp"
+#include "lce/_lzx-decoder.hpp"
+#include "lce/_savegame.hpp"
+#include "lce/_savegame-files.hpp"
+#include "xbox360/_save-bin.hpp"
+#include "xbox360/_behavior.hpp"
+
 #include "db/_db-interface.hpp"
 #include "db/_db.hpp"
 #include "db/_null-db.hpp"
 #include "db/_concurrent-db.hpp"
+#include "db/_readonly-db.hpp"
+#include "db/_zip-env.hpp"
 
 #include "java/_block-data.hpp"
+#include "java/_palette-scan.hpp"
+#include "java/_palette-index-packer.hpp"
+#include "java/_block-palette.hpp"
+#include "java/_block-state-cache.hpp"
+#include "java/_chunk-data.hpp"
+#include "java/_chunk-data-package.hpp"
+#include "java/_world-data.hpp"
+#include "java/_sub-chunk.hpp"
+#include "java/_chunk-biomes.hpp"
+#include "java/_datapacks.hpp"
+#include "java/structure/_structure-piece-collection.hpp"
+#include "java/portal/_oriented-portal-blocks.hpp"
 #include "bedrock/_block-data.hpp"
 #include "bedrock/_legacy-block.hpp"
 #include "terraform/lighting/_lighting.hpp"
@@ -0,0 +1,72 @@
+#pragma once
+
+TEST_CASE("lce-block-populator") {
+  using namespace je2be::lce;
+  int const cx = 2;
+  int const cz = -3;
+  // Section 0 is air, section 1 has a few kinds of blocks, section 2 has random (id, data) pairs, and section 3 is partly covered
+  int const height = 56;
+  Data3dSq<u8, 16> blockId({0, 0, 0}, height, 0);
+  Data3dSq<u8, 16> blockData({0, 0, 0}, height, 0);
+  mt19937 rng(1);
+  array<pair<u8, u8>, 8> const kinds = {make_pair(1, 0), make_pair(3, 0), make_pair(5, 2), make_pair(8, 0), make_pair(17, 1), make_pair(35, 14), make_pair(26, 0), make_pair(9, 0x80)};
+  for (int y = 16; y < 32; y++) {
+    for (int z = 0; z < 16; z++) {
+      for (int x = 0; x < 16; x++) {
+        auto kind = kinds[rng() % kinds.size()];
+        blockId[{x, y, z}] = kind.first;
+        blockData[{x, y, z}] = kind.second;
+      }
+    }
+  }
+  for (int y = 32; y < height; y++) {
+    for (int z = 0; z < 16; z++) {
+      for (int x = 0; x < 16; x++) {
+        blockId[{x, y, z}] = (u8)rng();
+        blockData[{x, y, z}] = (u8)rng();
+      }
+    }
+  }
+  // Doors and tall flowers, of which the upper half depends on the lower half
+  for (int y : {20, 31, 40, 47}) {
+    blockId[{3, y, 4}] = 64;
+    blockData[{3, y, 4}] = 1;
+    blockId[{3, y + 1, 4}] = 64;
+    blockData[{3, y + 1, 4}] = 8;
+    blockId[{7, y, 9}] = 175;
+    blockData[{7, y, 9}] = 4;
+    blockId[{7, y + 1, 9}] = 175;
+    blockData[{7, y + 1, 9}] = 10;
+  }
+
+  auto expected = mcfile::je::WritableChunk::MakeEmpty(cx, 0, cz, Chunk::kTargetDataVersion);
+  BlockPopulator::PopulatePerVoxel(blockId, blockData, 0, height - 1, *expected);
+  auto actual = mcfile::je::WritableChunk::MakeEmpty(cx, 0, cz, Chunk::kTargetDataVersion);
+  BlockPopulator::Populate(blockId, blockData, *actual);
+
+  auto name = [](shared_ptr<mcfile::je::Block const> const &block) {
+    if (block) {
+      return u8string(block->fName) + u8string(block->fData);
+    } else {
+      return u8string(u8"minecraft:air");
+    }
+  };
+  for (int y = 0; y < 64; y++) {
+    for (int z = 0; z < 16; z++) {
+      for (int x = 0; x < 16; x++) {
+        int bx = cx * 16 + x;
+        int bz = cz * 16 + z;
+        CHECK(name(actual->blockAt(bx, y, bz)) == name(expected->blockAt(bx, y, bz)));
+      }
+    }
+  }
+  auto door = actual->blockAt(cx * 16 + 3, 21, cz * 16 + 4);
+  REQUIRE(door);
+  CHECK(door->fName == u8"minecraft:oak_door");
+  CHECK(name(actual->blockAt(cx * 16, 0, cz * 16)) == u8"minecraft:air");
+
+  CHECK(actual->fTileEntities.size() == expected->fTileEntities.size());
+  for (auto const &it : expected->fTileEntities) {
+    CHECK(actual->fTileEntities.count(it.first) == 1);
+  }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+TEST_CASE("lce-empty-region-writer") {
+  using namespace je2be::lce;
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+  for (auto [dim, newSeaLevel] : {make_pair(mcfile::Dimension::Overworld, false), make_pair(mcfile::Dimension::Overworld, true), make_pair(mcfile::Dimension::Nether, false), make_pair(mcfile::Dimension::End, false)}) {
+    int const rx = -1;
+    int const rz = 2;
+    auto writer = EmptyRegionWriter::Get(dim, newSeaLevel);
+    REQUIRE(writer);
+    auto file = *tmp / mcfile::je::Region::GetDefaultRegionFileName(rx, rz);
+    REQUIRE(writer->write(file, rx, rz));
+
+    auto region = mcfile::je::Region::MakeRegion(file, rx, rz);
+    REQUIRE(region);
+    for (int z = 0; z < 32; z++) {
+      for (int x = 0; x < 32; x++) {
+        int cx = rx * 32 + x;
+        int cz = rz * 32 + z;
+        auto actual = region->writableChunkAt(cx, cz);
+        REQUIRE(actual);
+        CHECK(actual->fChunkX == cx);
+        CHECK(actual->fChunkZ == cz);
+        auto actualTag = actual->toCompoundTag(dim);
+        REQUIRE(actualTag);
+
+        auto expected = Chunk::CreateEmptyChunk(dim, cx, cz, newSeaLevel);
+        REQUIRE(expected);
+        auto expectedTag = expected->toCompoundTag(dim);
+        REQUIRE(expectedTag);
+        // Parse it back the same way the region was read, so that both tags are serialized from a loaded chunk
+        auto reloaded = mcfile::je::WritableChunk::MakeChunk(cx, cz, expectedTag);
+        REQUIRE(reloaded);
+        expectedTag = reloaded->toCompoundTag(dim);
+        REQUIRE(expectedTag);
+
+        CHECK(CompoundTag::Write(*actualTag, mcfile::Encoding::Java) == CompoundTag::Write(*expectedTag, mcfile::Encoding::Java));
+      }
+    }
+    Fs::Delete(file);
+  }
+}
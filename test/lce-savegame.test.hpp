@@ -0,0 +1,182 @@
+#pragma once
+
+namespace {
+
+// The original implementation of lce::Savegame::DecodeDecompressedChunk, used to verify the output of the current one.
+std::vector<u8> LceSavegameExpandReference(std::vector<u8> const &buffer) {
+  std::vector<u8> out;
+  int i = 0;
+  while (i < buffer.size()) {
+    u8 b = buffer[i];
+    if (b != 0xff) {
+      out.push_back(b);
+      i++;
+      continue;
+    }
+    if (i + 1 >= buffer.size()) {
+      out.push_back(b);
+      break;
+    }
+    u8 count = buffer[i + 1];
+    if (count >= 3) {
+      if (i + 2 >= buffer.size()) {
+        out.push_back(count);
+        break;
+      }
+      u8 repeat = buffer[i + 2];
+      for (int j = 0; j <= count; j++) {
+        out.push_back(repeat);
+      }
+      i += 3;
+    } else {
+      for (int j = 0; j <= count; j++) {
+        out.push_back(0xff);
+      }
+      i += 2;
+    }
+  }
+  return out;
+}
+
+// Run-length encoded data shaped like a chunk: long runs of air and stone, short runs of other blocks, some literal bytes.
+std::vector<u8> LceSavegameRandomEncodedChunk(std::mt19937 &rng, size_t size) {
+  std::vector<u8> ret;
+  while (ret.size() < size) {
+    switch (rng() % 4) {
+    case 0:
+      ret.push_back(0xff);
+      ret.push_back(0xff);
+      ret.push_back(rng() % 2 == 0 ? 0 : 1);
+      break;
+    case 1:
+      ret.push_back(0xff);
+      ret.push_back(3 + rng() % 32);
+      ret.push_back(rng() % 256);
+      break;
+    case 2:
+      ret.push_back(0xff);
+      ret.push_back(rng() % 3);
+      break;
+    default:
+      for (int i = rng() % 16; i >= 0; i--) {
+        ret.push_back(rng() % 255);
+      }
+      break;
+    }
+  }
+  return ret;
+}
+
+} // namespace
+
+TEST_CASE("lce-savegame") {
+  SUBCASE("decode-decompressed-chunk") {
+    vector<vector<u8>> inputs = {
+        {},
+        {1, 2, 3},
+        {0xff},
+        {1, 0xff},
+        {0xff, 0},
+        {0xff, 2},
+        {0xff, 3},
+        {0xff, 3, 7},
+        {0xff, 0xff, 0},
+        {1, 0xff, 0xff},
+        {0xff, 1, 5, 0xff, 200, 9, 0xff},
+    };
+    mt19937 rng(1);
+    for (int i = 0; i < 256; i++) {
+      vector<u8> input;
+      size_t size = rng() % 64;
+      for (size_t j = 0; j < size; j++) {
+        // Lots of 0xff to exercise the escapes at every position
+        input.push_back(rng() % 3 == 0 ? 0xff : (rng() % 256));
+      }
+      inputs.push_back(input);
+    }
+    inputs.push_back(LceSavegameRandomEncodedChunk(rng, 64 * 1024));
+
+    for (auto const &input : inputs) {
+      auto expected = LceSavegameExpandReference(input);
+
+      vector<u8> actual = input;
+      lce::Savegame::DecodeDecompressedChunk(actual);
+      CHECK(actual == expected);
+
+      vector<u8> reused(3, 0xcc);
+      lce::Savegame::DecodeDecompressedChunk(input, reused);
+      CHECK(reused == expected);
+    }
+  }
+}
+
+TEST_CASE("lce-savegame-benchmark" * doctest::skip()) {
+  // Decompressed chunks of the Xbox 360 saves under test/data/xbox360 are used when available.
+  vector<vector<u8>> chunks;
+  auto dir = ProjectRootDir() / "test" / "data" / "xbox360";
+  if (fs::is_directory(dir)) {
+    xbox360::ConverterBehavior behavior;
+    for (auto const &it : fs::directory_iterator(dir)) {
+      if (!it.is_regular_file() || it.path().extension() != ".bin") {
+        continue;
+      }
+      vector<u8> savegame;
+      if (!xbox360::SaveBin::ExtractSavagame(it.path(), savegame) || !xbox360::SaveBin::DecompressSavegame(savegame)) {
+        continue;
+      }
+      auto files = lce::SavegameFiles::Open(savegame);
+      if (!files) {
+        continue;
+      }
+      for (auto const &name : files->list(u8"region")) {
+        auto region = files->open(name);
+        for (int z = 0; z < 32; z++) {
+          for (int x = 0; x < 32; x++) {
+            vector<u8> raw;
+            if (!lce::Savegame::ExtractRawChunkFromRegionFile(*region, x, z, raw) || raw.empty()) {
+              continue;
+            }
+            vector<u8> decompressed;
+            if (behavior.decompressChunk(raw, decompressed).ok()) {
+              chunks.push_back(decompressed);
+            }
+          }
+        }
+      }
+    }
+  }
+  if (chunks.empty()) {
+    mt19937 rng(1);
+    for (int i = 0; i < 1024; i++) {
+      chunks.push_back(LceSavegameRandomEncodedChunk(rng, 8 * 1024));
+    }
+  }
+
+  auto measure = [&](auto decode) {
+    size_t total = 0;
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < 4; i++) {
+      for (auto const &chunk : chunks) {
+        total += decode(chunk);
+      }
+    }
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+    return make_pair(elapsed, total);
+  };
+  auto reference = measure([](vector<u8> const &chunk) {
+    return LceSavegameExpandReference(chunk).size();
+  });
+  auto fresh = measure([](vector<u8> const &chunk) {
+    vector<u8> buffer = chunk;
+    lce::Savegame::DecodeDecompressedChunk(buffer);
+    return buffer.size();
+  });
+  vector<u8> out;
+  auto reused = measure([&out](vector<u8> const &chunk) {
+    lce::Savegame::DecodeDecompressedChunk(chunk, out);
+    return out.size();
+  });
+  CHECK(reference.second == fresh.second);
+  CHECK(reference.second == reused.second);
+  cout << "lce-savegame-benchmark: " << chunks.size() << " chunks, reference=" << reference.first << "ms, current=" << fresh.first << "ms, current with reused buffer=" << reused.first << "ms" << endl;
+}
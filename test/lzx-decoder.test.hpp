@@ -0,0 +1,421 @@
+#pragma once
+
+#include "lzx-decoder-reference.hpp"
+
+namespace {
+
+// Generates random, well-formed XMemCompress streams (verbatim and aligned LZX blocks in 0x8000 byte frames) along with the
+// data they decode to.
+class LzxTestEncoder {
+  class BitWriter {
+  public:
+    void write(u32 value, u32 bits) {
+      for (int i = (int)bits - 1; i >= 0; i--) {
+        fWord = (fWord << 1) | ((value >> i) & 1);
+        fBits++;
+        if (fBits == 16) {
+          fBytes.push_back(0xff & fWord);
+          fBytes.push_back(0xff & (fWord >> 8));
+          fWord = 0;
+          fBits = 0;
+        }
+      }
+    }
+
+    std::vector<u8> flush() {
+      if (fBits > 0) {
+        write(0, 16 - fBits);
+      }
+      std::vector<u8> ret;
+      ret.swap(fBytes);
+      return ret;
+    }
+
+  private:
+    std::vector<u8> fBytes;
+    u32 fWord = 0;
+    u32 fBits = 0;
+  };
+
+  struct Tree {
+    std::vector<u8> fLengths;
+    std::vector<u32> fCodes;
+    std::vector<u32> fSymbols; // symbols with non-zero length, or {0} for an all-zero tree
+
+    void write(BitWriter &w, u32 sym) const {
+      w.write(fCodes[sym], fLengths[sym]);
+    }
+  };
+
+public:
+  explicit LzxTestEncoder(u32 seed) : fRandom(seed) {}
+
+  // Returns the XMemCompress framed stream, and stores the data it decodes to into `expected`.
+  std::vector<u8> encode(size_t size, std::vector<u8> &expected) {
+    using namespace std;
+    expected.clear();
+    vector<u8> stream;
+    bool headerWritten = false;
+    u32 blockRemaining = 0;
+    bool aligned = false;
+    while (expected.size() < size) {
+      u32 frameSize = (u32)(min)((size_t)0x8000, size - expected.size());
+      BitWriter w;
+      if (!headerWritten) {
+        // no Intel E8 translation
+        w.write(0, 1);
+        headerWritten = true;
+      }
+      u32 frameRemaining = frameSize;
+      while (frameRemaining > 0) {
+        if (blockRemaining == 0) {
+          blockRemaining = uniform(1, 100000);
+          aligned = uniform(0, 1) == 1;
+          writeBlockHeader(w, aligned, blockRemaining);
+        }
+        u32 run = (min)(blockRemaining, frameRemaining);
+        writeRun(w, aligned, run, expected);
+        blockRemaining -= run;
+        frameRemaining -= run;
+      }
+      auto frame = w.flush();
+      stream.push_back(0xff);
+      stream.push_back(0xff & (frameSize >> 8));
+      stream.push_back(0xff & frameSize);
+      stream.push_back(0xff & (frame.size() >> 8));
+      stream.push_back(0xff & frame.size());
+      copy(frame.begin(), frame.end(), back_inserter(stream));
+    }
+    return stream;
+  }
+
+private:
+  u32 uniform(u32 min, u32 max) {
+    return std::uniform_int_distribution<u32>(min, max)(fRandom);
+  }
+
+  // Lengths of a random complete prefix code with `leaves` codes, assigned to randomly chosen symbols.
+  std::vector<u8> randomLengths(u32 numSymbols, u32 leaves, u32 maxDepth) {
+    using namespace std;
+    vector<u8> lengths(numSymbols, 0);
+    if (leaves < 2) {
+      return lengths;
+    }
+    vector<u32> depths = {0};
+    while (depths.size() < leaves) {
+      u32 index = uniform(0, (u32)depths.size() - 1);
+      if (depths[index] >= maxDepth) {
+        continue;
+      }
+      depths[index]++;
+      depths.push_back(depths[index]);
+    }
+    vector<u32> symbols(numSymbols);
+    iota(symbols.begin(), symbols.end(), 0);
+    shuffle(symbols.begin(), symbols.end(), fRandom);
+    for (u32 i = 0; i < leaves; i++) {
+      lengths[symbols[i]] = (u8)depths[i];
+    }
+    return lengths;
+  }
+
+  static Tree MakeTree(std::vector<u8> const &lengths) {
+    Tree t;
+    t.fLengths = lengths;
+    t.fCodes.resize(lengths.size(), 0);
+    u32 code = 0;
+    for (u32 len = 1; len <= 16; len++) {
+      for (u32 sym = 0; sym < lengths.size(); sym++) {
+        if (lengths[sym] == len) {
+          t.fCodes[sym] = code++;
+          t.fSymbols.push_back(sym);
+        }
+      }
+      code <<= 1;
+    }
+    if (t.fSymbols.empty()) {
+      t.fSymbols.push_back(0);
+    }
+    return t;
+  }
+
+  void writeLengths(BitWriter &w, std::vector<u8> const &lengths, std::vector<u8> &prev, u32 first, u32 last) {
+    Tree pre = MakeTree(randomLengths(20, 20, 15));
+    for (u32 i = 0; i < 20; i++) {
+      w.write(pre.fLengths[i], 4);
+    }
+    for (u32 x = first; x < last;) {
+      u32 zeros = 0;
+      while (x + zeros < last && lengths[x + zeros] == 0) {
+        zeros++;
+      }
+      if (zeros >= 20 && uniform(0, 1) == 1) {
+        u32 y = (std::min)(zeros, 51u);
+        pre.write(w, 18);
+        w.write(y - 20, 5);
+        std::fill_n(prev.begin() + x, y, 0);
+        x += y;
+        continue;
+      }
+      if (zeros >= 4 && uniform(0, 1) == 1) {
+        u32 y = (std::min)(zeros, 19u);
+        pre.write(w, 17);
+        w.write(y - 4, 4);
+        std::fill_n(prev.begin() + x, y, 0);
+        x += y;
+        continue;
+      }
+      u32 same = 1;
+      while (x + same < last && same < 5 && lengths[x + same] == lengths[x]) {
+        same++;
+      }
+      if (same >= 4 && uniform(0, 1) == 1) {
+        pre.write(w, 19);
+        w.write(same - 4, 1);
+        pre.write(w, (prev[x] + 17 - lengths[x]) % 17);
+        std::fill_n(prev.begin() + x, same, lengths[x]);
+        x += same;
+        continue;
+      }
+      pre.write(w, (prev[x] + 17 - lengths[x]) % 17);
+      prev[x] = lengths[x];
+      x++;
+    }
+  }
+
+  void writeBlockHeader(BitWriter &w, bool aligned, u32 blockSize) {
+    using namespace std;
+    w.write(aligned ? 2 : 1, 3);
+    w.write(blockSize >> 8, 16);
+    w.write(0xff & blockSize, 8);
+    if (aligned) {
+      fAligned = MakeTree(randomLengths(8, uniform(1, 8), 7));
+      for (u32 i = 0; i < 8; i++) {
+        w.write(fAligned.fLengths[i], 3);
+      }
+    }
+    auto mainLengths = randomLengths(kMainElements, uniform(2, kMainElements), 16);
+    // always keep at least one literal so that every run can be filled
+    if (none_of(mainLengths.begin(), mainLengths.begin() + 256, [](u8 v) { return v > 0; })) {
+      for (u32 i = 256; i < kMainElements; i++) {
+        if (mainLengths[i] > 0) {
+          swap(mainLengths[i], mainLengths[uniform(0, 255)]);
+          break;
+        }
+      }
+    }
+    writeLengths(w, mainLengths, fPrevMain, 0, 256);
+    writeLengths(w, mainLengths, fPrevMain, 256, kMainElements);
+    fMain = MakeTree(mainLengths);
+
+    auto lengthLengths = randomLengths(249, uniform(1, 249), 16);
+    writeLengths(w, lengthLengths, fPrevLength, 0, 249);
+    fLength = MakeTree(lengthLengths);
+
+    fLiterals.clear();
+    fMatches.clear();
+    for (u32 sym : fMain.fSymbols) {
+      if (sym < 256) {
+        fLiterals.push_back(sym);
+      } else {
+        fMatches.push_back(sym);
+      }
+    }
+  }
+
+  void writeRun(BitWriter &w, bool aligned, u32 run, std::vector<u8> &out) {
+    while (run > 0) {
+      if (!fMatches.empty() && uniform(0, 1) == 1 && writeMatch(w, aligned, run, out)) {
+        continue;
+      }
+      u32 sym = fLiterals[uniform(0, (u32)fLiterals.size() - 1)];
+      fMain.write(w, sym);
+      out.push_back((u8)sym);
+      run--;
+    }
+  }
+
+  bool writeMatch(BitWriter &w, bool aligned, u32 &run, std::vector<u8> &out) {
+    u32 sym = fMatches[uniform(0, (u32)fMatches.size() - 1)];
+    u32 element = sym - 256;
+    u32 length = element & 7;
+    u32 footer = 0;
+    if (length == 7) {
+      footer = fLength.fSymbols[uniform(0, (u32)fLength.fSymbols.size() - 1)];
+      length += footer;
+    }
+    length += 2;
+    if (length > run) {
+      return false;
+    }
+    u32 slot = element >> 3;
+    u32 produced = (u32)(std::min)(out.size(), (size_t)kWindowSize - 1);
+    u32 offset;
+    if (slot <= 2) {
+      u32 r = slot == 0 ? fR0 : (slot == 1 ? fR1 : fR2);
+      if (r > produced) {
+        return false;
+      }
+      offset = r;
+      if (slot == 1) {
+        fR1 = fR0;
+        fR0 = offset;
+      } else if (slot == 2) {
+        fR2 = fR0;
+        fR0 = offset;
+      }
+      fMain.write(w, sym);
+      if ((element & 7) == 7) {
+        fLength.write(w, footer);
+      }
+    } else {
+      u32 extra = kExtraBits[slot];
+      u32 base = kPositionBase[slot] - 2;
+      if (base > produced) {
+        return false;
+      }
+      u32 range = (std::min)(u32(1) << extra, produced - base + 1);
+      u32 v = uniform(0, range - 1);
+      u32 alignedSym = 0;
+      if (aligned && extra >= 3) {
+        alignedSym = fAligned.fSymbols[uniform(0, (u32)fAligned.fSymbols.size() - 1)];
+        v = (v & ~7u) | alignedSym;
+        if (v >= range) {
+          return false;
+        }
+      }
+      offset = base + v;
+      fMain.write(w, sym);
+      if ((element & 7) == 7) {
+        fLength.write(w, footer);
+      }
+      if (aligned && extra > 3) {
+        w.write(v >> 3, extra - 3);
+        fAligned.write(w, alignedSym);
+      } else if (aligned && extra == 3) {
+        fAligned.write(w, alignedSym);
+      } else {
+        w.write(v, extra);
+      }
+      fR2 = fR1;
+      fR1 = fR0;
+      fR0 = offset;
+    }
+    for (u32 i = 0; i < length; i++) {
+      out.push_back(out[out.size() - offset]);
+    }
+    run -= length;
+    return true;
+  }
+
+private:
+  static constexpr u32 kWindowSize = 1 << 17;
+  static constexpr u32 kMainElements = 256 + 34 * 8;
+  static constexpr u8 kExtraBits[34] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15};
+  static constexpr u32 kPositionBase[34] = {0, 1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288, 16384, 24576, 32768, 49152, 65536, 98304};
+
+  std::mt19937 fRandom;
+  Tree fMain;
+  Tree fLength;
+  Tree fAligned;
+  std::vector<u32> fLiterals;
+  std::vector<u32> fMatches;
+  std::vector<u8> fPrevMain = std::vector<u8>(656, 0);
+  std::vector<u8> fPrevLength = std::vector<u8>(250, 0);
+  u32 fR0 = 1;
+  u32 fR1 = 1;
+  u32 fR2 = 1;
+};
+
+} // namespace
+
+TEST_CASE("lzx-decoder") {
+  SUBCASE("random-streams") {
+    for (u32 seed = 0; seed < 64; seed++) {
+      LzxTestEncoder encoder(seed);
+      vector<u8> expected;
+      size_t size = 1 + (seed * 7919) % (5 * 0x8000);
+      auto stream = encoder.encode(size, expected);
+      REQUIRE(expected.size() == size);
+
+      vector<u8> actual = stream;
+      CHECK(lce::detail::LzxDecoder::Decode(actual) == size);
+      CHECK(actual == expected);
+
+      vector<u8> reference;
+      reference.reserve(stream.size() + 16);
+      reference = stream;
+      CHECK(lce::detail::reference::LzxDecoder::Decode(reference) == size);
+      CHECK(reference == expected);
+    }
+  }
+  SUBCASE("incremental") {
+    LzxTestEncoder encoder(12345);
+    vector<u8> expected;
+    auto stream = encoder.encode(3 * 0x8000 + 100, expected);
+    vector<u8> actual;
+    int frames = 0;
+    auto decoded = lce::detail::LzxDecoder::Decode(stream, [&](span<u8 const> frame) {
+      frames++;
+      copy(frame.begin(), frame.end(), back_inserter(actual));
+      return true;
+    });
+    CHECK(decoded == expected.size());
+    CHECK(frames == 4);
+    CHECK(actual == expected);
+
+    auto cancelled = lce::detail::LzxDecoder::Decode(stream, [](span<u8 const>) { return false; });
+    CHECK(!cancelled);
+  }
+  SUBCASE("truncated") {
+    LzxTestEncoder encoder(54321);
+    vector<u8> expected;
+    auto stream = encoder.encode(2 * 0x8000, expected);
+    for (size_t cut : {(size_t)1, (size_t)4, stream.size() / 2, stream.size() - 1}) {
+      vector<u8> truncated(stream.begin(), stream.begin() + cut);
+      CHECK(lce::detail::LzxDecoder::Decode(truncated) == 0);
+    }
+  }
+  SUBCASE("savegames") {
+    // Compare against the reference implementation with real Xbox 360 savegames when they are available.
+    auto dir = ProjectRootDir() / "test" / "data" / "xbox360";
+    if (!fs::is_directory(dir)) {
+      return;
+    }
+    for (auto const &it : fs::directory_iterator(dir)) {
+      if (!it.is_regular_file() || it.path().extension() != ".bin") {
+        continue;
+      }
+      vector<u8> savegame;
+      REQUIRE(xbox360::SaveBin::ExtractSavagame(it.path(), savegame));
+      REQUIRE(savegame.size() > 12);
+      vector<u8> actual(savegame.begin() + 12, savegame.end());
+      vector<u8> reference;
+      reference.reserve(actual.size() + 16);
+      reference.assign(actual.begin(), actual.end());
+      auto size = lce::detail::LzxDecoder::Decode(actual);
+      CHECK(size > 0);
+      CHECK(size == lce::detail::reference::LzxDecoder::Decode(reference));
+      CHECK(actual == reference);
+    }
+  }
+}
+
+TEST_CASE("lzx-decoder-benchmark" * doctest::skip()) {
+  LzxTestEncoder encoder(1);
+  vector<u8> expected;
+  auto stream = encoder.encode(64 * 1024 * 1024, expected);
+
+  auto measure = [&](auto decode) {
+    vector<u8> buffer = stream;
+    auto start = chrono::high_resolution_clock::now();
+    size_t size = decode(buffer);
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+    CHECK(size == expected.size());
+    CHECK(buffer == expected);
+    return elapsed;
+  };
+  auto reference = measure([](vector<u8> &b) { return lce::detail::reference::LzxDecoder::Decode(b); });
+  auto current = measure([](vector<u8> &b) { return lce::detail::LzxDecoder::Decode(b); });
+  cout << "lzx-decoder-benchmark: reference=" << reference << "ms, current=" << current << "ms" << endl;
+}
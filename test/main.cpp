@@ -46,3 +46,22 @@ static fs::path ProjectRootDir() {
 #include "b2j2b.test.hpp"
 #include "bedrock-legacy-block.test.hpp"
 #include "parallel.test.hpp"
+#include "lzx-decoder.test.hpp"
+#include "lce-savegame.test.hpp"
+#include "terraform.test.hpp"
+#include "map-color.test.hpp"
+#include "zip-file.test.hpp"
+#include "zip-env.test.hpp"
+#include "mcworld-output.test.hpp"
+#include "palette-scan.test.hpp"
+#include "palette-index-packer.test.hpp"
+#include "block-state-cache.test.hpp"
+#include "chunk-biomes.test.hpp"
+#include "db-write-batch.test.hpp"
+#include "concurrent-db.test.hpp"
+#include "oriented-portal-blocks.test.hpp"
+#include "datapacks.test.hpp"
+#include "structure-piece-collection.test.hpp"
+#include "chunk-cache.test.hpp"
+#include "lce-block-populator.test.hpp"
+#include "lce-empty-region-writer.test.hpp"
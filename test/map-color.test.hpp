@@ -0,0 +1,139 @@
+#pragma once
+
+namespace {
+
+// Smallest Lab difference between `color` and any map color
+double MapColorMinDifference(Rgba color) {
+  Lab ref = Lab::From(color);
+  double ret = std::numeric_limits<double>::max();
+  for (int id = 0; id < 248; id++) {
+    Rgba c = MapColor::RgbaFromId((u8)id);
+    ret = (std::min)(ret, Lab::Difference(ref, Lab::From(c)));
+  }
+  return ret;
+}
+
+// Pixels of a Bedrock map: mostly map colors, with some off-palette colors shared across maps
+std::vector<Rgba> MapColorRandomPixels(std::mt19937 &rng, size_t count) {
+  std::vector<Rgba> ret;
+  ret.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    Rgba c = MapColor::RgbaFromId((u8)(4 + rng() % 244));
+    if (rng() % 2 == 0) {
+      c.fR = (u8)(c.fR ^ (rng() % 8));
+      c.fG = (u8)(c.fG ^ (rng() % 8));
+      c.fB = (u8)(c.fB ^ (rng() % 8));
+    }
+    ret.push_back(c);
+  }
+  return ret;
+}
+
+} // namespace
+
+TEST_CASE("map-color") {
+  CHECK(MapColor::MostSimilarColorId(Rgba(1, 2, 3, 0)) == 0);
+  for (int id = 4; id < 248; id++) {
+    Rgba c = MapColor::RgbaFromId((u8)id);
+    CHECK(MapColor::RgbaFromId(MapColor::MostSimilarColorId(c)).toARGB() == c.toARGB());
+  }
+  mt19937 rng(1);
+  for (int i = 0; i < 2048; i++) {
+    Rgba c((u8)(rng() % 256), (u8)(rng() % 256), (u8)(rng() % 256));
+    // First lookup fills the memo, the second one reads it
+    for (int j = 0; j < 2; j++) {
+      u8 id = MapColor::MostSimilarColorId(c);
+      CHECK(Lab::Difference(Lab::From(c), Lab::From(MapColor::RgbaFromId(id))) == MapColorMinDifference(c));
+    }
+  }
+}
+
+TEST_CASE("map-color-cache") {
+  mt19937 rng(1);
+  vector<u8> ids(16384);
+  for (auto &id : ids) {
+    id = (u8)(rng() % 256);
+  }
+  vector<u8> rgba(65536);
+  MapColor::RgbaFromIds(ids.data(), ids.size(), rgba.data());
+  for (size_t i = 0; i < ids.size(); i++) {
+    Rgba c = MapColor::RgbaFromId(ids[i]);
+    CHECK(rgba[i * 4] == c.fR);
+    CHECK(rgba[i * 4 + 1] == c.fG);
+    CHECK(rgba[i * 4 + 2] == c.fB);
+    CHECK(rgba[i * 4 + 3] == c.fA);
+  }
+
+  MapColorCache cache(1);
+  auto first = cache.rgbaFromIds(ids);
+  CHECK(*first == rgba);
+  auto second = cache.rgbaFromIds(vector<u8>(ids));
+  CHECK(first.get() == second.get());
+
+  // Over capacity: converted every time, with the same result
+  vector<Rgba> pixels = MapColorRandomPixels(rng, 16384);
+  vector<u8> bytes;
+  for (Rgba const &c : pixels) {
+    bytes.insert(bytes.end(), {c.fR, c.fG, c.fB, c.fA});
+  }
+  auto converted = cache.idsFromRgba(bytes);
+  REQUIRE(converted->size() == pixels.size());
+  for (size_t i = 0; i < pixels.size(); i++) {
+    CHECK((*converted)[i] == MapColor::MostSimilarColorId(pixels[i]));
+  }
+  CHECK(cache.idsFromRgba(bytes).get() != converted.get());
+  CHECK(*cache.idsFromRgba(bytes) == *converted);
+}
+
+TEST_CASE("map-color-benchmark" * doctest::skip()) {
+  mt19937 rng(1);
+  vector<vector<Rgba>> maps;
+  for (int i = 0; i < 16; i++) {
+    maps.push_back(MapColorRandomPixels(rng, 16384));
+  }
+  // Same search as MapColor::MostSimilarColorId without the memo
+  vector<Lab> labs;
+  for (int id = 0; id < 248; id++) {
+    labs.push_back(Lab::From(MapColor::RgbaFromId((u8)id)));
+  }
+  auto reference = [&labs](Rgba c) {
+    Lab ref = Lab::From(c);
+    u8 ret = 0;
+    double minDifference = numeric_limits<double>::max();
+    for (int id = 0; id < labs.size(); id++) {
+      double d = Lab::Difference(ref, labs[id]);
+      if (d < minDifference) {
+        minDifference = d;
+        ret = (u8)id;
+      }
+    }
+    return ret;
+  };
+
+  size_t sum = 0;
+  auto start = chrono::high_resolution_clock::now();
+  for (auto const &pixels : maps) {
+    for (Rgba const &c : pixels) {
+      sum += reference(c);
+    }
+  }
+  auto elapsedReference = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+  start = chrono::high_resolution_clock::now();
+  for (auto const &pixels : maps) {
+    for (Rgba const &c : pixels) {
+      sum += MapColor::MostSimilarColorId(c);
+    }
+  }
+  auto elapsedFirst = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+  start = chrono::high_resolution_clock::now();
+  for (auto const &pixels : maps) {
+    for (Rgba const &c : pixels) {
+      sum += MapColor::MostSimilarColorId(c);
+    }
+  }
+  auto elapsedSecond = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+  cout << "map-color-benchmark: " << maps.size() << " maps, Lab search=" << elapsedReference << "ms, MostSimilarColorId=" << elapsedFirst << "ms (first run), " << elapsedSecond << "ms (second run), " << sum << endl;
+}
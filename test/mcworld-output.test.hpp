@@ -0,0 +1,67 @@
+#pragma once
+
+namespace {
+
+size_t McworldOutputCountKeys(fs::path const &db) {
+  leveldb::DB *ptr = nullptr;
+  leveldb::Options o;
+  if (!leveldb::DB::Open(o, db, &ptr).ok()) {
+    return 0;
+  }
+  unique_ptr<leveldb::DB> d(ptr);
+  unique_ptr<leveldb::Iterator> itr(d->NewIterator({}));
+  size_t count = 0;
+  for (itr->SeekToFirst(); itr->Valid(); itr->Next()) {
+    count++;
+  }
+  return count;
+}
+
+} // namespace
+
+TEST_CASE("mcworld-output") {
+  fs::path thisFile(__FILE__);
+  auto original = thisFile.parent_path() / "data" / "shoulder-riders";
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+
+  je2be::java::Options optToBe;
+  optToBe.fDimensionFilter.insert(mcfile::Dimension::Overworld);
+  optToBe.fChunkFilter.insert(Pos2i(0, 0));
+
+  auto be = *tmp / "be";
+  REQUIRE(Fs::CreateDirectories(be));
+  CHECK(je2be::java::Converter::Run(original, be, optToBe, 1).ok());
+
+  auto mcworld = *tmp / "be.mcworld";
+  CHECK(je2be::java::Converter::RunToMcworld(original, mcworld, optToBe, 2).ok());
+
+  auto unzipped = *tmp / "unzipped";
+  REQUIRE(Fs::CreateDirectories(unzipped));
+  REQUIRE(ZipFile::Unzip(mcworld, unzipped).ok());
+  CHECK(Fs::Exists(unzipped / "level.dat"));
+  CHECK(Fs::Exists(unzipped / "db" / "CURRENT"));
+  auto numKeys = McworldOutputCountKeys(be / "db");
+  CHECK(numKeys > 0);
+  CHECK(McworldOutputCountKeys(unzipped / "db") == numKeys);
+
+  // The .mcworld file can be converted back directly
+  auto je = *tmp / "je";
+  REQUIRE(Fs::CreateDirectories(je));
+  je2be::bedrock::Options optToJe;
+  optToJe.fDimensionFilter.insert(mcfile::Dimension::Overworld);
+  optToJe.fChunkFilter.insert(Pos2i(0, 0));
+  CHECK(je2be::bedrock::Converter::Run(mcworld, je, optToJe, 1).ok());
+  auto stream = make_shared<mcfile::stream::GzFileInputStream>(je / "level.dat");
+  auto dat = CompoundTag::Read(stream, Encoding::Java);
+  REQUIRE(dat);
+  auto data = dat->compoundTag(u8"Data");
+  REQUIRE(data);
+  auto player = data->compoundTag(u8"Player");
+  REQUIRE(player);
+  CHECK(player->compoundTag(u8"ShoulderEntityLeft"));
+  CHECK(player->compoundTag(u8"ShoulderEntityRight"));
+}
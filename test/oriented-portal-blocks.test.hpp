@@ -0,0 +1,124 @@
+#pragma once
+
+namespace {
+
+using PortalTestRecord = std::tuple<i32, i32, i32, i32, i32, i32>;
+
+std::vector<PortalTestRecord> PortalTestRecords(std::vector<je2be::java::Portal> const &portals) {
+  std::vector<PortalTestRecord> ret;
+  for (auto const &p : portals) {
+    ret.push_back(std::make_tuple(p.fSpan, p.fTpX, p.fTpY, p.fTpZ, p.fXa, p.fZa));
+  }
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+// The record of a portal whose bottom row starts at `along` in `plane`
+PortalTestRecord PortalTestExpected(bool xAxis, int plane, int along, int y, int width) {
+  if (xAxis) {
+    return std::make_tuple(width, along, y, plane, 1, 0);
+  } else {
+    return std::make_tuple(width, plane, y, along, 0, 1);
+  }
+}
+
+// Adds a rectangle of portal blocks. `along` is the coordinate along the axis, and `plane` the other horizontal one
+void PortalTestAddRectangle(std::vector<Pos3i> &blocks, bool xAxis, int plane, int along, int y, int width, int height) {
+  for (int dy = 0; dy < height; dy++) {
+    for (int d = 0; d < width; d++) {
+      if (xAxis) {
+        blocks.push_back(Pos3i(along + d, y + dy, plane));
+      } else {
+        blocks.push_back(Pos3i(plane, y + dy, along + d));
+      }
+    }
+  }
+}
+
+std::vector<je2be::java::Portal> PortalTestExtract(std::vector<Pos3i> const &blocks, bool xAxis, int numDrains) {
+  using namespace je2be::java;
+  // Blocks are added to several instances like the WorldData of each chunk, then drained into one
+  std::vector<OrientedPortalBlocks> parts(numDrains, OrientedPortalBlocks(xAxis));
+  for (size_t i = 0; i < blocks.size(); i++) {
+    parts[i % numDrains].add(blocks[i].fX, blocks[i].fY, blocks[i].fZ);
+  }
+  OrientedPortalBlocks merged(xAxis);
+  for (auto &part : parts) {
+    part.drain(merged);
+  }
+  std::vector<Portal> ret;
+  merged.extract(ret, mcfile::Dimension::Nether);
+  return ret;
+}
+
+} // namespace
+
+TEST_CASE("oriented-portal-blocks") {
+  using namespace je2be::java;
+  for (bool xAxis : {true, false}) {
+    {
+      mt19937 rng(xAxis ? 1 : 2);
+      for (int trial = 0; trial < 100; trial++) {
+        // Rectangles separated by frames, in adjacent planes. Each of them is one portal
+        vector<Pos3i> blocks;
+        vector<PortalTestRecord> expected;
+        for (int plane = 0; plane < 3; plane++) {
+          for (int i = 0; i < 4; i++) {
+            int along = i * 6 - 12;
+            int y = (int)(rng() % 3) * 6;
+            int width = 1 + rng() % 5;
+            int height = 1 + rng() % 5;
+            PortalTestAddRectangle(blocks, xAxis, plane, along, y, width, height);
+            expected.push_back(PortalTestExpected(xAxis, plane, along, y, width));
+          }
+        }
+        sort(expected.begin(), expected.end());
+        shuffle(blocks.begin(), blocks.end(), rng);
+        CHECK(PortalTestRecords(PortalTestExtract(blocks, xAxis, 1)) == expected);
+        CHECK(PortalTestRecords(PortalTestExtract(blocks, xAxis, 7)) == expected);
+      }
+    }
+    {
+      // Sharing a frame row, and stacked without a frame between them
+      vector<Pos3i> blocks;
+      PortalTestAddRectangle(blocks, xAxis, 0, 0, 64, 2, 3);
+      PortalTestAddRectangle(blocks, xAxis, 0, 0, 68, 2, 3);
+      PortalTestAddRectangle(blocks, xAxis, 5, 0, 64, 2, 3);
+      PortalTestAddRectangle(blocks, xAxis, 5, 0, 67, 2, 3);
+      vector<PortalTestRecord> expected = {
+          PortalTestExpected(xAxis, 0, 0, 64, 2),
+          PortalTestExpected(xAxis, 0, 0, 68, 2),
+          PortalTestExpected(xAxis, 5, 0, 64, 2),
+      };
+      sort(expected.begin(), expected.end());
+      CHECK(PortalTestRecords(PortalTestExtract(blocks, xAxis, 3)) == expected);
+    }
+    {
+      // Sharing a frame column, touching each other, and in the neighbour plane
+      vector<Pos3i> blocks;
+      PortalTestAddRectangle(blocks, xAxis, 0, 0, 64, 2, 3);
+      PortalTestAddRectangle(blocks, xAxis, 0, 3, 64, 2, 3);
+      PortalTestAddRectangle(blocks, xAxis, 1, 0, 64, 2, 3);
+      PortalTestAddRectangle(blocks, xAxis, 1, 2, 64, 3, 3);
+      vector<PortalTestRecord> expected = {
+          PortalTestExpected(xAxis, 0, 0, 64, 2),
+          PortalTestExpected(xAxis, 0, 3, 64, 2),
+          PortalTestExpected(xAxis, 1, 0, 64, 5),
+      };
+      sort(expected.begin(), expected.end());
+      CHECK(PortalTestRecords(PortalTestExtract(blocks, xAxis, 3)) == expected);
+    }
+    {
+      // L-shaped blocks are split into the bottom row and the column above it
+      vector<Pos3i> blocks;
+      PortalTestAddRectangle(blocks, xAxis, 0, 0, 64, 4, 1);
+      PortalTestAddRectangle(blocks, xAxis, 0, 0, 65, 1, 3);
+      vector<PortalTestRecord> expected = {
+          PortalTestExpected(xAxis, 0, 0, 65, 1),
+          PortalTestExpected(xAxis, 0, 0, 64, 4),
+      };
+      sort(expected.begin(), expected.end());
+      CHECK(PortalTestRecords(PortalTestExtract(blocks, xAxis, 2)) == expected);
+    }
+  }
+}
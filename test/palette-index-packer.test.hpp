@@ -0,0 +1,109 @@
+#pragma once
+
+namespace {
+
+u32 PaletteIndexPackerWordAt(std::vector<u8> const &packed, size_t index) {
+  u8 const *p = packed.data() + index * 4;
+  return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+}
+
+// Packs `indices` with both Pack and PackScalar, and checks that they agree
+std::vector<u8> PaletteIndexPackerPack(std::vector<u16> const &indices, int bits) {
+  using namespace je2be::java;
+  std::vector<u8> packed(PaletteIndexPacker::PackedSize(bits));
+  CHECK(PaletteIndexPacker::Pack(indices.data(), bits, packed.data()));
+  std::vector<u8> scalar(PaletteIndexPacker::PackedSize(bits));
+  CHECK(PaletteIndexPacker::PackScalar(indices.data(), bits, scalar.data()));
+  CHECK(packed == scalar);
+  return packed;
+}
+
+} // namespace
+
+TEST_CASE("palette-index-packer") {
+  using namespace je2be::java;
+  CHECK(PaletteIndexPacker::PackedSize(1) == 512);
+  CHECK(PaletteIndexPacker::PackedSize(2) == 1024);
+  CHECK(PaletteIndexPacker::PackedSize(3) == 1640);
+  CHECK(PaletteIndexPacker::PackedSize(4) == 2048);
+  CHECK(PaletteIndexPacker::PackedSize(5) == 2732);
+  CHECK(PaletteIndexPacker::PackedSize(6) == 3280);
+  CHECK(PaletteIndexPacker::PackedSize(8) == 4096);
+  CHECK(PaletteIndexPacker::PackedSize(16) == 8192);
+
+  SUBCASE("widths without padding") {
+    // Ascending indices 0, 1, 2, ... wrapping at the width give the same bytes over and over
+    map<int, vector<u8>> const expected = {
+        {1, {0xaa}},
+        {2, {0xe4}},
+        {4, {0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe}},
+    };
+    for (auto const &[bits, pattern] : expected) {
+      vector<u16> indices(4096);
+      for (int i = 0; i < 4096; i++) {
+        indices[i] = (u16)(i % (1 << bits));
+      }
+      auto packed = PaletteIndexPackerPack(indices, bits);
+      for (size_t i = 0; i < packed.size(); i++) {
+        CHECK(packed[i] == pattern[i % pattern.size()]);
+      }
+    }
+    vector<u16> indices(4096);
+    for (int i = 0; i < 4096; i++) {
+      indices[i] = (u16)(i * 7);
+    }
+    auto packed8 = PaletteIndexPackerPack(indices, 8);
+    auto packed16 = PaletteIndexPackerPack(indices, 16);
+    for (int i = 0; i < 4096; i++) {
+      CHECK(packed8[i] == (u8)(i * 7));
+      CHECK(packed16[2 * i] == (u8)(i * 7));
+      CHECK(packed16[2 * i + 1] == (u8)((i * 7) >> 8));
+    }
+  }
+
+  SUBCASE("widths with padding") {
+    // 3, 5 and 6 bits fit 10, 6 and 5 indices in a word, leaving the top bits zero. The last word is partly filled
+    struct Fixture {
+      int fBits;
+      u32 fFirst;
+      u32 fSecond;
+      u32 fFull;
+      u32 fLast;
+    };
+    // fFirst and fSecond: the first two words for ascending indices. fFull and fLast: a full word and the last word when every
+    // index is 0b101, 0b10101 and 0b101010 respectively
+    for (auto const &f : {Fixture{3, 0x08fac688, 0x1a23eb1a, 0x2db6db6d, 0x2db6d},
+                          Fixture{5, 0x0a418820, 0x16a4a0e6, 0x2b5ad6b5, 0xad6b5},
+                          Fixture{6, 0x040c2040, 0x09207185, 0x2aaaaaaa, 0x2a}}) {
+      vector<u16> indices(4096);
+      for (int i = 0; i < 4096; i++) {
+        indices[i] = (u16)(i % (1 << f.fBits));
+      }
+      auto packed = PaletteIndexPackerPack(indices, f.fBits);
+      CHECK(PaletteIndexPackerWordAt(packed, 0) == f.fFirst);
+      CHECK(PaletteIndexPackerWordAt(packed, 1) == f.fSecond);
+
+      u16 const value = f.fBits == 3 ? 0b101 : f.fBits == 5 ? 0b10101 : 0b101010;
+      fill(indices.begin(), indices.end(), value);
+      packed = PaletteIndexPackerPack(indices, f.fBits);
+      size_t const words = packed.size() / 4;
+      for (size_t i = 0; i + 1 < words; i++) {
+        CHECK(PaletteIndexPackerWordAt(packed, i) == f.fFull);
+      }
+      CHECK(PaletteIndexPackerWordAt(packed, words - 1) == f.fLast);
+    }
+  }
+
+  SUBCASE("indices wider than the width are masked") {
+    vector<u16> indices(4096, 0xffff);
+    auto packed = PaletteIndexPackerPack(indices, 3);
+    CHECK(PaletteIndexPackerWordAt(packed, 0) == 0x3fffffff);
+    CHECK(PaletteIndexPackerWordAt(packed, packed.size() / 4 - 1) == 0x3ffff);
+    packed = PaletteIndexPackerPack(indices, 4);
+    CHECK(all_of(packed.begin(), packed.end(), [](u8 v) { return v == 0xff; }));
+  }
+
+  vector<u16> indices(4096);
+  vector<u8> out(PaletteIndexPacker::PackedSize(1));
+  CHECK(!PaletteIndexPacker::Pack(indices.data(), 7, out.data()));
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+TEST_CASE("palette-scan") {
+  using namespace je2be::java;
+  auto stone = mcfile::je::Block::FromName(u8"minecraft:stone", kJavaDataVersion);
+  auto piston = mcfile::je::Block::FromNameAndProperties(u8"minecraft:piston", kJavaDataVersion, map<u8string, u8string>{{u8"facing", u8"up"}});
+  auto sticky = mcfile::je::Block::FromName(u8"minecraft:sticky_piston", kJavaDataVersion);
+  auto isPiston = [](mcfile::je::Block const &b) {
+    return b.fName == u8"minecraft:piston" || b.fName == u8"minecraft:sticky_piston";
+  };
+  for (auto [cx, cz] : {pair<int, int>(0, 0), pair<int, int>(-3, 5)}) {
+    auto chunk = mcfile::je::WritableChunk::MakeEmpty(cx, -4, cz, kJavaDataVersion);
+    for (int y = -64; y < 64; y++) {
+      for (int z = cz * 16; z < cz * 16 + 16; z++) {
+        for (int x = cx * 16; x < cx * 16 + 16; x++) {
+          chunk->setBlockAt(x, y, z, stone);
+        }
+      }
+    }
+    CHECK(!PaletteScan::Contains(*chunk, isPiston));
+    CHECK(PaletteScan::Find(*chunk, isPiston).empty());
+
+    mt19937 rng(cx * 31 + cz);
+    for (int i = 0; i < 200; i++) {
+      int x = cx * 16 + rng() % 16;
+      int y = -64 + (int)(rng() % 200);
+      int z = cz * 16 + rng() % 16;
+      chunk->setBlockAt(x, y, z, i % 2 == 0 ? piston : sticky);
+    }
+    // Replaced afterwards, so that the palette has an entry no block refers to
+    chunk->setBlockAt(cx * 16, 100, cz * 16, piston);
+    chunk->setBlockAt(cx * 16, 100, cz * 16, stone);
+
+    vector<PaletteScan::Found> expected;
+    for (int y = chunk->minBlockY(); y <= chunk->maxBlockY(); y++) {
+      for (int z = cz * 16; z < cz * 16 + 16; z++) {
+        for (int x = cx * 16; x < cx * 16 + 16; x++) {
+          if (auto block = chunk->blockAt(x, y, z); block && isPiston(*block)) {
+            expected.push_back({Pos3i(x, y, z), block});
+          }
+        }
+      }
+    }
+    CHECK(PaletteScan::Contains(*chunk, isPiston));
+    auto actual = PaletteScan::Find(*chunk, isPiston);
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); i++) {
+      CHECK(actual[i].fPos == expected[i].fPos);
+      CHECK(actual[i].fBlock->fName == expected[i].fBlock->fName);
+      CHECK(actual[i].fBlock->property(u8"facing") == expected[i].fBlock->property(u8"facing"));
+    }
+  }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+namespace {
+
+// A StructureBounds value: the number of pieces, then x0, y0, z0, x1, y1, z1 and the type of each piece, in little endian
+std::string StructurePieceCollectionValue(std::initializer_list<std::tuple<i32, i32, i32, i32, i32, i32, u8>> pieces) {
+  std::string ret;
+  auto append = [&ret](u32 v) {
+    for (int i = 0; i < 4; i++) {
+      ret.push_back((char)(u8)(v >> (8 * i)));
+    }
+  };
+  append((u32)pieces.size());
+  for (auto const &[x0, y0, z0, x1, y1, z1, type] : pieces) {
+    for (i32 v : {x0, y0, z0, x1, y1, z1}) {
+      append((u32)v);
+    }
+    ret.push_back((char)type);
+  }
+  return ret;
+}
+
+} // namespace
+
+TEST_CASE("structure-piece-collection") {
+  using namespace je2be::java;
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+
+  auto const dim = mcfile::Dimension::Nether;
+
+  // Pieces found by 2 threads, merged in order
+  vector<StructurePieceCollection> collections(2);
+  // In chunk (0, 0)
+  collections[0].add(StructurePiece(Pos3i(0, 10, 0), Pos3i(15, 20, 15), StructureType::Fortress));
+  // Across chunks (0, -1), (1, -1), (0, 0) and (1, 0)
+  collections[0].add(StructurePiece(Pos3i(10, 0, -5), Pos3i(20, 5, 3), StructureType::Monument));
+  // In chunk (-1, -1)
+  collections[1].add(StructurePiece(Pos3i(-3, 70, -3), Pos3i(-1, 80, -1), StructureType::Outpost));
+  // In chunk (0, 0), after the pieces of the first collection
+  collections[1].add(StructurePiece(Pos3i(1, 1, 1), Pos3i(2, 2, 2), StructureType::Outpost));
+  // Clipped to -64 <= y <= 320
+  collections[1].add(StructurePiece(Pos3i(32, -80, 32), Pos3i(33, 330, 33), StructureType::Fortress));
+  StructurePieceCollection merged;
+  for (auto &collection : collections) {
+    collection.drain(merged);
+  }
+
+  auto dir = *tmp / "db";
+  {
+    Db db(dir);
+    REQUIRE(db.valid());
+    REQUIRE(merged.put(db, dim, 4).ok());
+    REQUIRE(db.close().ok());
+  }
+  map<string, string> actual;
+  {
+    leveldb::DB *ptr = nullptr;
+    leveldb::Options o;
+    o.compression = leveldb::kZlibRawCompression;
+    REQUIRE(leveldb::DB::Open(o, dir, &ptr).ok());
+    unique_ptr<leveldb::DB> db(ptr);
+    unique_ptr<leveldb::Iterator> itr(db->NewIterator({}));
+    for (itr->SeekToFirst(); itr->Valid(); itr->Next()) {
+      actual[itr->key().ToString()] = itr->value().ToString();
+    }
+  }
+  map<string, string> expected = {
+      {mcfile::be::DbKey::StructureBounds(0, 0, dim), StructurePieceCollectionValue({{0, 10, 0, 15, 20, 15, 1}, {10, 0, 0, 15, 5, 3, 3}, {1, 1, 1, 2, 2, 2, 5}})},
+      {mcfile::be::DbKey::StructureBounds(1, 0, dim), StructurePieceCollectionValue({{16, 0, 0, 20, 5, 3, 3}})},
+      {mcfile::be::DbKey::StructureBounds(0, -1, dim), StructurePieceCollectionValue({{10, 0, -5, 15, 5, -1, 3}})},
+      {mcfile::be::DbKey::StructureBounds(1, -1, dim), StructurePieceCollectionValue({{16, 0, -5, 20, 5, -1, 3}})},
+      {mcfile::be::DbKey::StructureBounds(-1, -1, dim), StructurePieceCollectionValue({{-3, 70, -3, -1, 80, -1, 5}})},
+      {mcfile::be::DbKey::StructureBounds(2, 2, dim), StructurePieceCollectionValue({{32, -64, 32, 33, 320, 33, 1}})},
+  };
+  CHECK(actual.size() == expected.size());
+  CHECK(actual == expected);
+
+  for (auto const &it : actual) {
+    vector<StructurePiece> parsed;
+    CHECK(StructurePiece::Parse(it.second, parsed));
+    string written;
+    StructurePiece::Write(parsed, written);
+    CHECK(written == it.second);
+  }
+}
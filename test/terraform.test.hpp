@@ -0,0 +1,201 @@
+#pragma once
+
+namespace {
+
+// Stone up to y = 63 and grass blocks at y = 64. The redstone-heavy variant has layers of redstone wire, note blocks, stairs,
+// fences and glass panes above the surface.
+std::shared_ptr<mcfile::je::WritableChunk> TerraformTestChunk(int cx, int cz, bool redstone) {
+  using namespace std;
+  auto chunk = mcfile::je::WritableChunk::MakeEmpty(cx, -4, cz, kJavaDataVersion);
+  auto stone = mcfile::je::Block::FromName(u8"minecraft:stone", kJavaDataVersion);
+  auto grass = mcfile::je::Block::FromName(u8"minecraft:grass_block", kJavaDataVersion);
+  vector<shared_ptr<mcfile::je::Block const>> machinery = {
+      mcfile::je::Block::FromName(u8"minecraft:redstone_wire", kJavaDataVersion),
+      mcfile::je::Block::FromName(u8"minecraft:repeater", kJavaDataVersion),
+      mcfile::je::Block::FromName(u8"minecraft:note_block", kJavaDataVersion),
+      mcfile::je::Block::FromName(u8"minecraft:redstone_wire", kJavaDataVersion),
+      mcfile::je::Block::FromName(u8"minecraft:oak_stairs", kJavaDataVersion),
+      mcfile::je::Block::FromName(u8"minecraft:oak_fence", kJavaDataVersion),
+      mcfile::je::Block::FromName(u8"minecraft:glass_pane", kJavaDataVersion),
+  };
+  for (int y = -64; y <= 64; y++) {
+    for (int z = cz * 16; z < cz * 16 + 16; z++) {
+      for (int x = cx * 16; x < cx * 16 + 16; x++) {
+        chunk->setBlockAt(x, y, z, y < 64 ? stone : grass);
+      }
+    }
+  }
+  if (redstone) {
+    for (int y = 65; y < 65 + 32; y += 2) {
+      for (int lz = 0; lz < 16; lz++) {
+        for (int lx = 0; lx < 16; lx++) {
+          chunk->setBlockAt(cx * 16 + lx, y, cz * 16 + lz, machinery[(lx + lz + y) % machinery.size()]);
+        }
+      }
+    }
+  }
+  return chunk;
+}
+
+// Positions found by looking up the property of every block, the way terraform passes used to.
+std::vector<terraform::BlockPropertyAccessor::Position> TerraformFullScan(terraform::BlockPropertyAccessor const &accessor, int cx, int cz, std::initializer_list<terraform::BlockPropertyAccessor::DataType> properties) {
+  std::vector<terraform::BlockPropertyAccessor::Position> ret;
+  for (int y = accessor.minBlockY(); y <= accessor.maxBlockY(); y++) {
+    for (int z = cz * 16; z < cz * 16 + 16; z++) {
+      for (int x = cx * 16; x < cx * 16 + 16; x++) {
+        auto p = accessor.property(x, y, z);
+        if (std::find(properties.begin(), properties.end(), p) != properties.end()) {
+          ret.push_back({x, y, z});
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+bool TerraformSamePositions(std::vector<terraform::BlockPropertyAccessor::Position> const &a, std::vector<terraform::BlockPropertyAccessor::Position> const &b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](auto const &l, auto const &r) {
+    return l.fX == r.fX && l.fY == r.fY && l.fZ == r.fZ;
+  });
+}
+
+} // namespace
+
+TEST_CASE("terraform-block-property-accessor") {
+  using P = terraform::BlockPropertyAccessor;
+  int const cx = -3;
+  int const cz = 5;
+  for (bool redstone : {false, true}) {
+    auto chunk = TerraformTestChunk(cx, cz, redstone);
+    terraform::BlockPropertyAccessorJava accessor(*chunk);
+    for (P::DataType p = 1; p <= P::DOUBLE_PLANT_UPPER_SUNFLOWER; p++) {
+      CHECK(TerraformSamePositions(accessor.positions({p}), TerraformFullScan(accessor, cx, cz, {p})));
+    }
+    CHECK(TerraformSamePositions(accessor.positions({P::FENCE, P::GLASS_PANE_OR_METAL_BARS}), TerraformFullScan(accessor, cx, cz, {P::FENCE, P::GLASS_PANE_OR_METAL_BARS})));
+    CHECK(accessor.positions({P::SNOWY}).size() == 256);
+    CHECK(accessor.positions({P::REDSTONE_WIRE}).empty() == !redstone);
+
+    // Grass blocks are at y = 64
+    auto count = [&accessor](int below, int above) {
+      int ret = 0;
+      accessor.forEach(P::SNOWY, below, above, [&ret](int x, int y, int z) {
+        CHECK(y == 64);
+        ret++;
+      });
+      return ret;
+    };
+    CHECK(count(0, 0) == 256);
+    CHECK(count(64 - accessor.minBlockY(), accessor.maxBlockY() - 64) == 256);
+    CHECK(count(64 - accessor.minBlockY() + 1, 0) == 0);
+    CHECK(count(0, accessor.maxBlockY() - 64 + 1) == 0);
+  }
+}
+
+TEST_CASE("terraform-block-property-accessor-bedrock") {
+  using P = terraform::BlockPropertyAccessor;
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+  REQUIRE(ZipFile::Unzip(ProjectRootDir() / "test" / "data" / "b2j-test.mcworld", *tmp).ok());
+  unique_ptr<leveldb::DB> db(OpenF(*tmp / "db"));
+  REQUIRE(db);
+
+  int numChunks = 0;
+  mcfile::be::Chunk::ForAll(db.get(), mcfile::Dimension::Overworld, [&](int cx, int cz) {
+    auto chunk = mcfile::be::Chunk::Load(cx, cz, mcfile::Dimension::Overworld, db.get(), mcfile::Encoding::LittleEndian);
+    if (!chunk) {
+      return true;
+    }
+    terraform::BlockPropertyAccessorBedrock accessor(*chunk);
+    for (P::DataType p = 1; p <= P::DOUBLE_PLANT_UPPER_SUNFLOWER; p++) {
+      CHECK(TerraformSamePositions(accessor.positions({p}), TerraformFullScan(accessor, cx, cz, {p})));
+    }
+    CHECK(TerraformSamePositions(accessor.positions({P::FENCE, P::GLASS_PANE_OR_METAL_BARS}), TerraformFullScan(accessor, cx, cz, {P::FENCE, P::GLASS_PANE_OR_METAL_BARS})));
+    numChunks++;
+    return numChunks < 64;
+  });
+  CHECK(numChunks > 0);
+}
+
+TEST_CASE("terraform-block-property-accessor-benchmark" * doctest::skip()) {
+  using P = terraform::BlockPropertyAccessor;
+  // Properties looked up by bedrock::Chunk::Impl::Terraform
+  std::initializer_list<P::DataType> const properties = {
+      P::PISTON,
+      P::STAIRS,
+      P::KELP,
+      P::TWISTING_VINES,
+      P::WEEPING_VINES,
+      P::PUMPKIN_STEM,
+      P::MELON_STEM,
+      P::CAVE_VINES,
+      P::SNOWY,
+      P::CHORUS_PLANT,
+      P::FENCE,
+      P::GLASS_PANE_OR_METAL_BARS,
+      P::CAMPFIRE,
+      P::NOTE_BLOCK,
+      P::REDSTONE_WIRE,
+      P::TRIPWIRE,
+      P::BEACON,
+      P::DOOR,
+      P::DOUBLE_PLANT_UPPER_SUNFLOWER,
+  };
+  int const iterations = 64;
+  for (bool redstone : {false, true}) {
+    auto chunk = TerraformTestChunk(0, 0, redstone);
+    terraform::BlockPropertyAccessorJava accessor(*chunk);
+
+    size_t expected = 0;
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      for (P::DataType p : properties) {
+        expected += TerraformFullScan(accessor, 0, 0, {p}).size();
+      }
+    }
+    auto fullScan = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+    size_t actual = 0;
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      for (P::DataType p : properties) {
+        actual += accessor.positions({p}).size();
+      }
+    }
+    auto dispatched = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+    CHECK(expected == actual);
+    cout << "terraform-block-property-accessor-benchmark: " << (redstone ? "redstone-heavy" : "plain terrain") << " chunk, full scan=" << fullScan << "ms, section dispatch=" << dispatched << "ms" << endl;
+  }
+}
+
+TEST_CASE("terraform-block-window") {
+  int const cx = -3;
+  int const cz = 5;
+  terraform::java::BlockAccessorJavaDirectory<3, 3> accessor(cx - 1, cz - 1, ProjectRootDir() / "test" / "data" / "terraform-block-window-nonexistent");
+  accessor.set(TerraformTestChunk(cx, cz, true));
+  accessor.set(TerraformTestChunk(cx + 1, cz, false));
+  accessor.set(TerraformTestChunk(cx - 1, cz + 1, true));
+
+  terraform::BlockWindow<mcfile::je::Block> window(cx - 1, cz - 1);
+  accessor.populate(window);
+
+  for (int y = -70; y < 330; y += 3) {
+    for (int z = (cz - 2) * 16; z < (cz + 3) * 16; z++) {
+      for (int x = (cx - 2) * 16; x < (cx + 3) * 16; x++) {
+        auto expected = accessor.blockAt(x, y, z);
+        auto actual = window.blockAt(x, y, z);
+        CHECK(expected.get() == actual);
+      }
+    }
+  }
+  auto section = window.sectionAt(cx, 4, cz);
+  REQUIRE(section);
+  auto expected = accessor.blockAt(cx * 16 + 3, 4 * 16 + 5, cz * 16 + 7);
+  CHECK(section->palette()[section->paletteIndexAt(3, 5, 7)] == expected.get());
+  REQUIRE(section->indices().size() == 4096);
+  CHECK(section->indices()[(5 * 16 + 7) * 16 + 3] == section->paletteIndexAt(3, 5, 7));
+  CHECK(window.sectionAt(cx + 2, 4, cz) == nullptr);
+}
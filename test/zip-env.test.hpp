@@ -0,0 +1,65 @@
+#pragma once
+
+TEST_CASE("zip-env") {
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+
+  // The world is placed in a subdirectory of the archive, as some archivers do
+  auto world = *tmp / "src" / "My World";
+  REQUIRE(Fs::CreateDirectories(world / "db"));
+  map<string, string> expected;
+  {
+    leveldb::DB *ptr = nullptr;
+    leveldb::Options o;
+    o.create_if_missing = true;
+    o.write_buffer_size = 256 * 1024;
+    REQUIRE(leveldb::DB::Open(o, world / "db", &ptr).ok());
+    unique_ptr<leveldb::DB> db(ptr);
+    mt19937 rng(1);
+    for (int i = 0; i < 20000; i++) {
+      string key = "key" + to_string(i);
+      string value(16 + rng() % 256, (char)('a' + i % 26));
+      REQUIRE(db->Put({}, key, value).ok());
+      expected[key] = value;
+    }
+  }
+  string const levelDat = "level.dat contents";
+  {
+    ofstream out(world / "level.dat", ios::binary);
+    out << levelDat;
+  }
+
+  // Serial zip deflates every entry, while the parallel one stores .ldb files
+  for (bool parallel : {false, true}) {
+    auto zip = *tmp / (parallel ? "parallel.mcworld" : "serial.mcworld");
+    if (parallel) {
+      REQUIRE(ZipFile::Zip(*tmp / "src", zip, 4).fStatus.ok());
+    } else {
+      REQUIRE(ZipFile::Zip(*tmp / "src", zip).fStatus.ok());
+    }
+    auto zipSize = Fs::FileSize(zip);
+    REQUIRE(zipSize);
+
+    auto mount = *tmp / (parallel ? "mount-parallel" : "mount-serial");
+    REQUIRE(Fs::CreateDirectories(mount));
+    auto archive = make_shared<ZipEnv>(zip, mount);
+    REQUIRE(archive->Valid());
+    CHECK(archive->contents(mount / "level.dat") == levelDat);
+    CHECK(!archive->contents(mount / "My World" / "level.dat"));
+
+    // Opened twice, like bedrock::Converter does
+    for (int i = 0; i < 2; i++) {
+      unique_ptr<ReadonlyDb> db;
+      REQUIRE(ReadonlyDb::Open(mount / "db", *tmp, db, archive).ok());
+      REQUIRE(db);
+      for (auto const &it : expected) {
+        CHECK(db->get(it.first) == it.second);
+      }
+      CHECK(!db->get("missing"));
+    }
+    CHECK(Fs::FileSize(zip) == zipSize);
+  }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+namespace {
+
+// Bytes compressing roughly like chunk data: long runs of a few values mixed with noise
+std::vector<u8> ZipFileRandomContents(std::mt19937 &rng, size_t size) {
+  std::vector<u8> ret;
+  ret.reserve(size);
+  while (ret.size() < size) {
+    if (rng() % 4 == 0) {
+      ret.push_back((u8)(rng() % 256));
+    } else {
+      ret.insert(ret.end(), (std::min)((size_t)(1 + rng() % 64), size - ret.size()), (u8)(rng() % 4));
+    }
+  }
+  return ret;
+}
+
+std::vector<u8> ZipFileReadAll(std::filesystem::path const &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<u8>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void ZipFileWriteAll(std::filesystem::path const &path, std::vector<u8> const &contents) {
+  Fs::CreateDirectories(path.parent_path());
+  std::ofstream out(path, std::ios::binary);
+  out.write((char const *)contents.data(), contents.size());
+}
+
+} // namespace
+
+TEST_CASE("zip-file") {
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+  auto in = *tmp / "in";
+  mt19937 rng(1);
+  map<fs::path, vector<u8>> files;
+  files[fs::path("level.dat")] = ZipFileRandomContents(rng, 3000);
+  files[fs::path("levelname.txt")] = {};
+  files[fs::path("db") / "CURRENT"] = {'M', 'A', 'N', 'I', 'F', 'E', 'S', 'T', '-', '0', '0', '0', '0', '0', '1', '\n'};
+  files[fs::path("db") / "000005.ldb"] = ZipFileRandomContents(rng, 2 * 1024 * 1024 + 100);
+  // Split into several blocks, with the last one shorter than the others
+  files[fs::path("behavior_packs") / "a" / "large.bin"] = ZipFileRandomContents(rng, 3 * 1024 * 1024 + 12345);
+  files[fs::path("behavior_packs") / "a" / "block.bin"] = ZipFileRandomContents(rng, 1024 * 1024);
+  for (auto const &it : files) {
+    ZipFileWriteAll(in / it.first, it.second);
+  }
+
+  for (unsigned int concurrency : {1u, 4u}) {
+    auto zip = *tmp / ("out-" + to_string(concurrency) + ".zip");
+    int reported = 0;
+    auto result = ZipFile::Zip(in, zip, concurrency, [&reported](int done, int total) {
+      CHECK(done == reported);
+      CHECK(total == 6);
+      reported++;
+      return true;
+    });
+    CHECK(result.fStatus.ok());
+    CHECK(!result.fZip64Used);
+    CHECK(reported == 7);
+
+    auto out = *tmp / ("unzip-" + to_string(concurrency));
+    REQUIRE(Fs::CreateDirectories(out));
+    REQUIRE(ZipFile::Unzip(zip, out).ok());
+    for (auto const &it : files) {
+      CHECK(ZipFileReadAll(out / it.first) == it.second);
+    }
+  }
+}
+
+TEST_CASE("zip-file-benchmark" * doctest::skip()) {
+  auto tmp = mcfile::File::CreateTempDir(fs::temp_directory_path());
+  REQUIRE(tmp);
+  defer {
+    Fs::DeleteAll(*tmp);
+  };
+  auto in = *tmp / "in";
+  mt19937 rng(1);
+  // Shaped like a converted world: leveldb tables around 2 MiB, plus a few larger files
+  for (int i = 0; i < 96; i++) {
+    ZipFileWriteAll(in / "db" / (to_string(100000 + i) + ".ldb"), ZipFileRandomContents(rng, 2 * 1024 * 1024));
+  }
+  for (int i = 0; i < 8; i++) {
+    ZipFileWriteAll(in / "data" / (to_string(i) + ".bin"), ZipFileRandomContents(rng, 16 * 1024 * 1024));
+  }
+
+  auto measure = [&](string const &name, function<ZipFile::ZipResult(fs::path const &)> zip) {
+    auto file = *tmp / (name + ".zip");
+    auto start = chrono::high_resolution_clock::now();
+    auto result = zip(file);
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+    CHECK(result.fStatus.ok());
+    cout << "zip-file-benchmark: " << name << "=" << elapsed << "ms, " << *Fs::FileSize(file) << " bytes" << endl;
+  };
+  measure("serial", [&](fs::path const &file) {
+    return ZipFile::Zip(in, file);
+  });
+  measure("parallel", [&](fs::path const &file) {
+    return ZipFile::Zip(in, file, thread::hardware_concurrency());
+  });
+}